@@ -5,6 +5,24 @@
 
 #include "Owl/SLOwlDoc.h"
 
+// Forward declaration
+class USLBaseIndividual;
+
+/**
+* Type specific values of the events, kept as typed columns in the journal and the event store
+*/
+struct FSLEventTypedValues
+{
+	// Pair id of the event (0 if the type has none)
+	uint64 PairId = 0;
+
+	// Grasp type or container action type (empty if the type has none)
+	FString SubType;
+
+	// Task success of the slicing events (-1 if the type has none)
+	int8 TaskSuccess = -1;
+};
+
 /**
 * Abstract class ensuring every event can be represented as an Owl Node;
 */
@@ -57,4 +75,10 @@ public:
 
 	// Type name
 	virtual FString TypeName() const = 0;
+
+	// Get the individuals taking part in the event
+	virtual void GetParticipants(TArray<USLBaseIndividual*>& OutParticipants) const {};
+
+	// Get the type specific values of the event
+	virtual void GetTypedValues(FSLEventTypedValues& OutValues) const {};
 };
\ No newline at end of file
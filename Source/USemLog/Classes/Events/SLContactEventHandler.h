@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Events/ISLEventHandler.h"
+#include "Events/SLPendingEventTable.h"
 
 // Forward declarations
 class USLBaseIndividual;
@@ -26,6 +27,9 @@ public:
 	// Terminate listener, finish and publish remaining events
 	void Finish(float EndTime, bool bForced = false) override;
 
+	// Log the timings of the pending events lookups with the given number of simultaneous contacts (previous linear scan vs keyed table)
+	static void BenchmarkPendingEvents(int32 NumContacts = 5000);
+
 private:
 	// Start new contact event
 	void AddNewContactEvent(const FSLContactResult& InResult);
@@ -58,11 +62,11 @@ private:
 	// Parent semantic overlap area
 	class ISLContactMonitorInterface* Parent = nullptr;
 
-	// Array of started contact events
-	TArray<TSharedPtr<FSLContactEvent>> StartedContactEvents;
+	// Started contact events indexed by the other individual
+	TSLPendingEventTable<USLBaseIndividual*, TSharedPtr<FSLContactEvent>> StartedContactEvents;
 
-	// Array of started supported by events
-	TArray<TSharedPtr<FSLSupportedByEvent>> StartedSupportedByEvents;
+	// Started supported by events indexed by their pair id
+	TSLPendingEventTable<uint64, TSharedPtr<FSLSupportedByEvent>> StartedSupportedByEvents;
 	
 	/* Constant values */
 	constexpr static float ContactEventMin = 0.3f;
@@ -0,0 +1,169 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLLoggerStructs.h"
+#include "Owl/SLOwlWriter.h"
+#include "Events/ISLEvent.h"
+
+// Forward declarations
+class IFileHandle;
+class FArchive;
+
+/**
+ * Flattened finished event, everything the exporters need without the live event and its individuals
+ */
+struct FSLEventJournalRecord
+{
+	// Unique id of the event
+	FString Id;
+
+	// Type name of the event (used for the events selection)
+	FString TypeName;
+
+	// Start time of the event
+	float StartTime = 0.f;
+
+	// End time of the event
+	float EndTime = 0.f;
+
+	// Timeline context of the event
+	FString Context;
+
+	// Timeline tooltip of the event
+	FString Tooltip;
+
+	// Individual ids of the event participants
+	TArray<FString> ParticipantIds;
+
+	// Type specific values of the event
+	FSLEventTypedValues TypedValues;
+
+	// Owl individual of the event, serialized at the depth of the document individuals
+	FString OwlNode;
+};
+
+/**
+ * Append-only journal of the finished symbolic events:
+ * [header][records: size, start, end, id, type, context, tooltip, participant ids, pair id, sub type, task success, owl node],
+ * every record is complete on its own, a journal cut by a crash is readable up to its last full record
+ */
+class USEMLOG_API FSLEventJournal
+{
+public:
+	// Ctor
+	FSLEventJournal();
+
+	// Dtor
+	~FSLEventJournal();
+
+	// Create the journal file
+	bool Open(const FString& InFilePath, bool bOverwrite);
+
+	// Serialize the finished event and append it to the journal
+	void Append(const ISLEvent& Event);
+
+	// Write the buffered records to disk if they are too many or too old
+	void Flush(bool bForce);
+
+	// Write the remaining records and close the file
+	void Close();
+
+	// True if the file is open
+	bool IsOpen() const { return FileHandle != nullptr; };
+
+	// Path of the journal file
+	const FString& GetFilePath() const { return FilePath; };
+
+	// Number of appended events
+	int32 NumEvents() const { return NumRecords; };
+
+	// Default journal file path of the task and episode
+	static FString GetJournalFilePath(const FString& TaskId, const FString& EpisodeId);
+
+private:
+	// Write the buffered bytes to disk
+	bool WriteOut();
+
+private:
+	// Path of the journal file
+	FString FilePath;
+
+	// Open file handle
+	IFileHandle* FileHandle;
+
+	// True if a write failed, the journal is closed and incomplete
+	bool bWriteFailed;
+
+	// Bytes waiting to be written to disk
+	TArray<uint8> WriteBuffer;
+
+	// Bytes already written to disk
+	uint64 NumWrittenBytes;
+
+	// Number of appended records
+	int32 NumRecords;
+
+	// Time of the last write to disk
+	double LastWriteTime;
+
+	// Serializes the owl individuals of the events (reused buffer)
+	FSLOwlWriter OwlWriter;
+
+	// Participants of the appended event (reused buffer)
+	TArray<USLBaseIndividual*> ParticipantsBuffer;
+};
+
+/**
+ * Sequential reader of the event journals, holds a single record in memory
+ */
+class USEMLOG_API FSLEventJournalReader
+{
+public:
+	// Ctor
+	FSLEventJournalReader();
+
+	// Dtor
+	~FSLEventJournalReader();
+
+	// Open the file and check its header
+	bool Open(const FString& InFilePath);
+
+	// Close the file
+	void Close();
+
+	// Go back to the first record
+	bool Rewind();
+
+	// Read the next record (false at the end of the journal or at a cut record)
+	bool Next(FSLEventJournalRecord& OutRecord);
+
+	// True if the reading stopped at an incomplete record
+	bool IsTruncated() const { return bTruncated; };
+
+	// Path of the journal file
+	const FString& GetFilePath() const { return FilePath; };
+
+	// Write the journal records as documents of the episode events collection (bulk inserts)
+	static bool ImportToMongo(const FString& InFilePath,
+		const FSLLoggerLocationParams& InLocationParameters,
+		const FSLLoggerDBServerParams& InDBServerParameters);
+
+private:
+	// Path of the journal file
+	FString FilePath;
+
+	// Buffered file reader
+	FArchive* Reader;
+
+	// Offset of the first record
+	int64 RecordsOffset;
+
+	// Bytes of the current record
+	TArray<uint8> RecordBuffer;
+
+	// Set if the last record is incomplete
+	bool bTruncated;
+};
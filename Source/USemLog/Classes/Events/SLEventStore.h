@@ -0,0 +1,202 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+class FSLEventJournalReader;
+struct FSLEventJournalRecord;
+class FArchive;
+
+/**
+ * Interned strings (type names, individual ids, contexts), every unique string is stored once
+ */
+struct USEMLOG_API FSLEventStoreNames
+{
+	// Index of the string, added if new
+	int32 Intern(const FString& Name);
+
+	// Index of the string, INDEX_NONE if not stored
+	int32 Find(const FString& Name) const;
+
+	// String at the index
+	const FString& Get(int32 Idx) const { return Names[Idx]; };
+
+	// Number of unique strings
+	int32 Num() const { return Names.Num(); };
+
+	// True if the index points to a stored string
+	bool IsValidIndex(int32 Idx) const { return Names.IsValidIndex(Idx); };
+
+	// Remove all the strings
+	void Empty();
+
+	// Serialize the strings (the lookup is rebuilt when loading)
+	void Serialize(FArchive& Ar);
+
+private:
+	// Unique strings
+	TArray<FString> Names;
+
+	// String to index lookup
+	TMap<FString, int32> Indices;
+};
+
+/**
+ * Typed columnar store of the finished events (type, participants, start/end, context, tooltip,
+ * and the type specific pair id, grasp/container type and slicing success),
+ * with a time interval index and a participant index for the time range and participant queries,
+ * the store is filled from the event journal or from its binary file, the indexes are built at once,
+ * the queries never modify the store and can run concurrently
+ */
+class USEMLOG_API FSLEventStore
+{
+public:
+	// Ctor
+	FSLEventStore();
+
+	// Fill the columns with the records of the journal and build the indexes, replaces the current events
+	bool BuildFromJournal(FSLEventJournalReader& Journal);
+
+	// Remove all the events
+	void Empty();
+
+	// Number of stored events
+	int32 Num() const { return Ids.Num(); };
+
+	/* Queries */
+	// Indices of the events overlapping the [StartTime, EndTime] range sorted by start time,
+	// optionally only the ones of the given type and/or with the given participant (individual id)
+	void Query(float InStartTime, float InEndTime, TArray<int32>& OutEventIdxs,
+		const FString& InTypeName = FString(), const FString& InParticipantId = FString()) const;
+
+	// Indices of the events of the participant (individual id) sorted by start time
+	void QueryParticipant(const FString& InParticipantId, TArray<int32>& OutEventIdxs) const;
+
+	/* Columns access */
+	// Unique id of the event
+	const FString& GetId(int32 EventIdx) const { return Ids[EventIdx]; };
+
+	// Type name of the event
+	const FString& GetTypeName(int32 EventIdx) const { return TypeNames.Get(TypeIdxs[EventIdx]); };
+
+	// Start time of the event
+	float GetStartTime(int32 EventIdx) const { return StartTimes[EventIdx]; };
+
+	// End time of the event
+	float GetEndTime(int32 EventIdx) const { return EndTimes[EventIdx]; };
+
+	// Individual ids of the event participants
+	void GetParticipantIds(int32 EventIdx, TArray<FString>& OutIds) const;
+
+	// Timeline context of the event
+	const FString& GetContext(int32 EventIdx) const { return Contexts.Get(ContextIdxs[EventIdx]); };
+
+	// Timeline tooltip of the event
+	const FString& GetTooltip(int32 EventIdx) const { return Tooltips[EventIdx]; };
+
+	// Pair id of the event (0 if the type has none)
+	uint64 GetPairId(int32 EventIdx) const { return PairIds[EventIdx]; };
+
+	// Grasp type or container action type of the event (empty if the type has none)
+	const FString& GetSubType(int32 EventIdx) const { return SubTypes.Get(SubTypeIdxs[EventIdx]); };
+
+	// Task success of the slicing events (-1 if the type has none)
+	int8 GetTaskSuccess(int32 EventIdx) const { return TaskSuccesses[EventIdx]; };
+
+	/* IO */
+	// Write the columns to the binary file
+	bool SaveToFile(const FString& InFilePath, bool bOverwrite);
+
+	// Load the columns from the binary file, replaces the current events
+	bool LoadFromFile(const FString& InFilePath);
+
+	// Default store file path of the task and episode
+	static FString GetStoreFilePath(const FString& TaskId, const FString& EpisodeId);
+
+private:
+	// Append the journal record to the columns (the indexes are built after all the records are added)
+	void AddRecord(const FSLEventJournalRecord& Record);
+
+	// Serialize the dictionaries and the columns (the indexes are not stored)
+	void SerializeColumns(FArchive& Ar);
+
+	// Build the participant postings from the participant columns (false if the columns are inconsistent)
+	bool BuildParticipantIndex();
+
+	// Sort the events by start time and compute the subtree max end times (implicit interval tree)
+	void BuildTimeIndex();
+
+	// Collect the events of the implicit interval tree node range overlapping [InStartTime, InEndTime]
+	void QueryTimeIndex(int32 Lo, int32 Hi, float InStartTime, float InEndTime, int32 TypeIdx, TArray<int32>& OutEventIdxs) const;
+
+	// Compute the max end time of the node range, returns it
+	float BuildMaxEnd(int32 Lo, int32 Hi);
+
+	// True if the event overlaps the time range and is of the type (INDEX_NONE for any)
+	bool Matches(int32 EventIdx, float InStartTime, float InEndTime, int32 TypeIdx) const
+	{
+		return StartTimes[EventIdx] <= InEndTime && EndTimes[EventIdx] >= InStartTime
+			&& (TypeIdx == INDEX_NONE || TypeIdxs[EventIdx] == TypeIdx);
+	}
+
+private:
+	/* Dictionaries */
+	// Type names of the events
+	FSLEventStoreNames TypeNames;
+
+	// Ids of the participant individuals
+	FSLEventStoreNames IndividualIds;
+
+	// Timeline contexts (repeat between the events of the same participants)
+	FSLEventStoreNames Contexts;
+
+	// Grasp and container action types
+	FSLEventStoreNames SubTypes;
+
+	/* Columns (one entry per event, in the order the events finished) */
+	// Unique ids
+	TArray<FString> Ids;
+
+	// Type name indices
+	TArray<int32> TypeIdxs;
+
+	// Start times
+	TArray<float> StartTimes;
+
+	// End times
+	TArray<float> EndTimes;
+
+	// Offsets of the event participants in the participants column (one extra entry at the end)
+	TArray<int32> ParticipantOffsets;
+
+	// Participant individual id indices of all the events
+	TArray<int32> ParticipantIdxs;
+
+	// Context indices
+	TArray<int32> ContextIdxs;
+
+	// Tooltips
+	TArray<FString> Tooltips;
+
+	// Pair ids
+	TArray<uint64> PairIds;
+
+	// Sub type indices
+	TArray<int32> SubTypeIdxs;
+
+	// Task successes
+	TArray<int8> TaskSuccesses;
+
+	/* Indexes (built when the store is filled) */
+	// Events of every participant (indexed by the individual id index)
+	TArray<TArray<int32>> ParticipantEvents;
+
+	// Event indices sorted by start time, the implicit interval tree nodes
+	TArray<int32> SortedEventIdxs;
+
+	// Max end time of every implicit interval tree node range
+	TArray<float> SortedMaxEnds;
+};
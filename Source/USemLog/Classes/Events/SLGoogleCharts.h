@@ -5,6 +5,8 @@
 
 #include "CoreMinimal.h"
 #include "Events/SLEvents.h"
+#include "Events/SLEventStore.h"
+#include "HAL/FileManager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 
@@ -63,6 +65,70 @@ struct FSLGoogleCharts
 			return false;
 		}
 
+		FString TimelineStr = GetTimelineBegin(Params);
+
+		// Add event times
+		for (const auto& Ev : InEvents)
+		{
+			if (!Ev.IsValid() || !ShouldEventBeWritten(Ev->TypeName(), Params.EventsSelection))
+			{
+				continue;
+			}
+			AddEventRow(TimelineStr, Ev->Context(), Ev->Id, Ev->StartTime, Ev->EndTime, Ev->Tooltip(), Params.bTooltips);
+		}
+
+		TimelineStr.Append(GetTimelineEnd(Params));
+
+		// Write map to file
+		return FFileHelper::SaveStringToFile(TimelineStr, *FullFilePath);
+	}
+
+	// Write google charts timeline html page from the columns of the event store, the rows are streamed to the file
+	static bool WriteTimelines(const FSLEventStore& Store,
+		const FString& DirectoryPath,
+		const FString& InEpId,
+		const FSLGoogleChartsParameters& Params = FSLGoogleChartsParameters())
+	{
+		FString FullFilePath = DirectoryPath + "/" + InEpId + TEXT("_TL.html");
+		FPaths::RemoveDuplicateSlashes(FullFilePath);
+
+		if (FPaths::FileExists(FullFilePath) && !Params.bOverwrite)
+		{
+			return false;
+		}
+
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FullFilePath));
+		if (!Writer.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__FUNCTION__), __LINE__, *FullFilePath);
+			return false;
+		}
+
+		// The rows are written out in chunks
+		FString TimelineStr = GetTimelineBegin(Params);
+		for (int32 EvIdx = 0; EvIdx < Store.Num(); ++EvIdx)
+		{
+			if (!ShouldEventBeWritten(Store.GetTypeName(EvIdx), Params.EventsSelection))
+			{
+				continue;
+			}
+			AddEventRow(TimelineStr, Store.GetContext(EvIdx), Store.GetId(EvIdx), Store.GetStartTime(EvIdx),
+				Store.GetEndTime(EvIdx), Store.GetTooltip(EvIdx), Params.bTooltips);
+			if (TimelineStr.Len() >= 64 * 1024)
+			{
+				WriteUTF8(*Writer, TimelineStr);
+			}
+		}
+
+		TimelineStr.Append(GetTimelineEnd(Params));
+		WriteUTF8(*Writer, TimelineStr);
+		return Writer->Close();
+	}
+
+private:
+	// Timeline boilerplate up to the event rows (with the episode duration row)
+	static FString GetTimelineBegin(const FSLGoogleChartsParameters& Params)
+	{
 		// Timeline boilerplate 
 		FString TimelineStr =
 			"<script type=\"text/javascript\" src=\"https://www.gstatic.com/charts/loader.js\"></script>\n"
@@ -95,11 +161,9 @@ struct FSLGoogleCharts
 		// Add episode duration
 		if (Params.StartTime >= 0 && Params.EndTime > 0)
 		{
-			const FString StartStr = FString::Printf(TEXT("%.3f"), Params.StartTime); 
-			const FString EndStr = FString::Printf(TEXT("%.3f"), Params.EndTime); 
-			const FString StartMsStr = FString::Printf(TEXT("%.3f"), Params.StartTime * 1000.f); //FString::SanitizeFloat(Ev->Start * 1000.f);
-			const FString EndMsStr = FString::Printf(TEXT("%.3f"), Params.EndTime * 1000.f);  //FString::SanitizeFloat(Ev->End * 1000.f);
-			
+			const FString StartMsStr = FString::Printf(TEXT("%.3f"), Params.StartTime * 1000.f);
+			const FString EndMsStr = FString::Printf(TEXT("%.3f"), Params.EndTime * 1000.f);
+
 			TimelineStr.Append("\t\t [ \'" + Params.TaskId + "\' , \'" + Params.EpisodeId + "\' , ");
 			if (Params.bTooltips)
 			{
@@ -107,33 +171,34 @@ struct FSLGoogleCharts
 			}
 			TimelineStr.Append(StartMsStr + " , " + EndMsStr + " ],\n");  // google charts needs millisecods
 		}
+		return TimelineStr;
+	}
 
-		// Add event times
-		for (const auto& Ev : InEvents)
-		{
-			if (!ShouldEventBeWritten(Ev, Params.EventsSelection))
-			{
-				continue;
-			}
-
-			const FString StartStr = FString::Printf(TEXT("%.3f"), Ev->StartTime); //FString::SanitizeFloat(Ev->Start);
-			const FString EndStr = FString::Printf(TEXT("%.3f"), Ev->EndTime); //FString::SanitizeFloat(Ev->End);
-			const FString StartMsStr = FString::Printf(TEXT("%.3f"), Ev->StartTime * 1000.f); //FString::SanitizeFloat(Ev->Start * 1000.f);
-			const FString EndMsStr = FString::Printf(TEXT("%.3f"), Ev->EndTime * 1000.f);  //FString::SanitizeFloat(Ev->End * 1000.f);
+	// Add the row of an event
+	static void AddEventRow(FString& OutTimelineStr, const FString& Context, const FString& Id,
+		float StartTime, float EndTime, const FString& Tooltip, bool bTooltips)
+	{
+		const FString StartStr = FString::Printf(TEXT("%.3f"), StartTime);
+		const FString EndStr = FString::Printf(TEXT("%.3f"), EndTime);
+		const FString StartMsStr = FString::Printf(TEXT("%.3f"), StartTime * 1000.f);
+		const FString EndMsStr = FString::Printf(TEXT("%.3f"), EndTime * 1000.f);
 
-			TimelineStr.Append("\t\t [ \'" + Ev->Context() + "\' , \'" + Ev->Id + "\' , " );
-			if (Params.bTooltips)
-			{
-				TimelineStr.Append(
-					"createTooltipHTMLContent("
-					+ StartStr + ", "
-					+ EndStr + ", "
-					+ Ev->Tooltip() + "), " );
-			}
-			TimelineStr.Append(StartMsStr + " , " + EndMsStr + " ],\n");  // google charts needs millisecods
+		OutTimelineStr.Append("\t\t [ \'" + Context + "\' , \'" + Id + "\' , ");
+		if (bTooltips)
+		{
+			OutTimelineStr.Append(
+				"createTooltipHTMLContent("
+				+ StartStr + ", "
+				+ EndStr + ", "
+				+ Tooltip + "), ");
 		}
+		OutTimelineStr.Append(StartMsStr + " , " + EndMsStr + " ],\n");  // google charts needs millisecods
+	}
 
-		TimelineStr.Append(
+	// Timeline boilerplate after the event rows
+	static FString GetTimelineEnd(const FSLGoogleChartsParameters& Params)
+	{
+		FString TimelineStr =
 			"\n"
 			"\t\t]);\n"
 			"\n"
@@ -143,7 +208,7 @@ struct FSLGoogleCharts
 			"\t\t\t tooltip: {isHtml: true}\n"
 			"\t\t };\n"
 			"\t\t chart.draw(dataTable, options);\n"
-			"\t }\n");
+			"\t }\n";
 
 		if (Params.bTooltips)
 		{
@@ -178,17 +243,21 @@ struct FSLGoogleCharts
 
 		if (Params.bLegend)
 		{
-			TimelineStr.Append(FSLGoogleCharts::GetLengend(InEvents));
+			TimelineStr.Append(GetLengend());
 		}
-
-		// Write map to file
-		return FFileHelper::SaveStringToFile(TimelineStr, *FullFilePath);
+		return TimelineStr;
 	}
 
-private:
+	// Write the string as UTF-8 and empty it
+	static void WriteUTF8(FArchive& Writer, FString& InOutStr)
+	{
+		FTCHARToUTF8 Conv(*InOutStr);
+		Writer.Serialize(const_cast<ANSICHAR*>(Conv.Get()), Conv.Length());
+		InOutStr.Reset();
+	}
 
 	// Table showing the legend of the symbols
-	static FString GetLengend(const TArray<TSharedPtr<ISLEvent>>& InEvents)
+	static FString GetLengend()
 	{
 		FString Legend =
 			"\n"
@@ -196,51 +265,47 @@ private:
 		return Legend;
 	}
 
-	// Should the event be written
-	static bool ShouldEventBeWritten(TSharedPtr<ISLEvent> Event, const FLSymbolicEventsSelection& EventSelection)
+	// Should the event with the given type name be written
+	static bool ShouldEventBeWritten(const FString& TypeName, const FLSymbolicEventsSelection& EventSelection)
 	{
-		if (!Event.IsValid())
-		{
-			return false;
-		}
 		if (EventSelection.bSelectAll)
 		{
 			return true;
 		}
 		/* Contact */
-		else if (Event.Get()->TypeName().StartsWith("Contact"))
+		else if (TypeName.StartsWith("Contact"))
 		{
 			return EventSelection.bContact || EventSelection.bManipulatorContact;
 		}
 		/* SupportedBy */
-		else if (Event.Get()->TypeName().StartsWith("SupportedBy"))
+		else if (TypeName.StartsWith("SupportedBy"))
 		{
 			return EventSelection.bSupportedBy;
 		}
 		/* Reach + PreGrasp*/
-		else if (Event.Get()->TypeName().StartsWith("Reach")
-			|| Event.Get()->TypeName().StartsWith("PreGrasp")
+		else if (TypeName.StartsWith("Reach")
+			|| TypeName.StartsWith("PreGrasp")
 			)
 		{
 			return EventSelection.bReachAndPreGrasp;
 		}
 		/* Grasp */
-		else if (Event.Get()->TypeName().StartsWith("Grasp"))
+		else if (TypeName.StartsWith("Grasp"))
 		{
 			return EventSelection.bGrasp;
 		}
 		/* PickAndPlace */
-		else if (Event.Get()->TypeName().StartsWith("Slide")
-			|| Event.Get()->TypeName().StartsWith("PickUp")
-			|| Event.Get()->TypeName().StartsWith("Transport")
-			|| Event.Get()->TypeName().StartsWith("PutDown")
+		else if (TypeName.StartsWith("Slide")
+			|| TypeName.StartsWith("PickUp")
+			|| TypeName.StartsWith("Transport")
+			|| TypeName.StartsWith("PutDown")
 			)
 		{
 			return EventSelection.bPickAndPlace;
 		}
 		
-		UE_LOG(LogTemp, Error, TEXT("%s::%d Unknown event %s, will be written anyhow.."),
-			*FString(__FUNCTION__), __LINE__, *Event.Get()->ToString());
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Unknown event type %s, will be written anyhow.."),
+			*FString(__FUNCTION__), __LINE__, *TypeName);
 		return true;
 
 		//// TODO switch to UPROPERTY pure dynamic_cast does not work without RTTI
@@ -59,5 +59,11 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("Grasp")); };
+
+	// Get the individuals taking part in the event
+	virtual void GetParticipants(TArray<USLBaseIndividual*>& OutParticipants) const override { OutParticipants.Add(Manipulator); OutParticipants.Add(Individual); };
+
+	// Get the type specific values of the event
+	virtual void GetTypedValues(FSLEventTypedValues& OutValues) const override { OutValues.PairId = PairId; OutValues.SubType = GraspType; };
 	/* End IEvent interface */
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "Events/ISLEventHandler.h"
 #include "Events/SLGraspEvent.h"
+#include "Events/SLPendingEventTable.h"
 
 /**
  * Listens to grasp events input, and outputs finished semantic grasp events
@@ -41,8 +42,8 @@ private:
 	// Parent
 	class USLManipulatorMonitor* Parent;
 
-	// Array of started events
-	TArray<TSharedPtr<FSLGraspEvent>> StartedEvents;
+	// Started events indexed by the grasped individual
+	TSLPendingEventTable<USLBaseIndividual*, TSharedPtr<FSLGraspEvent>> StartedEvents;
 	
 	/* Constant values */
 	constexpr static float GraspEventMin = 0.25f;
@@ -5,6 +5,7 @@
 
 #include "Events/ISLEventHandler.h"
 #include "Events/SLContactEvent.h"
+#include "Events/SLPendingEventTable.h"
 #include "TimerManager.h"
 
 // Forward declarations
@@ -47,6 +48,6 @@ private:
 	// Parent semantic overlap area
 	class USLManipulatorMonitor* Parent = nullptr;
 
-	// Array of started contact events
-	TArray<TSharedPtr<FSLContactEvent>> StartedEvents;
+	// Started contact events indexed by the other individual
+	TSLPendingEventTable<USLBaseIndividual*, TSharedPtr<FSLContactEvent>> StartedEvents;
 };
@@ -0,0 +1,176 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Pending (started, not yet finished) entries indexed by key, every key holds its entries in a FIFO queue,
+ * the finish lookups are hash based instead of linear scans over all the pending entries,
+ * the bulk removals return the entries in their insertion order (stable publishing order)
+ */
+template<typename KeyType, typename ValueType>
+class TSLPendingEventTable
+{
+public:
+	// Add the value at the back of the queue of the key
+	void Add(const KeyType& Key, const ValueType& Value)
+	{
+		Buckets.FindOrAdd(Key).Emplace(FEntry(NextSeq++, Value));
+		NumEntries++;
+	}
+
+	// Oldest value of the key, nullptr if none
+	ValueType* FindOldest(const KeyType& Key)
+	{
+		if (FBucket* Bucket = Buckets.Find(Key))
+		{
+			return &(*Bucket)[0].Value;
+		}
+		return nullptr;
+	}
+
+	// True if the key has pending values
+	bool Contains(const KeyType& Key) const
+	{
+		return Buckets.Contains(Key);
+	}
+
+	// Remove the oldest value of the key (false if none)
+	bool RemoveOldest(const KeyType& Key, ValueType& OutValue)
+	{
+		return RemoveFirstIf(Key, [](const ValueType&) { return true; }, OutValue);
+	}
+
+	// Remove the oldest value of the key which passes the predicate (false if none)
+	template<typename PredicateType>
+	bool RemoveFirstIf(const KeyType& Key, PredicateType Predicate, ValueType& OutValue)
+	{
+		FBucket* Bucket = Buckets.Find(Key);
+		if (Bucket == nullptr)
+		{
+			return false;
+		}
+
+		for (int32 Idx = 0; Idx < Bucket->Num(); ++Idx)
+		{
+			if (Predicate((*Bucket)[Idx].Value))
+			{
+				OutValue = MoveTemp((*Bucket)[Idx].Value);
+				Bucket->RemoveAt(Idx, 1, false);
+				if (Bucket->Num() == 0)
+				{
+					Buckets.Remove(Key);
+				}
+				NumEntries--;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Remove all the values which pass the predicate, the removed values are appended in insertion order
+	template<typename PredicateType>
+	void RemoveAllIf(PredicateType Predicate, TArray<ValueType>& OutValues)
+	{
+		TArray<FEntry> Removed;
+		for (auto BucketItr(Buckets.CreateIterator()); BucketItr; ++BucketItr)
+		{
+			FBucket& Bucket = BucketItr.Value();
+			int32 NumKept = 0;
+			for (int32 Idx = 0; Idx < Bucket.Num(); ++Idx)
+			{
+				if (Predicate(Bucket[Idx].Value))
+				{
+					Removed.Emplace(MoveTemp(Bucket[Idx]));
+				}
+				else
+				{
+					if (NumKept != Idx)
+					{
+						Bucket[NumKept] = MoveTemp(Bucket[Idx]);
+					}
+					NumKept++;
+				}
+			}
+			if (NumKept == 0)
+			{
+				BucketItr.RemoveCurrent();
+			}
+			else if (NumKept < Bucket.Num())
+			{
+				Bucket.RemoveAt(NumKept, Bucket.Num() - NumKept, false);
+			}
+		}
+		NumEntries -= Removed.Num();
+		AppendInInsertionOrder(Removed, OutValues);
+	}
+
+	// Remove all the values, they are appended in insertion order
+	void RemoveAll(TArray<ValueType>& OutValues)
+	{
+		TArray<FEntry> Removed;
+		Removed.Reserve(NumEntries);
+		for (auto& BucketPair : Buckets)
+		{
+			for (auto& Entry : BucketPair.Value)
+			{
+				Removed.Emplace(MoveTemp(Entry));
+			}
+		}
+		Empty();
+		AppendInInsertionOrder(Removed, OutValues);
+	}
+
+	// Remove all the values
+	void Empty()
+	{
+		Buckets.Empty();
+		NumEntries = 0;
+	}
+
+	// Number of pending values
+	int32 Num() const { return NumEntries; };
+
+private:
+	// Pending value with its insertion number
+	struct FEntry
+	{
+		// Default ctor
+		FEntry() = default;
+
+		// Init ctor
+		FEntry(uint64 InSeq, const ValueType& InValue) : Seq(InSeq), Value(InValue) {};
+
+		// Insertion number
+		uint64 Seq;
+
+		// Pending value
+		ValueType Value;
+	};
+
+	// Queue of a key, usually a single entry
+	typedef TArray<FEntry, TInlineAllocator<1>> FBucket;
+
+	// Sort the entries by their insertion number and move out their values
+	static void AppendInInsertionOrder(TArray<FEntry>& Entries, TArray<ValueType>& OutValues)
+	{
+		Entries.Sort([](const FEntry& A, const FEntry& B) { return A.Seq < B.Seq; });
+		OutValues.Reserve(OutValues.Num() + Entries.Num());
+		for (auto& Entry : Entries)
+		{
+			OutValues.Emplace(MoveTemp(Entry.Value));
+		}
+	}
+
+private:
+	// Pending entries queued by their key
+	TMap<KeyType, FBucket> Buckets;
+
+	// Next insertion number
+	uint64 NextSeq = 0;
+
+	// Number of pending entries
+	int32 NumEntries = 0;
+};
@@ -55,5 +55,11 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("PickUp")); };
+
+	// Get the individuals taking part in the event
+	virtual void GetParticipants(TArray<USLBaseIndividual*>& OutParticipants) const override { OutParticipants.Add(Manipulator); OutParticipants.Add(Individual); };
+
+	// Get the type specific values of the event
+	virtual void GetTypedValues(FSLEventTypedValues& OutValues) const override { OutValues.PairId = PairId; };
 	/* End IEvent interface */
 };
\ No newline at end of file
@@ -66,5 +66,11 @@ public:
 
 	// Get the event type name
 	virtual FString TypeName() const override { return FString(TEXT("Slicing")); };
+
+	// Get the individuals taking part in the event
+	virtual void GetParticipants(TArray<USLBaseIndividual*>& OutParticipants) const override;
+
+	// Get the type specific values of the event
+	virtual void GetTypedValues(FSLEventTypedValues& OutValues) const override { OutValues.PairId = PairId; OutValues.TaskSuccess = bTaskSuccessful ? 1 : 0; };
 	/* End IEvent interface */
 };
\ No newline at end of file
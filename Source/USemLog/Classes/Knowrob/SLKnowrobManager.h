@@ -83,6 +83,11 @@ public:
 	// Spawn or get manager from the world
 	static ASLKnowrobManager* GetExistingOrSpawnNew(UWorld* World);
 
+	// Load the event store file of the task and episode and log the events overlapping the time range,
+	// optionally only the ones of the given type and/or with the given participant (individual id)
+	bool QueryEventStore(const FString& TaskId, const FString& EpisodeId, float StartTime, float EndTime,
+		const FString& TypeName = FString(), const FString& ParticipantId = FString()) const;
+
 protected:
 	// Setup user input bindings
 	void SetupInputBindings();
@@ -310,4 +315,59 @@ private:
 
     UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons")
     bool StopLogButtonHack = false;
+
+	// Import the world state episode file of the task and episode (location parameters) into mongo
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons")
+	bool bImportEpisodeFileButtonHack = false;
+
+	// Import the event journal of the task and episode (location parameters) into mongo
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons")
+	bool bImportEventJournalButtonHack = false;
+
+	// Start of the event store query time range
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons", meta = (ClampMin = 0))
+	float EventQueryStartTime = 0.f;
+
+	// End of the event store query time range
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons", meta = (ClampMin = 0))
+	float EventQueryEndTime = 3600.f;
+
+	// Type name of the queried events (empty for any)
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons")
+	FString EventQueryTypeName;
+
+	// Individual id of a participant of the queried events (empty for any)
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons")
+	FString EventQueryParticipantId;
+
+	// Query the event store file of the task and episode (location parameters) and log the results
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Logger Buttons")
+	bool bQueryEventStoreButtonHack = false;
+
+	/****************************************************************/
+	/*                        Benchmarks                            */
+	/****************************************************************/
+	// Number of repetitions of the benchmarked operation
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Benchmark Buttons", meta = (ClampMin = 1))
+	int32 BenchmarkNumIterations = 100;
+
+	// Compare the bone pose application of the loaded episode (indexed single pass vs by name)
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Benchmark Buttons")
+	bool bBenchmarkBonePosesButtonHack = false;
+
+	// Number of synthetic events of the owl writer benchmark
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Benchmark Buttons", meta = (ClampMin = 1))
+	int32 BenchmarkNumEvents = 100000;
+
+	// Compare the streaming owl writer with the previous string concatenation
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Benchmark Buttons")
+	bool bBenchmarkOwlWriterButtonHack = false;
+
+	// Number of simultaneous contacts of the pending events benchmark
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Benchmark Buttons", meta = (ClampMin = 1))
+	int32 BenchmarkNumContacts = 5000;
+
+	// Compare the pending contact events lookups (keyed table vs linear scan)
+	UPROPERTY(EditAnywhere, Transient, Category = "Semantic Logger|Benchmark Buttons")
+	bool bBenchmarkPendingEventsButtonHack = false;
 };
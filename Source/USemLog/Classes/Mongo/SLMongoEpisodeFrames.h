@@ -0,0 +1,118 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Progress of the episode loading (decoded frames, total frames)
+typedef TFunction<void(int32, int32)> FSLMongoEpisodeProgressCallback;
+
+/**
+ * Frame-major flat storage of the episode poses, the individuals are referenced by their interned index
+ */
+struct FSLMongoEpisodeFrames
+{
+	// Individual ids by index
+	TArray<FString> Ids;
+
+	// Index of every id
+	TMap<FString, int32> IdToIdx;
+
+	// Frame timestamps (increasing)
+	TArray<float> Timestamps;
+
+	// Entries of frame i are in [FrameOffsets[i], FrameOffsets[i + 1])
+	TArray<int32> FrameOffsets;
+
+	// Individual index of every entry
+	TArray<int32> EntryIdxs;
+
+	// Pose of every entry
+	TArray<FTransform> EntryPoses;
+
+	// Number of frames
+	int32 NumFrames() const { return Timestamps.Num(); };
+
+	// Get the index of the id, adds it if new
+	int32 Intern(const FString& Id)
+	{
+		if (const int32* Idx = IdToIdx.Find(Id))
+		{
+			return *Idx;
+		}
+		const int32 NewIdx = Ids.Add(Id);
+		IdToIdx.Add(Id, NewIdx);
+		return NewIdx;
+	};
+
+	// Start a new frame, the following entries are added to it
+	void AddFrame(float Ts)
+	{
+		if (FrameOffsets.Num() == 0)
+		{
+			FrameOffsets.Add(0);
+		}
+		Timestamps.Add(Ts);
+		FrameOffsets.Add(FrameOffsets.Last());
+	};
+
+	// Add an entry to the last frame
+	void AddEntry(int32 Idx, const FTransform& Pose)
+	{
+		EntryIdxs.Add(Idx);
+		EntryPoses.Add(Pose);
+		FrameOffsets.Last()++;
+	};
+
+	// Clear the data
+	void Empty()
+	{
+		Ids.Empty();
+		IdToIdx.Empty();
+		Timestamps.Empty();
+		FrameOffsets.Empty();
+		EntryIdxs.Empty();
+		EntryPoses.Empty();
+	};
+
+	// Memory used by the frames
+	SIZE_T GetAllocatedSize() const
+	{
+		return Ids.GetAllocatedSize() + IdToIdx.GetAllocatedSize() + Timestamps.GetAllocatedSize()
+			+ FrameOffsets.GetAllocatedSize() + EntryIdxs.GetAllocatedSize() + EntryPoses.GetAllocatedSize();
+	};
+
+	// Append the frames of the one id to pose map per frame form
+	void Append(const TArray<TPair<float, TMap<FString, FTransform>>>& EpisodeData)
+	{
+		Timestamps.Reserve(Timestamps.Num() + EpisodeData.Num());
+		FrameOffsets.Reserve(FrameOffsets.Num() + EpisodeData.Num() + 1);
+		for (const auto& TsFramePair : EpisodeData)
+		{
+			AddFrame(TsFramePair.Key);
+			for (const auto& IdPosePair : TsFramePair.Value)
+			{
+				AddEntry(Intern(IdPosePair.Key), IdPosePair.Value);
+			}
+		}
+	};
+
+	// Convert to one id to pose map per frame
+	TArray<TPair<float, TMap<FString, FTransform>>> ToEpisodeData() const
+	{
+		TArray<TPair<float, TMap<FString, FTransform>>> EpisodeData;
+		EpisodeData.Reserve(NumFrames());
+		for (int32 FrameIdx = 0; FrameIdx < NumFrames(); ++FrameIdx)
+		{
+			TMap<FString, FTransform> FrameData;
+			FrameData.Reserve(FrameOffsets[FrameIdx + 1] - FrameOffsets[FrameIdx]);
+			for (int32 EntryIdx = FrameOffsets[FrameIdx]; EntryIdx < FrameOffsets[FrameIdx + 1]; ++EntryIdx)
+			{
+				FrameData.Emplace(Ids[EntryIdxs[EntryIdx]], EntryPoses[EntryIdx]);
+			}
+			EpisodeData.Emplace(Timestamps[FrameIdx], MoveTemp(FrameData));
+		}
+		return EpisodeData;
+	};
+};
@@ -0,0 +1,106 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Mongo/SLMongoEpisodeFrames.h"
+
+/**
+ * Time sorted poses of an individual, one entry for every written frame which contains the individual
+ */
+struct FSLMongoPoseTimeline
+{
+	// Frame timestamps (increasing)
+	TArray<float> Timestamps;
+
+	// Pose of every timestamp
+	TArray<FTransform> Poses;
+
+	// Index of the last entry at or before the given time (INDEX_NONE if the timeline starts later)
+	int32 FindFloor(float Ts) const;
+
+	// Get the last pose at or before the given time (false if the timeline starts later)
+	bool GetPoseAt(float Ts, FTransform& OutPose) const;
+
+	// Get the poses between the given timestamps, consecutive poses are at least DeltaT apart if DeltaT is positive
+	void GetTrajectory(float StartTs, float EndTs, float DeltaT, TArray<FTransform>& OutPoses) const;
+
+	// Memory used by the timeline
+	SIZE_T GetAllocatedSize() const { return Timestamps.GetAllocatedSize() + Poses.GetAllocatedSize(); };
+};
+
+/**
+ * Pose timelines of all the individuals of an episode
+ */
+struct FSLMongoEpisodeTimelines
+{
+	// Individual id to its timeline
+	TMap<FString, FSLMongoPoseTimeline> Timelines;
+
+	// Memory used by the timelines
+	SIZE_T NumBytes = 0;
+
+	// Build the timelines from the (time sorted) episode frames
+	void Build(const FSLMongoEpisodeFrames& EpisodeFrames);
+
+	// Get the pose of the individual at the given time (same as the database query, identity if not found)
+	FTransform GetIndividualPoseAt(const FString& Id, float Ts) const;
+
+	// Get the poses of the individual between the given timestamps (same as the database query)
+	TArray<FTransform> GetIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT) const;
+};
+
+/**
+ * Memory bounded cache of the episode pose timelines, the least recently used episodes are evicted first
+ */
+class FSLMongoPoseTimelineCache
+{
+public:
+	// Ctor
+	FSLMongoPoseTimelineCache();
+
+	// Dtor
+	~FSLMongoPoseTimelineCache();
+
+	// Set the memory budget, evicts episodes if it is exceeded
+	void SetMaxMemory(int64 InMaxBytes);
+
+	// Get the cached episode and mark it as most recently used (nullptr if not cached)
+	const FSLMongoEpisodeTimelines* Find(const FString& TaskId, const FString& EpisodeId);
+
+	// Build and cache the episode timelines (nullptr if the episode does not fit in the memory budget)
+	const FSLMongoEpisodeTimelines* Add(const FString& TaskId, const FString& EpisodeId, const FSLMongoEpisodeFrames& EpisodeFrames);
+
+	// True if the episode did not fit in the current memory budget (it should not be downloaded again)
+	bool IsOversized(const FString& TaskId, const FString& EpisodeId) const { return OversizedKeys.Contains(GetKey(TaskId, EpisodeId)); };
+
+	// Remove all cached episodes
+	void Empty();
+
+	// Memory used by the cached episodes
+	int64 GetNumBytes() const { return NumBytes; };
+
+private:
+	// Cache key of the episode
+	static FString GetKey(const FString& TaskId, const FString& EpisodeId) { return TaskId + TEXT(".") + EpisodeId; };
+
+	// Remove the least recently used episodes until the extra bytes fit in the budget
+	void Evict(int64 NumExtraBytes);
+
+private:
+	// Cached episodes
+	TMap<FString, FSLMongoEpisodeTimelines*> Episodes;
+
+	// Cache keys from the least to the most recently used
+	TArray<FString> LruKeys;
+
+	// Keys of the episodes which do not fit in the memory budget
+	TSet<FString> OversizedKeys;
+
+	// Memory budget
+	int64 MaxBytes;
+
+	// Memory used by the cached episodes
+	int64 NumBytes;
+};
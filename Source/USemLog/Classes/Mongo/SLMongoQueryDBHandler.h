@@ -4,6 +4,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Runtime/SLLoggerStructs.h"
+#include "Mongo/SLMongoEpisodeFrames.h"
 
 #if SL_WITH_LIBMONGO_C
 class ASLVisionPoseableMeshActor;
@@ -18,6 +20,62 @@ THIRD_PARTY_INCLUDES_START
 THIRD_PARTY_INCLUDES_END
 #endif //SL_WITH_LIBMONGO_C
 
+/**
+ * Layout of the packed world state poses of a collection (written by the world state logger)
+ */
+struct FSLMongoPoseTable
+{
+	// Pose encoding of the collection (documents if no table is found)
+	ESLWorldStatePoseEncoding Encoding = ESLWorldStatePoseEncoding::Document;
+
+	// Individual ids in pose index order
+	TArray<FString> Ids;
+
+	// Pose index of every id
+	TMap<FString, int32> IdToPoseIdx;
+
+	// Marks the poses of the individuals array
+	TBitArray<> ListedMask;
+
+	// Skeletal individual pose index to its bones (skeleton bone index, pose index)
+	TMap<int32, TArray<TPair<int32, int32>>> SkeletalBones;
+
+	// The poses are stored as binary blobs
+	bool IsPacked() const { return Encoding != ESLWorldStatePoseEncoding::Document; };
+
+	// Clear the table
+	void Empty()
+	{
+		Encoding = ESLWorldStatePoseEncoding::Document;
+		Ids.Empty();
+		IdToPoseIdx.Empty();
+		ListedMask.Empty();
+		SkeletalBones.Empty();
+	};
+};
+
+/**
+ * Frames of a cursor batch decoded by a worker thread
+ */
+struct FSLMongoEpisodeBatch
+{
+	// The entries reference LocalIds (documents), or the pose table (packed)
+	bool bUseLocalIds = false;
+
+	// Ids of the individuals found in the batch
+	TArray<FString> LocalIds;
+
+	// Frame timestamps
+	TArray<float> Timestamps;
+
+	// Number of entries of every frame
+	TArray<int32> NumEntries;
+
+	// Individual index and pose of the entries
+	TArray<int32> Idxs;
+	TArray<FTransform> Poses;
+};
+
 /**
  * 
  */
@@ -61,8 +119,11 @@ public:
 	// Get the whole episode data
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData() const;
 
-	// Get the whole episode data in an async thread
-	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeDataAsync() const;
+	// Stream the whole episode into flat frames, the documents are decoded in parallel while the cursor is read
+	bool GetEpisodeFrames(FSLMongoEpisodeFrames& OutFrames, const FSLMongoEpisodeProgressCallback& OnProgress = nullptr, int32 BatchSize = 256) const;
+
+	// Get a signature of the episode content (number of frames and the last frame), empty if not available
+	FString GetEpisodeSignature() const;
 
 	// Get the episode data at the given timestamp (frame)
 	TMap<FString, FTransform> GetFrameData(float Ts);
@@ -78,6 +139,34 @@ private:
 
 	// Get the timestamp value from document (used for trajectory delta time comparison)
 	double GetTs(const bson_t* doc) const;
+
+	// Get the timestamp of the last keyframe at or before the given time (-BIG_NUMBER if there are no keyframes)
+	double GetKeyframeTs(float Ts) const;
+
+	/* Packed poses */
+	// Load the packed pose table of the collection (false if the collection uses the document encoding)
+	bool LoadPoseTable();
+
+	// Get the pose with the given index from the packed document (false if it is not in the document)
+	bool GetPose(const bson_t* doc, int32 PoseIdx, FTransform& OutPose) const;
+
+	// Get all the poses from the packed document
+	bool GetPoses(const bson_t* doc, TArray<int32>& OutIdxs, TArray<FTransform>& OutPoses) const;
+
+	// Find the packed frame documents between the given timestamps
+	mongoc_cursor_t* FindPackedFrames(float StartTs, float EndTs, bool bNewestFirst) const;
+
+	// Get the skeletal pose from the packed document (false if the skeletal individual is not in the document)
+	bool GetPackedSkeletalPose(const bson_t* doc, int32 PoseIdx, TPair<FTransform, TMap<int32, FTransform>>& OutSkeletalPose) const;
+
+	// Packed versions of the queries
+	FTransform GetPackedIndividualPoseAt(const FString& Id, float Ts) const;
+	TArray<FTransform> GetPackedIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT) const;
+	TPair<FTransform, TMap<int32, FTransform>> GetPackedSkeletalIndividualPoseAt(const FString& Id, float Ts) const;
+	TArray<TPair<FTransform, TMap<int32, FTransform>>> GetPackedSkeletalIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT) const;
+
+	// Decode the frame documents of a batch (called from the thread pool)
+	void DecodeEpisodeBatch(const TArray<bson_t*>& Docs, FSLMongoEpisodeBatch& OutBatch) const;
 #endif // SL_WITH_LIBMONGO_C
 
 private:
@@ -90,6 +179,9 @@ private:
 	// Connected to a database
 	bool bCollectionSet;
 
+	// Packed pose layout of the current collection
+	FSLMongoPoseTable PoseTable;
+
 #if SL_WITH_LIBMONGO_C
 	// Server uri
 	mongoc_uri_t* uri;
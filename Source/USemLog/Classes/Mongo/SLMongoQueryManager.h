@@ -6,6 +6,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Info.h"
 #include "Mongo/SLMongoQueryDBHandler.h"
+#include "Mongo/SLMongoPoseTimelineCache.h"
 #include "SLMongoQueryManager.generated.h"
 
 /**
@@ -73,9 +74,22 @@ public:
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData(const FString& InEpisodeId);
 	TArray<TPair<float, TMap<FString, FTransform>>> GetEpisodeData() const;
 
+	// Get the episode as flat frames (streamed and decoded in parallel)
+	bool GetEpisodeFrames(const FString& InTaskId, const FString& InEpisodeId, FSLMongoEpisodeFrames& OutFrames,
+		const FSLMongoEpisodeProgressCallback& OnProgress = nullptr);
+	bool GetEpisodeFrames(FSLMongoEpisodeFrames& OutFrames, const FSLMongoEpisodeProgressCallback& OnProgress = nullptr) const;
+
+	// Get a signature of the episode content, changes if the episode is re-written (empty if not available)
+	FString GetEpisodeSignature(const FString& InTaskId, const FString& InEpisodeId);
+	FString GetEpisodeSignature() const;
+
 	// Spawn or get manager from the world
 	static ASLMongoQueryManager* GetExistingOrSpawnNew(UWorld* World);
 
+private:
+	// Load the active episode into the pose cache (if enabled and it fits the memory budget)
+	void SetEpisodeTimelines();
+
 protected:
 	// True when successfully connected to the server
 	bool bConnected : 1;
@@ -96,6 +110,20 @@ private:
 	// Database handler
 	FSLMongoQueryDBHandler DBHandler;
 
+	// Load the queried episodes in memory and answer the individual pose and trajectory queries without the database
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bUsePoseCache = false;
+
+	// Memory budget of the cached episodes, the least recently used ones are evicted first
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bUsePoseCache", ClampMin = 1))
+	int32 PoseCacheMaxMemoryMB = 512;
+
+	// Cached episode pose timelines
+	FSLMongoPoseTimelineCache PoseCache;
+
+	// Pose timelines of the active episode (nullptr if not cached)
+	const FSLMongoEpisodeTimelines* EpisodeTimelines;
+
 	///* Editor button hacks */
 	//// Server ip to connect to
 	//UPROPERTY(EditAnywhere, Category = "Semantic Logger|Buttons")
@@ -5,13 +5,14 @@
 
 #include "Components/MeshComponent.h"
 #include "Components/ShapeComponent.h"
-#include "TimerManager.h"
 #include "Monitors/SLMonitorStructs.h"
+#include "Events/SLPendingEventTable.h"
 #include "SLContactMonitorInterface.generated.h"
 
 // Forward declaration
 class USLBaseIndividual;
 class USLIndividualComponent;
+class FSLContactMonitorScheduler;
 
 // DELEGATES
 /** Notiy the begin/end of a supported by event */
@@ -55,6 +56,9 @@ class ISLContactMonitorInterface
 {
 	GENERATED_BODY()
 
+	// The scheduler runs the supported by checks and the delayed overlap end publishing
+	friend class FSLContactMonitorScheduler;
+
 public:
 	// Initialize trigger area for runtime, check if outer is valid and semantically annotated
 	virtual void Init(bool bLogSupportedByEvents = true) = 0;
@@ -65,6 +69,9 @@ public:
 	// Stop publishing overlap events
 	void Finish(bool bForced = false);
 
+	// Set the scheduler of the supported by checks and the delayed overlap end events (call before start)
+	void SetScheduler(FSLContactMonitorScheduler* InScheduler) { Scheduler = InScheduler; };
+
 	// Get init state
 	bool IsInit() const { return bIsInit; };
 
@@ -110,7 +117,7 @@ protected:
 	// Start checking for supported by events
 	void StartSupportedByUpdateCheck();
 
-	// Check for supported by events
+	// Check for supported by events (called by the scheduler)
 	void SupportedByUpdateCheckBegin();
 
 	// Check if Other is a supported by candidate
@@ -133,7 +140,8 @@ protected:
 		int32 OtherBodyIndex);
 
 	// Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-	void DelayedOverlapEndEventCallback();
+	// (called by the scheduler, returns true if there are still too recent events to publish)
+	bool DelayedOverlapEndEventCallback();
 
 	// Broadcast delayed overlaps, if curr time < 0, it guarantees a publish
 	bool PublishDelayedOverlapEndEvent(const FSLOverlapEndEvent& Ev, float CurrTime = -1.f);
@@ -163,8 +171,14 @@ protected:
 	// Include supported by events
 	uint8 bLogSupportedByEvents : 1;
 
-	// Array of events id of objects currently supporting this item, used for checking if this object is supported by any suface(s)
-	TArray<uint64> IsSupportedByPariIds;
+	// True if the monitor is in the supported by checks of the scheduler
+	uint8 bSupportedByCheckScheduled : 1;
+
+	// True if the monitor has an overlap end flush in the scheduler
+	uint8 bOverlapEndFlushScheduled : 1;
+
+	// Set of events id of objects currently supporting this item, used for checking if this object is supported by any suface(s)
+	TSet<uint64> IsSupportedByPariIds;
 
 	// Last supported by time
 	float PrevSupportedByEndTime;
@@ -184,23 +198,15 @@ protected:
 	// Semantic individual object
 	USLBaseIndividual* OwnerIndividualObject;
 
-	// SupportedBy contact candidates
-	TArray<FSLContactResult> SupportedByCandidates;
-	
-	// Supported by event update timer handle
-	FTimerHandle SupportedByTimerHandle;
-
-	// Allow binding against non-UObject functions
-	FTimerDelegate SupportedByTimerDelegate;
-
-	// Send finished events with a delay to check for possible concatenation of equal and consecutive events with small time gaps in between
-	FTimerHandle DelayTimerHandle;
+	// SupportedBy contact candidates indexed by the other individual
+	TSLPendingEventTable<USLBaseIndividual*, FSLContactResult> SupportedByCandidates;
 
-	// Can only bind the timer handle to UObjects or FTimerDelegates
-	FTimerDelegate DelayTimerDelegate;
+	// Runs the supported by checks and publishes the finished events with a delay (to check for possible 
+	// concatenation of equal and consecutive events with small time gaps in between), owned by the symbolic logger
+	FSLContactMonitorScheduler* Scheduler;
 
-	// Array of recently ended overlaps
-	TArray<FSLOverlapEndEvent> RecentlyEndedOverlapEvents;
+	// Recently ended overlaps indexed by the other individual
+	TSLPendingEventTable<USLBaseIndividual*, FSLOverlapEndEvent> RecentlyEndedOverlapEvents;
 
 	/* Constants */
 	static constexpr auto TagTypeName = TEXT("SemLogColl");
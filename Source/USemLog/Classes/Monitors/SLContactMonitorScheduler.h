@@ -0,0 +1,105 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+class ISLContactMonitorInterface;
+
+/**
+ * Scheduler statistics, the cost of the batched contact monitor updates
+ */
+struct FSLContactMonitorSchedulerStats
+{
+	// Number of scheduler ticks
+	int32 NumTicks = 0;
+
+	// Number of ticks with supported by sweeps or overlap end flushes
+	int32 NumActiveTicks = 0;
+
+	// Number of monitor supported by checks
+	int32 NumSupportedByChecks = 0;
+
+	// Number of monitor overlap end flushes
+	int32 NumOverlapEndFlushes = 0;
+
+	// Largest number of scheduled monitors in a tick
+	int32 MaxScheduledMonitors = 0;
+
+	// Summed and max duration of the active ticks (in seconds)
+	double TotalDuration = 0.0;
+	double MaxDuration = 0.0;
+
+	// Add the result of a tick
+	void AddTick(int32 InNumSupportedByChecks, int32 InNumOverlapEndFlushes, int32 NumScheduledMonitors, double Duration)
+	{
+		NumTicks++;
+		MaxScheduledMonitors = FMath::Max(MaxScheduledMonitors, NumScheduledMonitors);
+		if (InNumSupportedByChecks > 0 || InNumOverlapEndFlushes > 0)
+		{
+			NumActiveTicks++;
+			NumSupportedByChecks += InNumSupportedByChecks;
+			NumOverlapEndFlushes += InNumOverlapEndFlushes;
+			TotalDuration += Duration;
+			MaxDuration = FMath::Max(MaxDuration, Duration);
+		}
+	};
+
+	// Get the statistics as string
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("ticks=%d (active=%d); supported by checks=%d; overlap end flushes=%d; max scheduled monitors=%d; active tick[s] avg=%f max=%f total=%f;"),
+			NumTicks, NumActiveTicks, NumSupportedByChecks, NumOverlapEndFlushes, MaxScheduledMonitors,
+			NumActiveTicks > 0 ? TotalDuration / NumActiveTicks : 0.0, MaxDuration, TotalDuration);
+	};
+};
+
+/**
+ * Runs the supported by checks and the delayed overlap end publishing of all the contact monitors
+ * from the symbolic logger tick, instead of two world timers for every monitor shape
+ */
+class USEMLOG_API FSLContactMonitorScheduler
+{
+public:
+	// Ctor
+	FSLContactMonitorScheduler();
+
+	// Add the monitor to the supported by checks (ignored if it is already scheduled)
+	void ScheduleSupportedByCheck(ISLContactMonitorInterface* Monitor);
+
+	// Publish the delayed overlap end events of the monitor at the given time (ignored if it is already scheduled)
+	void ScheduleOverlapEndFlush(ISLContactMonitorInterface* Monitor, float FlushTime);
+
+	// Cancel the overlap end flush of the monitor
+	void CancelOverlapEndFlush(ISLContactMonitorInterface* Monitor);
+
+	// Remove the monitor from all the schedules
+	void RemoveMonitor(ISLContactMonitorInterface* Monitor);
+
+	// Run the due supported by checks and overlap end flushes
+	void Tick(float CurrTime);
+
+	// Get the statistics of the ticks
+	const FSLContactMonitorSchedulerStats& GetStats() const { return Stats; };
+
+	// Clear the schedules and the statistics
+	void Reset();
+
+private:
+	// Monitors with supported by candidates
+	TArray<ISLContactMonitorInterface*> SupportedByMonitors;
+
+	// Monitors with delayed overlap end events
+	TArray<ISLContactMonitorInterface*> OverlapEndMonitors;
+
+	// Time when the overlap end events of the monitor with the same index are published
+	TArray<float> OverlapEndFlushTimes;
+
+	// Time of the last supported by sweep
+	float LastSupportedByCheckTime;
+
+	// Tick statistics
+	FSLContactMonitorSchedulerStats Stats;
+};
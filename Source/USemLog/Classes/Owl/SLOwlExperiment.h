@@ -71,54 +71,15 @@ public:
 	// Create and add experiment node individual
 	void AddExperimentIndividual(const TArray<FString>& SubActionIds, const FString& SemMapId, const FString& TaskId)
 	{
-		const FSLOwlPrefixName OwlNI("owl", "NamedIndividual");
-		const FSLOwlPrefixName RdfAbout("rdf", "about");
-		const FSLOwlPrefixName RdfType("rdf", "type");
-		const FSLOwlPrefixName KrPerformedInMap("knowrob", "performedInMap");
-		const FSLOwlPrefixName KrPerformedTask("knowrob", "performedTask");
-		const FSLOwlPrefixName KrSubAction("knowrob", "subAction");
-		const FSLOwlPrefixName KrStartTime("knowrob", "startTime");
-		const FSLOwlPrefixName KrEndTime("knowrob", "endTime");
-		const FSLOwlPrefixName RdfResource("rdf", "resource");
-		const FSLOwlAttributeValue ExperimentId(Prefix, Id);
-
 		// Create experiment individual
-		ExperimentIndividual.Name = OwlNI;
-		ExperimentIndividual.AddAttribute(FSLOwlAttribute(RdfAbout, ExperimentId));
-		ExperimentIndividual.AddChildNode(FSLOwlNode(RdfType, FSLOwlAttribute(
-			RdfResource, FSLOwlAttributeValue("knowrob", "AmevaExperiment"))));
-
-		// Add semantic map id
-		ExperimentIndividual.AddChildNode(FSLOwlNode(KrPerformedInMap, FSLOwlAttribute(
-			RdfResource, FSLOwlAttributeValue(Prefix, SemMapId))));
-
-		// Add executed task id
-		ExperimentIndividual.AddChildNode(FSLOwlNode(KrPerformedTask, FSLOwlAttribute(
-			RdfResource, FSLOwlAttributeValue(Prefix, TaskId))));
-
-		// Add start and end time
-		if (RegisteredTimepoints.Num() > 2)
-		{
-			float StartTime = RegisteredTimepoints[0];
-			const FString StartTimeId = "timepoint_" + FString::SanitizeFloat(StartTime);
-			ExperimentIndividual.AddChildNode(FSLOwlNode(KrStartTime,
-				FSLOwlAttribute(RdfResource, FSLOwlAttributeValue("log", StartTimeId))));
-
-			float EndTime = RegisteredTimepoints.Last();
-			const FString EndTimeId = "timepoint_" + FString::SanitizeFloat(EndTime);
-			ExperimentIndividual.AddChildNode(FSLOwlNode(KrEndTime,
-				FSLOwlAttribute(RdfResource, FSLOwlAttributeValue("log", EndTimeId))));
-		}
+		ExperimentIndividual = CreateExperimentIndividual(Prefix, Id, SemMapId, TaskId, RegisteredTimepoints);
 
 		// Add subactions
 		for (const auto& SubActionId : SubActionIds)
 		{
-			ExperimentIndividual.AddChildNode(FSLOwlNode(KrSubAction, FSLOwlAttribute(
-				RdfResource, FSLOwlAttributeValue("log", SubActionId))));
+			ExperimentIndividual.AddChildNode(CreateSubActionProperty(SubActionId));
 		}
 
-		ExperimentIndividual.Comment = "Experiment Individual " + Id;
-
 		// Add the experiment to the document individuals
 		AddIndividual(ExperimentIndividual);
 	}
@@ -198,6 +159,59 @@ public:
 		return Individual;
 	}
 
+	// Create the experiment individual without its subactions (start and end time from the sorted timepoints)
+	static FSLOwlNode CreateExperimentIndividual(const FString& InDocPrefix, const FString& InDocId,
+		const FString& SemMapId, const FString& TaskId, const TArray<float>& SortedTimepoints)
+	{
+		const FSLOwlPrefixName OwlNI("owl", "NamedIndividual");
+		const FSLOwlPrefixName RdfAbout("rdf", "about");
+		const FSLOwlPrefixName RdfType("rdf", "type");
+		const FSLOwlPrefixName KrPerformedInMap("knowrob", "performedInMap");
+		const FSLOwlPrefixName KrPerformedTask("knowrob", "performedTask");
+		const FSLOwlPrefixName KrStartTime("knowrob", "startTime");
+		const FSLOwlPrefixName KrEndTime("knowrob", "endTime");
+		const FSLOwlPrefixName RdfResource("rdf", "resource");
+		const FSLOwlAttributeValue ExperimentId(InDocPrefix, InDocId);
+
+		// Create experiment individual
+		FSLOwlNode Individual(OwlNI, FSLOwlAttribute(RdfAbout, ExperimentId));
+		Individual.AddChildNode(FSLOwlNode(RdfType, FSLOwlAttribute(
+			RdfResource, FSLOwlAttributeValue("knowrob", "AmevaExperiment"))));
+
+		// Add semantic map id
+		Individual.AddChildNode(FSLOwlNode(KrPerformedInMap, FSLOwlAttribute(
+			RdfResource, FSLOwlAttributeValue(InDocPrefix, SemMapId))));
+
+		// Add executed task id
+		Individual.AddChildNode(FSLOwlNode(KrPerformedTask, FSLOwlAttribute(
+			RdfResource, FSLOwlAttributeValue(InDocPrefix, TaskId))));
+
+		// Add start and end time
+		if (SortedTimepoints.Num() > 2)
+		{
+			float StartTime = SortedTimepoints[0];
+			const FString StartTimeId = "timepoint_" + FString::SanitizeFloat(StartTime);
+			Individual.AddChildNode(FSLOwlNode(KrStartTime,
+				FSLOwlAttribute(RdfResource, FSLOwlAttributeValue("log", StartTimeId))));
+
+			float EndTime = SortedTimepoints.Last();
+			const FString EndTimeId = "timepoint_" + FString::SanitizeFloat(EndTime);
+			Individual.AddChildNode(FSLOwlNode(KrEndTime,
+				FSLOwlAttribute(RdfResource, FSLOwlAttributeValue("log", EndTimeId))));
+		}
+
+		Individual.Comment = "Experiment Individual " + InDocId;
+		return Individual;
+	}
+
+	// Create a subaction property of the experiment individual
+	static FSLOwlNode CreateSubActionProperty(const FString& SubActionId)
+	{
+		const FSLOwlPrefixName KrSubAction("knowrob", "subAction");
+		const FSLOwlPrefixName RdfResource("rdf", "resource");
+		return FSLOwlNode(KrSubAction, FSLOwlAttribute(RdfResource, FSLOwlAttributeValue("log", SubActionId)));
+	}
+
 	// Create an object individual
 	static FSLOwlNode CreateObjectIndividual(const FString& InDocPrefix, const FString& InId, const FString& InClass)
 	{
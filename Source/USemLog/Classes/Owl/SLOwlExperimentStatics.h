@@ -6,6 +6,9 @@
 #include "EngineMinimal.h"
 #include "Owl/SLOwlExperiment.h"
 
+// Forward declarations
+class FSLEventJournalReader;
+
 /**
 * Helper functions for generating owl experiment documents
 */
@@ -27,6 +30,13 @@ struct USEMLOG_API FSLOwlExperimentStatics
 	// Write experiment to file
 	static void WriteToFile(TSharedPtr<FSLOwlExperiment> Experiment, const FString& Path, bool bOverwrite);
 
+	// Write the experiment template with the events of the journal to file, streaming the individuals
+	static bool WriteToFile(TSharedPtr<FSLOwlExperiment> ExperimentTemplate, FSLEventJournalReader& Journal,
+		const FString& Path, bool bOverwrite, const FString& SemMapId, const FString& TaskId);
+
+	// Compare the streaming writer with the previous recursive string concatenation on a synthetic experiment
+	static void BenchmarkWriter(int32 NumEvents = 100000);
+
 	/* Owl individuals / definitions creation */
 	// Create an event individual
 	static FSLOwlNode CreateEventIndividual(
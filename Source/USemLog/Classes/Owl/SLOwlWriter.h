@@ -0,0 +1,107 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Owl/SLOwlStructs.h"
+
+// Forward declarations
+struct FSLOwlNode;
+struct FSLOwlDoc;
+class FArchive;
+
+/**
+ * Streaming owl/xml serializer, appends the nodes to a reusable buffer
+ * which is kept in memory or written out to a file in UTF-8 chunks,
+ * the open nodes are kept on a stack which gives the indentation
+ */
+class USEMLOG_API FSLOwlWriter
+{
+public:
+	// Ctor, memory output, the nodes are indented starting from the given depth
+	FSLOwlWriter(int32 InBaseDepth = 0);
+
+	// Dtor, closes the file output
+	~FSLOwlWriter();
+
+	// Write the output to the given file from now on
+	bool OpenFile(const FString& InFilePath);
+
+	// Write the remaining output and close the file (false if any write failed)
+	bool Close();
+
+	// Write the whole document
+	void WriteDoc(const FSLOwlDoc& Doc);
+
+	// Write the document up to its individuals, the root node is left open
+	void WriteDocBegin(const FSLOwlDoc& Doc);
+
+	// Close the root node of the document
+	void WriteDocEnd();
+
+	// Write the node with all its children
+	void WriteNode(const FSLOwlNode& Node);
+
+	// Write the comment and the open tag of the node, the children are expected to follow
+	void BeginNode(const FSLOwlNode& Node);
+
+	// Write the close tag of the last open node
+	void EndNode();
+
+	// Append already serialized content
+	void WriteRaw(const FString& Str);
+
+	// Memory output (the file output only holds the chunk not written yet)
+	const FString& GetBuffer() const { return Buffer; };
+
+	// Move out the memory output and clear the writer
+	FString ConsumeBuffer();
+
+	// Clear the output and the open nodes, keeps the allocated buffer
+	void Reset();
+
+	// Number of serialized characters
+	int64 NumWrittenChars() const { return NumFlushedChars + Buffer.Len(); };
+
+	// Write the document directly to the file
+	static bool WriteDocToFile(const FSLOwlDoc& Doc, const FString& InFilePath);
+
+private:
+	// Write the indentation of the current depth (plus the extra steps)
+	void WriteIndent(int32 ExtraDepth = 0);
+
+	// Write the prefixed name (e.g. rdf:about)
+	void WritePrefixName(const FSLOwlPrefixName& Name);
+
+	// Write the attributes of an open tag, one per line if there are more
+	void WriteAttributes(const TArray<FSLOwlAttribute>& Attributes);
+
+	// Write the comment of the node
+	void WriteComment(const FString& Comment);
+
+	// Write the entity definitions
+	void WriteEntityDefinitions(const FSLOwlEntityDTD& EntityDefinitions);
+
+	// Write the buffer to the file if it is large enough (or forced)
+	void FlushToFile(bool bForce);
+
+private:
+	// Output buffer
+	FString Buffer;
+
+	// File output, null if writing to memory
+	FArchive* FileWriter;
+
+	// Path of the file output
+	FString FilePath;
+
+	// Names of the open nodes, the stack size gives the indentation
+	TArray<FSLOwlPrefixName> OpenNodes;
+
+	// Indentation depth of the first level nodes
+	int32 BaseDepth;
+
+	// Number of characters already written out to the file
+	int64 NumFlushedChars;
+};
@@ -94,6 +94,47 @@ struct FSLLoggerStartParams
 	FName UserInputActionName = TEXT("SLTrigger");
 };
 
+/* What to do with a new world state frame if the writer buffer is full */
+UENUM()
+enum class ESLWorldStateBackpressurePolicy : uint8
+{
+	Block				UMETA(DisplayName = "Block"),
+	DropOldest			UMETA(DisplayName = "DropOldest"),
+	Coalesce			UMETA(DisplayName = "Coalesce"),
+};
+
+/* How the world state poses are stored in the database documents */
+UENUM()
+enum class ESLWorldStatePoseEncoding : uint8
+{
+	Document			UMETA(DisplayName = "Document"),
+	PackedFloat			UMETA(DisplayName = "PackedFloat"),
+	PackedQuantized		UMETA(DisplayName = "PackedQuantized"),
+};
+
+/* Where the world state frames are written */
+UENUM()
+enum class ESLWorldStateOutput : uint8
+{
+	MongoDB				UMETA(DisplayName = "MongoDB"),
+	EpisodeFile			UMETA(DisplayName = "EpisodeFile"),
+};
+
+/* Min pose difference in order for an individual to be logged */
+USTRUCT()
+struct FSLWorldStatePoseTolerance
+{
+	GENERATED_BODY();
+
+	// Min location difference (cm)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 0))
+	float Linear = 0.5f;
+
+	// Min rotation difference (degrees)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 0, ClampMax = 180))
+	float Angular = 1.f;
+};
+
 /* Holds the data needed to setup the world state logger */
 USTRUCT()
 struct FSLWorldStateLoggerParams
@@ -104,14 +145,50 @@ struct FSLWorldStateLoggerParams
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	float UpdateRate = 0.f;
 
-	// Min difference between poses (FTransform) in order for the individual to be logged
+	// Write the frames to the database, or to a local binary episode file which can be imported into the database afterwards
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	ESLWorldStateOutput Output = ESLWorldStateOutput::MongoDB;
+
+	// Min location and rotation difference in order for the individual to be logged
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
-	float PoseTolerance = 0.5f;
+	FSLWorldStatePoseTolerance PoseTolerance;
+
+	// Pose tolerance overrides for individual classes (e.g. coarse for furniture, fine for hand bones)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	TMap<FString, FSLWorldStatePoseTolerance> ClassPoseTolerances;
 
 	// Write mode, only individuals that moved only (sparse) or all individuals
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bWriteSparse = true;
 
+	// Time (in seconds) between two full keyframes of the sparse writes, bounds the history read by point in time queries (0 only the first frame)
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bWriteSparse", ClampMin = 0))
+	float KeyframeInterval = 10.f;
+
+	// Number of pre-captured frames which can wait to be written to the database
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 1))
+	int32 WriteBufferSize = 32;
+
+	// Block the game thread, drop the oldest pending frame, or replace the newest pending frame when the buffer is full
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	ESLWorldStateBackpressurePolicy BackpressurePolicy = ESLWorldStateBackpressurePolicy::DropOldest;
+
+	// Poses as loc/quat sub-documents per individual, or one binary blob per frame with float32 or quantized poses
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	ESLWorldStatePoseEncoding PoseEncoding = ESLWorldStatePoseEncoding::Document;
+
+	// Accumulate the frame documents and write them with unordered bulk inserts
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bUseBulkWrites = false;
+
+	// Max number of frame documents in a bulk insert
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bUseBulkWrites", ClampMin = 1))
+	int32 BulkMaxFrames = 32;
+
+	// Max time (in seconds) a frame document can wait in the bulk before it is written
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (editcondition = "bUseBulkWrites", ClampMin = 0))
+	float BulkMaxDelay = 1.f;
+
 	// Include individuals metadata 
 	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
 	bool bIncludeMetadata = true;
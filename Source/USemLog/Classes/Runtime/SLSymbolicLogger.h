@@ -9,6 +9,8 @@
 #include "Events/ISLEventHandler.h"
 #include "ROSProlog/SLPrologClient.h"
 #include "Owl/SLOwlExperiment.h"
+#include "Events/SLEventJournal.h"
+#include "Monitors/SLContactMonitorScheduler.h"
 #include "SLSymbolicLogger.generated.h"
 
 // Forward declarations
@@ -39,6 +41,9 @@ protected:
 	// Called when actor removed from game or game ended
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	// Called every frame, runs the contact monitors scheduler and flushes the event journal while the logger is started
+	virtual void Tick(float DeltaTime) override;
+
 public:
 	// Init logger (called when the logger is synced externally)
 	void Init(const FSLSymbolicLoggerParams& InLoggerParameters, const FSLLoggerLocationParams& InLocationParameters);
@@ -153,10 +158,10 @@ private:
 	ASLIndividualManager* IndividualManager;
 
 
-	// Array of finished events
-	TArray<TSharedPtr<ISLEvent>> FinishedEvents;
+	// Finished events written to disk as they arrive, exported to owl when finished
+	FSLEventJournal EventJournal;
 
-	// Owl document of the finished events
+	// Owl document template of the finished events
 	TSharedPtr<FSLOwlExperiment> ExperimentDoc;
 
 	// Semantic event handlers (takes input raw events, outputs finished semantic events)
@@ -165,6 +170,9 @@ private:
 	// List of the contact trigger shapes, stored to call Start and Finish on them
 	TArray<class ISLContactMonitorInterface*> ContactMonitors;
 
+	// Batched supported by checks and delayed overlap end events of all the contact monitors
+	FSLContactMonitorScheduler ContactMonitorScheduler;
+
 	// Cache of the grasp Monitors
 	TArray<class USLReachAndPreGraspMonitor*> ReachAndPreGraspMonitors;
 
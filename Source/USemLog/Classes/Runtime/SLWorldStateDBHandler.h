@@ -5,116 +5,138 @@
 
 #include "CoreMinimal.h"
 #include "Runtime/SLLoggerStructs.h"
-#include "Async/AsyncWork.h"
-#if SL_WITH_LIBMONGO_C
-class ASLVisionPoseableMeshActor;
-THIRD_PARTY_INCLUDES_START
-#if PLATFORM_WINDOWS
-	#include "Windows/AllowWindowsPlatformTypes.h"
-	#include <mongoc/mongoc.h>
-	#include "Windows/HideWindowsPlatformTypes.h"
-#else
-	#include <mongoc/mongoc.h>
-#endif // #if PLATFORM_WINDOWS
-THIRD_PARTY_INCLUDES_END
-#endif //SL_WITH_LIBMONGO_C
+#include "Runtime/SLWorldStateSink.h"
+#include "Runtime/SLWorldStatePoseDiff.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
 
 // Forward declarations
 class ASLIndividualManager;
-class USLBaseIndiviual;
-class USLBoneIndividual;
-class USLVirtualBoneIndividual;
-class USLBoneConstraintIndividual;
+class USLBaseIndividual;
+class FRunnableThread;
 
 /**
- * Async task to write to the database
+ * Sparse write statistics, shows how much the pose tolerances reduce the written data
  */
-class FSLWorldStateDBWriterAsyncTask : public FNonAbandonableTask
+struct FSLWorldStateSparseStats
+{
+	// Number of written keyframes
+	int32 NumKeyframes = 0;
+
+	// Number of checked frames
+	int32 NumFrames = 0;
+
+	// Frames without any entry above the tolerance (no document written)
+	int32 NumSkippedFrames = 0;
+
+	// Number of checked pose entries
+	int64 NumEntries = 0;
+
+	// Entries that moved more than their tolerance
+	int64 NumMoved = 0;
+
+	// Entries that changed but stayed within their tolerance
+	int64 NumSuppressed = 0;
+
+	// Add the result of a frame check
+	void AddFrame(int32 InNumEntries, int32 InNumMoved, int32 InNumSuppressed)
+	{
+		NumFrames++;
+		NumSkippedFrames += InNumMoved == 0 ? 1 : 0;
+		NumEntries += InNumEntries;
+		NumMoved += InNumMoved;
+		NumSuppressed += InNumSuppressed;
+	};
+
+	// Get the statistics as string
+	FString ToString() const
+	{
+		const double Denom = NumEntries > 0 ? (double)NumEntries : 1.0;
+		return FString::Printf(TEXT("keyframes=%d; frames=%d (skipped=%d); entries=%lld; moved=%lld (%.2f%%); suppressed=%lld (%.2f%%); unchanged=%lld;"),
+			NumKeyframes, NumFrames, NumSkippedFrames, NumEntries,
+			NumMoved, NumMoved * 100.0 / Denom,
+			NumSuppressed, NumSuppressed * 100.0 / Denom,
+			NumEntries - NumMoved - NumSuppressed);
+	};
+};
+
+/**
+ * Writer thread, drains the pre-captured frames from the buffer, selects the poses to write and passes them to the sink
+ */
+class FSLWorldStateDBWriter : public FRunnable
 {
 public:
-#if SL_WITH_LIBMONGO_C
-	// Set the individuals
-	bool Init(mongoc_collection_t* in_collection, ASLIndividualManager* Manager, float PoseTolerance, bool bInWriteSparse);
-#endif //SL_WITH_LIBMONGO_C	
+	// Ctor
+	FSLWorldStateDBWriter();
 
-	// Do the db writing here
-	void DoWork();
+	// Set the output, the frame source and the frame layout
+	bool Setup(ISLWorldStateSink* InSink, FSLWorldStateFrameBuffer* InFrameBuffer, int32 InNumPoses,
+		const FSLWorldStatePoseTolerances& InTolerances, const FSLWorldStateLoggerParams& InParams);
 
-	// Needed internally
-	FORCEINLINE TStatId GetStatId() const { RETURN_QUICK_DECLARE_CYCLE_STAT(FAnalyzeMaterialTreeAsyncTask, STATGROUP_ThreadPoolAsyncTasks); }
+	// Drain the buffer until stopped
+	virtual uint32 Run() override;
 
-	// Set the simulation time
-	void SetTimestamp(float InTs) { Timestamp = InTs; };
+	// Request the thread to write the remaining frames and exit
+	virtual void Stop() override;
 
 private:
+	// Write all pending frames
+	void DrainFrameBuffer();
+
 	// First write where all the individuals are written irregardresly of their previous position
-	int32 FirstWrite();
+	int32 FirstWrite(const FSLWorldStateFrame& Frame);
+
+	// Write all individuals as a keyframe, the following sparse writes are deltas to it
+	int32 WriteKeyframe(const FSLWorldStateFrame& Frame);
 
 	// Write sparse (only individuals that moved)
-	int32 WriteSparse();
+	int32 WriteSparse(const FSLWorldStateFrame& Frame);
 
 	// Write all individuals (event if they did not move)
-	int32 WriteAll();
-
-#if SL_WITH_LIBMONGO_C
-	// Add timestamp to the bson doc
-	void AddTimestamp(bson_t* doc);
-
-	// Add all individuals (return the number of individuals added)
-	int32 AddAllIndividuals(bson_t* doc);
-
-	// Add only the individuals that moved (return the number of individuals added)
-	int32 AddIndividualsThatMoved(bson_t* doc);
-
-	// Add skeletal individuals (return the number of individuals added)
-	int32 AddSkeletalIndividals(bson_t* doc);
-
-	// Add skeletal bones to the document
-	void AddSkeletalBoneIndividuals(const TArray<USLBoneIndividual*>& BoneIndividuals,
-		const TArray<USLVirtualBoneIndividual*>& VirtualBoneIndividuals,
-		bson_t* doc);
+	int32 WriteAll(const FSLWorldStateFrame& Frame);
 
-	// Add skeletal bone constraints to the document
-	void AddSkeletalConstraintIndividuals(const TArray<USLBoneConstraintIndividual*>& ConstraintIndividuals,
-		bson_t* doc);
+private:
+	// Write function pointers
+	typedef int32 (FSLWorldStateDBWriter::*WriteTypeFunctionPtr)(const FSLWorldStateFrame&);
+	WriteTypeFunctionPtr WriteFunctionPtr;
 
-	// Add robot individuals (return the number of individuals added)
-	int32 AddRobotIndividuals(bson_t* doc);
+	// Output of the frames
+	ISLWorldStateSink* Sink;
 
-	// Add pose document
-	void AddPose(FTransform Pose, bson_t* doc);
+	// Source of the captured frames
+	FSLWorldStateFrameBuffer* FrameBuffer;
 
-	// Write the bson doc to the collection
-	bool UploadDoc(bson_t* doc);
-#endif //SL_WITH_LIBMONGO_C
+	// Frame currently being written (swapped with the buffer slots)
+	FSLWorldStateFrame CurrFrame;
 
+	// Poses of the last written frame (used for the sparse writes)
+	FSLWorldStateFrame LastWrittenFrame;
 
-private:
-	// DoWork function pointers
-	typedef int32 (FSLWorldStateDBWriterAsyncTask::*WriteTypeFunctionPtr)();
-	WriteTypeFunctionPtr WriteFunctionPtr;
+	// Indexes of the poses that moved in the current frame (sorted)
+	TArray<int32> MovedIdxs;
 
-	// Access to the individual manager
-	ASLIndividualManager* IndividualManager;
+	// Min pose difference of every entry
+	FSLWorldStatePoseTolerances Tolerances;
 
-	// The timestamp to write to the collection
-	float Timestamp;
-
-	// Pose diff tolerance
-	float MinPoseDiff;
+	// Tolerance based suppression statistics
+	FSLWorldStateSparseStats SparseStats;
 
 	// Write mode
 	bool bWriteSparse;
 
-#if SL_WITH_LIBMONGO_C
-	// Database collection
-	mongoc_collection_t* mongo_collection;
-#endif //SL_WITH_LIBMONGO_C	
+	// Time between two keyframes of the sparse writes (0 only the first frame)
+	float KeyframeInterval;
+
+	// Timestamp of the last written keyframe
+	float LastKeyframeTs;
+
+	// Set when the thread should exit
+	FThreadSafeBool bStopRequested;
 };
 
 
 /**
- * Helper class for connecting and writing to the database
+ * Helper class for setting up the world state output and its async writer
  */
 class FSLWorldStateDBHandler
 {
@@ -125,63 +147,59 @@ public:
 	// Dtor
 	~FSLWorldStateDBHandler();
 
-	// Connect to the db and set up the async writer
+	// Open the output (database or episode file) and set up the async writer
 	bool Init(ASLIndividualManager* IndividualManager,
 		const FSLWorldStateLoggerParams& InLoggerParameters,
 		const FSLLoggerLocationParams& InLocationParameters,
 		const FSLLoggerDBServerParams& InDBServerParameters);
 
-	// Delegate first job to the async task
-	void FirstWrite(float Timestamp);
+	// Individuals whose poses are expected in the frames, in order
+	const TArray<USLBaseIndividual*>& GetCaptureIndividuals() const { return CaptureIndividuals; };
 
-	// Delegate job to the async task (true if the previous job was done)
-	bool Write(float Timestamp);
+	// Pass the first captured frame to the writer (InOutFrame receives a recycled frame)
+	void FirstWrite(FSLWorldStateFrame& InOutFrame);
 
-	// Disconnect from db, clear task
+	// Pass the captured frame to the writer, InOutFrame receives a recycled frame (false if a pending frame had to be dropped)
+	bool Write(FSLWorldStateFrame& InOutFrame);
+
+	// Write the remaining frames, stop the writer and close the output
 	void Finish();
 
 private:
-	// Connect to the database
-	bool Connect(const FString& DBName, const FString& CollName, const FString& ServerIp,
-		uint16 ServerPort, bool bOverwrite);
-
-	// Write metadata
-	bool WriteMetadata(ASLIndividualManager* IndividualManager, const FString& MetaCollName, bool bOverwrite);
+	// Create and initialize the output set in the parameters
+	ISLWorldStateSink* CreateSink(ASLIndividualManager* IndividualManager,
+		const FSLWorldStateLoggerParams& InLoggerParameters,
+		const FSLLoggerLocationParams& InLocationParameters,
+		const FSLLoggerDBServerParams& InDBServerParameters) const;
 
-#if SL_WITH_LIBMONGO_C
-	int32 AddIndividualsMetadata(ASLIndividualManager* IndividualManager, bson_t* doc);
-#endif //SL_WITH_LIBMONGO_C	
+	// Cache the individuals to capture and their frame layout
+	void SetCaptureLayout(ASLIndividualManager* IndividualManager, FSLWorldStateLayout& OutLayout);
 
-	// Disconnect and clean db connection
-	void Disconnect() const;
+	// Resolve the pose tolerance of every captured individual (class overrides or the default)
+	void SetPoseTolerances(const FSLWorldStateLoggerParams& InLoggerParameters, FSLWorldStatePoseTolerances& OutTolerances) const;
 
-	// Create indexes on the inserted data
-	bool CreateIndexes() const;
+	// Close and delete the output
+	void DestroySink();
 
 private:
-	// True if connected to the db
+	// True if the writer is running
 	bool bIsInit;
 
 	// Pointers are reset
 	bool bIsFinished;
 
-	// Call time of the previous writing task
-	double PrevWriteCallTime;
-
-	// Async writing to the database
-	FAsyncTask<FSLWorldStateDBWriterAsyncTask>* DBWriterTask;
+	// Individuals whose poses are captured every frame (skeletal blocks first, then the rest of the manager individuals)
+	TArray<USLBaseIndividual*> CaptureIndividuals;
 
-#if SL_WITH_LIBMONGO_C
-	// Server uri
-	mongoc_uri_t* uri;
+	// Frames waiting to be written
+	FSLWorldStateFrameBuffer FrameBuffer;
 
-	// MongoC connection client
-	mongoc_client_t* client;
+	// Output of the frames
+	ISLWorldStateSink* Sink;
 
-	// Database to access
-	mongoc_database_t* database;
+	// Writes the frames to the output
+	FSLWorldStateDBWriter* DBWriter;
 
-	// Database collection
-	mongoc_collection_t* collection;
-#endif //SL_WITH_LIBMONGO_C	
-};
+	// Thread running the writer
+	FRunnableThread* DBWriterThread;
+};
\ No newline at end of file
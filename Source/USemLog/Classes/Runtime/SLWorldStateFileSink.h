@@ -0,0 +1,161 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLLoggerStructs.h"
+#include "Runtime/SLWorldStateSink.h"
+
+// Forward declarations
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Frame entry of the episode file index footer
+ */
+struct FSLWorldStateFileIndexEntry
+{
+	// Frame timestamp
+	double Timestamp = 0.0;
+
+	// Offset of the frame record in the file
+	uint64 Offset = 0;
+
+	// 1 if the frame is a keyframe
+	uint32 bKeyframe = 0;
+
+	// Padding
+	uint32 Reserved = 0;
+};
+
+/**
+ * Append-only binary episode file:
+ * [header][layout][frame records: ts, keyframe flag, packed pose blob][frame index][index offset, num frames, magic],
+ * the pose blobs use the packed world state encoding, the index footer is rebuilt by scanning if missing
+ */
+class FSLWorldStateFileSink : public ISLWorldStateSink
+{
+public:
+	// Ctor
+	FSLWorldStateFileSink();
+
+	// Dtor
+	virtual ~FSLWorldStateFileSink();
+
+	// Create the episode file
+	bool Init(const FSLWorldStateLoggerParams& InLoggerParameters, const FSLLoggerLocationParams& InLocationParameters);
+
+	// Default episode file path of the task and episode
+	static FString GetEpisodeFilePath(const FString& TaskId, const FString& EpisodeId);
+
+	/* Begin ISLWorldStateSink interface */
+	virtual bool Open(const FSLWorldStateLayout& InLayout) override;
+	virtual int32 WriteFrame(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs) override;
+	virtual void Flush(bool bForce) override;
+	virtual void Close() override;
+	/* End ISLWorldStateSink interface */
+
+private:
+	// Write the buffered bytes to disk
+	bool WriteOut();
+
+private:
+	// Path of the episode file
+	FString FilePath;
+
+	// Open file handle
+	IFileHandle* FileHandle;
+
+	// True if a write failed, the file is closed and incomplete
+	bool bWriteFailed;
+
+	// Packed pose encoding of the frames
+	ESLWorldStatePoseEncoding PoseEncoding;
+
+	// Frame layout
+	FSLWorldStateLayout Layout;
+
+	// Bytes waiting to be written to disk
+	TArray<uint8> WriteBuffer;
+
+	// Bytes already written to disk
+	uint64 NumWrittenBytes;
+
+	// Frame index (written as footer)
+	TArray<FSLWorldStateFileIndexEntry> FrameIndex;
+
+	// Indexes of the poses packed in the current frame (sorted)
+	TArray<int32> PackedIdxs;
+
+	// Binary blob of the current frame
+	TArray<uint8> PackedData;
+
+	// Number of keyframes
+	int32 NumKeyframes;
+};
+
+/**
+ * Memory mapped reader of the binary episode files, can bulk import the episode into MongoDB
+ */
+class FSLWorldStateEpisodeFileReader
+{
+public:
+	// Ctor
+	FSLWorldStateEpisodeFileReader();
+
+	// Dtor
+	~FSLWorldStateEpisodeFileReader();
+
+	// Map the file and read its layout and frame index
+	bool Open(const FString& InFilePath);
+
+	// Unmap the file
+	void Close();
+
+	// Frame layout of the episode
+	const FSLWorldStateLayout& GetLayout() const { return Layout; };
+
+	// Number of frames in the episode
+	int32 NumFrames() const { return FrameIndex.Num(); };
+
+	// Frame index entries
+	const TArray<FSLWorldStateFileIndexEntry>& GetFrameIndex() const { return FrameIndex; };
+
+	// Decode the poses of the frame (false if the record is invalid)
+	bool GetFrame(int32 FrameIdx, TArray<int32>& OutIdxs, TArray<FTransform>& OutPoses) const;
+
+	// Write the episode file as a world state collection (bulk inserts)
+	static bool ImportToMongo(const FString& InFilePath,
+		const FSLWorldStateLoggerParams& InLoggerParameters,
+		const FSLLoggerLocationParams& InLocationParameters,
+		const FSLLoggerDBServerParams& InDBServerParameters);
+
+private:
+	// Read the layout from the header
+	bool ReadLayout(int64& OutFramesOffset);
+
+	// Read the index footer, or rebuild it by scanning the records
+	bool ReadFrameIndex(int64 FramesOffset);
+
+private:
+	// Mapped file
+	IMappedFileHandle* MappedHandle;
+
+	// Mapped region of the whole file
+	IMappedFileRegion* MappedRegion;
+
+	// File content if it cannot be mapped
+	TArray<uint8> FallbackData;
+
+	// Start and size of the file data
+	const uint8* Data;
+	int64 Size;
+
+	// Frame layout
+	FSLWorldStateLayout Layout;
+
+	// Frame index
+	TArray<FSLWorldStateFileIndexEntry> FrameIndex;
+};
@@ -0,0 +1,187 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLLoggerStructs.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+
+// Forward declarations
+class FEvent;
+
+/**
+ * Poses of the logged individuals captured on the game thread at a given time,
+ * stored as structure of arrays so the writer never has to touch the individual objects
+ */
+struct FSLWorldStateFrame
+{
+	// Simulation time of the capture
+	float Timestamp = 0.f;
+
+	// Locations as [x y z] per entry (same order as the writer capture list)
+	TArray<float> Locations;
+
+	// Rotations as [x y z w] per entry
+	TArray<float> Quats;
+
+	// Number of poses in the frame
+	FORCEINLINE int32 Num() const { return Quats.Num() / 4; };
+
+	// Resize the pose arrays (keeps the allocations)
+	void SetNum(int32 InNum)
+	{
+		Locations.SetNumUninitialized(InNum * 3, false);
+		Quats.SetNumUninitialized(InNum * 4, false);
+	};
+
+	// Write the pose entry
+	FORCEINLINE void SetPose(int32 Idx, const FTransform& Pose)
+	{
+		const FVector Loc = Pose.GetLocation();
+		const FQuat Quat = Pose.GetRotation();
+		float* LocPtr = Locations.GetData() + Idx * 3;
+		float* QuatPtr = Quats.GetData() + Idx * 4;
+		LocPtr[0] = Loc.X; LocPtr[1] = Loc.Y; LocPtr[2] = Loc.Z;
+		QuatPtr[0] = Quat.X; QuatPtr[1] = Quat.Y; QuatPtr[2] = Quat.Z; QuatPtr[3] = Quat.W;
+	};
+
+	// Copy the pose entry from another frame with the same layout
+	FORCEINLINE void CopyPose(int32 Idx, const FSLWorldStateFrame& Other)
+	{
+		FMemory::Memcpy(Locations.GetData() + Idx * 3, Other.Locations.GetData() + Idx * 3, 3 * sizeof(float));
+		FMemory::Memcpy(Quats.GetData() + Idx * 4, Other.Quats.GetData() + Idx * 4, 4 * sizeof(float));
+	};
+
+	// Read the pose entry
+	FORCEINLINE FTransform GetPose(int32 Idx) const
+	{
+		const float* LocPtr = Locations.GetData() + Idx * 3;
+		const float* QuatPtr = Quats.GetData() + Idx * 4;
+		return FTransform(FQuat(QuatPtr[0], QuatPtr[1], QuatPtr[2], QuatPtr[3]), FVector(LocPtr[0], LocPtr[1], LocPtr[2]));
+	};
+};
+
+/**
+ * Individual ids converted once to null terminated UTF-8 strings, addressed by their index in the frame
+ */
+struct FSLWorldStateIdTable
+{
+	// Append the id (returns its index)
+	int32 Add(const FString& Id)
+	{
+		FTCHARToUTF8 Converter(*Id);
+		Offsets.Add(Chars.Num());
+		Chars.Append((const ANSICHAR*)Converter.Get(), Converter.Length());
+		Chars.Add('\0');
+		return Offsets.Num() - 1;
+	};
+
+	// Get the UTF-8 id at the given index
+	FORCEINLINE const char* Get(int32 Idx) const { return Chars.GetData() + Offsets[Idx]; };
+
+	// Number of ids
+	FORCEINLINE int32 Num() const { return Offsets.Num(); };
+
+	// Remove all ids
+	void Empty() { Chars.Empty(); Offsets.Empty(); };
+
+private:
+	// All ids back to back
+	TArray<ANSICHAR> Chars;
+
+	// Start of every id in the chars array
+	TArray<int32> Offsets;
+};
+
+/**
+ * Frame statistics shared between the game thread and the writer thread
+ */
+struct FSLWorldStateFrameCounters
+{
+	// Frames captured on the game thread
+	FThreadSafeCounter Captured;
+
+	// Frames processed by the writer
+	FThreadSafeCounter Written;
+
+	// Frames removed from the buffer before being written
+	FThreadSafeCounter Dropped;
+
+	// Frames that replaced a pending one (also counted as dropped)
+	FThreadSafeCounter Coalesced;
+
+	// Times the game thread had to wait for a free slot
+	FThreadSafeCounter Blocked;
+};
+
+/**
+ * Bounded ring of pre-captured frames, filled by the game thread and drained by the db writer thread,
+ * frames are swapped in and out of the slots so their pose arrays are reused without reallocations
+ */
+class FSLWorldStateFrameBuffer
+{
+public:
+	// Ctor
+	FSLWorldStateFrameBuffer();
+
+	// Dtor
+	~FSLWorldStateFrameBuffer();
+
+	// Allocate the slots and set the full buffer policy
+	void Init(int32 InCapacity, ESLWorldStateBackpressurePolicy InPolicy);
+
+	// Swap the frame into the buffer, InOutFrame receives the recycled slot data (false if a pending frame was dropped)
+	bool Enqueue(FSLWorldStateFrame& InOutFrame);
+
+	// Swap the oldest pending frame out of the buffer (false if empty)
+	bool Dequeue(FSLWorldStateFrame& OutFrame);
+
+	// Wait until new frames are available or the timeout expires (true if triggered)
+	bool WaitForData(uint32 WaitTimeMs);
+
+	// Unblock any waiting producer or consumer, blocking enqueues will drop frames from now on
+	void Release();
+
+	// Number of pending frames
+	int32 Num() const;
+
+	// Access to the frame statistics
+	FSLWorldStateFrameCounters& GetCounters() { return Counters; };
+
+	// Get the statistics as string
+	FString GetCountersString() const;
+
+private:
+	// Pre-allocated frame slots
+	TArray<FSLWorldStateFrame> Slots;
+
+	// Next slot to write to
+	int32 Head;
+
+	// Next slot to read from
+	int32 Tail;
+
+	// Number of pending frames
+	int32 Count;
+
+	// What to do when the buffer is full
+	ESLWorldStateBackpressurePolicy Policy;
+
+	// Guards the slots and the indexes
+	mutable FCriticalSection SlotsLock;
+
+	// Triggered on every new frame
+	FEvent* DataAvailableEvent;
+
+	// Triggered on every removed frame
+	FEvent* SpaceAvailableEvent;
+
+	// Set when the consumer is gone, avoids blocking the game thread indefinitely
+	FThreadSafeBool bIsReleased;
+
+	// Frame statistics
+	FSLWorldStateFrameCounters Counters;
+};
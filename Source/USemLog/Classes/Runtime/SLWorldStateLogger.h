@@ -11,6 +11,7 @@
 
 // Forward declarations
 class ASLIndividualManager;
+class USLBaseIndividual;
 
 /**
  * Subsymbolic data logger
@@ -84,6 +85,12 @@ private:
 	// Get the reference or spawn a new initialized individual manager
 	bool SetIndividualManager();
 
+	// Resolve the components the individual poses are read from
+	void SetCaptureSources();
+
+	// Read the current poses of the individuals into the frame
+	void CaptureFrame();
+
 	// First update call (log all individuals)
 	void FirstUpdate();
 
@@ -130,4 +137,17 @@ private:
 
 	// Database handler
 	TSharedPtr<FSLWorldStateDBHandler> DBHandler;
+
+	/* Pose capture */
+	// Component to read the pose from (actor root or skeletal mesh), nullptr if the individual has to compute it
+	TArray<USceneComponent*> CaptureComponents;
+
+	// Bone to read from the skeletal mesh component, INDEX_NONE for the component transform
+	TArray<int32> CaptureBoneIndexes;
+
+	// Individuals in the capture order (used for the entries without a component)
+	TArray<USLBaseIndividual*> CaptureIndividuals;
+
+	// Frame filled every update, swapped with a recycled frame from the writer
+	FSLWorldStateFrame CurrFrame;
 };
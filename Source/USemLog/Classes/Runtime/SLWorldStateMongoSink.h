@@ -0,0 +1,202 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLLoggerStructs.h"
+#include "Runtime/SLWorldStateSink.h"
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+#else
+	#include <mongoc/mongoc.h>
+#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+#endif //SL_WITH_LIBMONGO_C
+
+// Forward declarations
+class ASLIndividualManager;
+
+/**
+ * Bulk insert statistics, used for tuning the batch size against the database deployment
+ */
+struct FSLWorldStateBulkStats
+{
+	// Number of executed bulk inserts
+	int32 NumBatches = 0;
+
+	// Number of documents written through bulk inserts
+	int32 NumDocs = 0;
+
+	// Largest number of documents in a bulk insert
+	int32 MaxDocs = 0;
+
+	// Total size of the written documents
+	int64 NumBytes = 0;
+
+	// Summed, min and max duration of executing a bulk insert (in seconds)
+	double TotalLatency = 0.0;
+	double MinLatency = BIG_NUMBER;
+	double MaxLatency = 0.0;
+
+	// Number of failed bulk inserts
+	int32 NumErrors = 0;
+
+	// Add the result of a bulk insert
+	void AddBatch(int32 InNumDocs, int64 InNumBytes, double Latency)
+	{
+		NumBatches++;
+		NumDocs += InNumDocs;
+		MaxDocs = FMath::Max(MaxDocs, InNumDocs);
+		NumBytes += InNumBytes;
+		TotalLatency += Latency;
+		MinLatency = FMath::Min(MinLatency, Latency);
+		MaxLatency = FMath::Max(MaxLatency, Latency);
+	};
+
+	// Get the statistics as string
+	FString ToString() const
+	{
+		if (NumBatches == 0)
+		{
+			return FString::Printf(TEXT("batches=0; errors=%d;"), NumErrors);
+		}
+		return FString::Printf(TEXT("batches=%d; errors=%d; docs=%d (avg=%.2f, max=%d); kb=%.2f (avg=%.2f); latency[s] avg=%f min=%f max=%f;"),
+			NumBatches, NumErrors, NumDocs, (float)NumDocs / NumBatches, MaxDocs,
+			NumBytes / 1024.0, NumBytes / 1024.0 / NumBatches,
+			TotalLatency / NumBatches, MinLatency, MaxLatency);
+	};
+};
+
+/**
+ * Writes the world state frames as documents of a MongoDB episode collection
+ */
+class FSLWorldStateMongoSink : public ISLWorldStateSink
+{
+public:
+	// Ctor
+	FSLWorldStateMongoSink();
+
+	// Dtor
+	virtual ~FSLWorldStateMongoSink();
+
+	// Connect to the database and write the metadata (skipped if the individual manager is null)
+	bool Init(ASLIndividualManager* IndividualManager,
+		const FSLWorldStateLoggerParams& InLoggerParameters,
+		const FSLLoggerLocationParams& InLocationParameters,
+		const FSLLoggerDBServerParams& InDBServerParameters);
+
+	/* Begin ISLWorldStateSink interface */
+	virtual bool Open(const FSLWorldStateLayout& InLayout) override;
+	virtual int32 WriteFrame(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs) override;
+	virtual void Flush(bool bForce) override;
+	virtual uint32 GetFlushWaitTimeMs() const override;
+	virtual void Close() override;
+	/* End ISLWorldStateSink interface */
+
+private:
+	// Connect to the database
+	bool Connect(const FString& DBName, const FString& CollName, const FString& ServerIp,
+		uint16 ServerPort, bool bOverwrite);
+
+	// Write metadata
+	bool WriteMetadata(ASLIndividualManager* IndividualManager, const FString& MetaCollName, bool bOverwrite);
+
+	// Write the ids and the skeletal layout needed to decode the packed poses
+	bool WritePoseTable();
+
+	// Disconnect and clean db connection
+	void Disconnect();
+
+	// Create indexes on the inserted data
+	bool CreateIndexes() const;
+
+#if SL_WITH_LIBMONGO_C
+	int32 AddIndividualsMetadata(ASLIndividualManager* IndividualManager, bson_t* doc);
+
+	// Add timestamp to the bson doc
+	void AddTimestamp(float Timestamp, bson_t* doc);
+
+	// Add all individuals (return the number of individuals added)
+	int32 AddAllIndividuals(const FSLWorldStateFrame& Frame, bson_t* doc);
+
+	// Add only the individuals that moved since the last written frame (return the number of individuals added)
+	int32 AddIndividualsThatMoved(const FSLWorldStateFrame& Frame, const TArray<int32>& MovedIdxs, bson_t* doc);
+
+	// Add skeletal individuals, if MovedIdxs is set only the ones with a moved block entry (return the number of individuals added)
+	int32 AddSkeletalIndividals(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs, bson_t* doc);
+
+	// Add skeletal bones to the document
+	void AddSkeletalBoneIndividuals(const FSLWorldStateFrame& Frame, const FSLWorldStateSkeletalLayout& Layout, bson_t* doc);
+
+	// Add pose document
+	void AddPose(FTransform Pose, bson_t* doc);
+
+	// Add all or only the moved poses as one binary blob, moved skeletal blocks are added whole (return the number of poses added)
+	int32 AddPackedPoses(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs, bson_t* doc);
+
+	// Write the bson doc to the collection (or add it to the current bulk insert)
+	bool UploadDoc(bson_t* doc);
+
+	// Write the accumulated documents with one unordered bulk insert
+	bool ExecuteBulk();
+#endif //SL_WITH_LIBMONGO_C
+
+private:
+	// True if connected to the db
+	bool bIsInit;
+
+	// Frame layout
+	FSLWorldStateLayout Layout;
+
+	// How the poses are stored in the documents
+	ESLWorldStatePoseEncoding PoseEncoding;
+
+	// Indexes of the poses packed in the current document (sorted)
+	TArray<int32> PackedIdxs;
+
+	// Binary blob of the current document
+	TArray<uint8> PackedData;
+
+	// Write the documents with bulk inserts
+	bool bUseBulkWrites;
+
+	// Max documents in a bulk
+	int32 BulkMaxFrames;
+
+	// Max wait time of a document in the bulk
+	float BulkMaxDelay;
+
+	// Number of documents in the current bulk
+	int32 BulkNumDocs;
+
+	// Size of the documents in the current bulk
+	int64 BulkNumBytes;
+
+	// Time when the first document was added to the current bulk
+	double BulkStartTime;
+
+	// Bulk insert statistics
+	FSLWorldStateBulkStats BulkStats;
+
+#if SL_WITH_LIBMONGO_C
+	// Server uri
+	mongoc_uri_t* uri;
+
+	// MongoC connection client
+	mongoc_client_t* client;
+
+	// Database to access
+	mongoc_database_t* database;
+
+	// Database collection
+	mongoc_collection_t* collection;
+
+	// Current bulk insert (nullptr if empty)
+	mongoc_bulk_operation_t* mongo_bulk;
+#endif //SL_WITH_LIBMONGO_C
+};
@@ -0,0 +1,50 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLLoggerStructs.h"
+
+// Forward declarations
+struct FSLWorldStateFrame;
+
+/**
+ * Packs frame poses into a single binary blob for the packed world state encodings:
+ * [uint8 encoding][uint8 index size][uint16 reserved][uint32 num][sorted pose indexes][poses],
+ * poses are stored in engine units and coordinates (no ROS conversion)
+ */
+struct FSLWorldStatePoseCodec
+{
+	// Size of the blob header in bytes
+	static constexpr int32 HeaderSize = 8;
+
+	// Steps per cm of the quantized locations (0.01 cm resolution, +-214 km range)
+	static constexpr float LocQuantization = 100.f;
+
+	// Steps per unit of the quantized quaternion components
+	static constexpr float QuatQuantization = 32767.f;
+
+	// Pack the (sorted) frame entries, returns the blob size in bytes
+	static int32 Encode(const FSLWorldStateFrame& Frame, const TArray<int32>& SortedIdxs,
+		ESLWorldStatePoseEncoding Encoding, TArray<uint8>& OutData);
+
+	// Unpack all entries of the blob (false if the blob is invalid)
+	static bool Decode(const uint8* Data, uint32 Len, TArray<int32>& OutIdxs, TArray<FTransform>& OutPoses);
+
+	// Unpack the pose of the given entry (false if it is not in the blob)
+	static bool FindPose(const uint8* Data, uint32 Len, int32 PoseIdx, FTransform& OutPose);
+
+	// Size of a packed pose in bytes
+	static int32 GetPoseSize(ESLWorldStatePoseEncoding Encoding);
+
+private:
+	// Read and validate the blob header
+	static bool ReadHeader(const uint8* Data, uint32 Len, ESLWorldStatePoseEncoding& OutEncoding, int32& OutNum, int32& OutIdxSize);
+
+	// Read the pose index stored in the given slot
+	static int32 ReadIdx(const uint8* IdxData, int32 IdxSize, int32 Slot);
+
+	// Read the pose stored in the given slot
+	static FTransform ReadPose(const uint8* PoseData, ESLWorldStatePoseEncoding Encoding, int32 Slot);
+};
@@ -0,0 +1,46 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Per entry tolerances in the form used by the movement check
+ */
+struct FSLWorldStatePoseTolerances
+{
+	// Squared min location difference
+	TArray<float> LinearSq;
+
+	// Cosine of the half min rotation difference
+	TArray<float> CosHalfAngular;
+
+	// Append the tolerance of an entry (cm and degrees)
+	void Add(float Linear, float AngularDeg)
+	{
+		LinearSq.Add(Linear * Linear);
+		CosHalfAngular.Add(FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(AngularDeg, 0.f, 180.f)) * 0.5f));
+	};
+
+	// Number of entries
+	int32 Num() const { return LinearSq.Num(); };
+};
+
+/**
+ * Batched movement check (four entries per vector, one component per register) between two pose buffers
+ * stored as [x y z] locations and [x y z w] quaternions,
+ * replaces the per individual FTransform::Equals calls of the sparse world state writes
+ */
+struct FSLWorldStatePoseDiff
+{
+	// Append the indexes from [Begin, End) whose location or rotation difference is larger than their tolerance,
+	// OutNumSuppressed counts the changed poses that stayed within the tolerance, returns the number of appended indexes
+	static int32 FindMoved(const float* RefLocs, const float* RefQuats,
+		const float* CurrLocs, const float* CurrQuats,
+		const FSLWorldStatePoseTolerances& Tolerances, int32 Begin, int32 End,
+		TArray<int32>& OutMovedIdxs, int32& OutNumSuppressed);
+
+	// True if any (sorted) moved index is inside [Begin, End)
+	static bool AnyMovedInRange(const TArray<int32>& SortedMovedIdxs, int32 Begin, int32 End);
+};
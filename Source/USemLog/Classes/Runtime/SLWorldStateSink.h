@@ -0,0 +1,114 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/SLWorldStateFrameBuffer.h"
+
+/**
+ * Indexes of a skeletal individual and its bones in the captured frame
+ */
+struct FSLWorldStateSkeletalLayout
+{
+	// Index of the skeletal individual pose in the frame
+	int32 PoseIdx = INDEX_NONE;
+
+	// Indexes of the bone and virtual bone poses in the frame
+	TArray<int32> BonePoseIdxs;
+
+	// Skeleton bone index of every entry from BonePoseIdxs
+	TArray<int32> BoneIndexes;
+
+	// Contiguous range [BlockBegin, BlockEnd) of the individual and its bones in the frame
+	int32 BlockBegin = INDEX_NONE;
+	int32 BlockEnd = INDEX_NONE;
+};
+
+/**
+ * What every captured frame contains, shared by the writer and the sinks
+ */
+struct FSLWorldStateLayout
+{
+	// UTF-8 ids of the individuals (same order as the poses)
+	FSLWorldStateIdTable Ids;
+
+	// Marks the entries written in the individuals array (the rest are only referenced by the skeletal layouts)
+	TBitArray<> ListedMask;
+
+	// Skeletal individuals layout (blocks at the start of the frame, in increasing order)
+	TArray<FSLWorldStateSkeletalLayout> SkeletalLayouts;
+
+	// Number of poses in a frame
+	int32 Num() const { return Ids.Num(); };
+
+	// Get the pose indexes to write, all if MovedIdxs is null, otherwise the moved ones with their skeletal blocks added whole
+	void GetWrittenIdxs(const TArray<int32>* MovedIdxs, TArray<int32>& OutIdxs) const
+	{
+		OutIdxs.Reset();
+		if (MovedIdxs == nullptr)
+		{
+			OutIdxs.Reserve(Num());
+			for (int32 Idx = 0; Idx < Num(); ++Idx)
+			{
+				OutIdxs.Add(Idx);
+			}
+			return;
+		}
+
+		// Walk the (sorted) moved indexes together with the skeletal blocks
+		int32 LayoutIdx = 0;
+		int32 NextFreeIdx = 0;
+		for (const int32 Idx : *MovedIdxs)
+		{
+			if (Idx < NextFreeIdx)
+			{
+				continue;
+			}
+			while (SkeletalLayouts.IsValidIndex(LayoutIdx) && SkeletalLayouts[LayoutIdx].BlockEnd <= Idx)
+			{
+				LayoutIdx++;
+			}
+			if (SkeletalLayouts.IsValidIndex(LayoutIdx) && SkeletalLayouts[LayoutIdx].BlockBegin <= Idx)
+			{
+				// Readers get the complete skeleton from a single frame
+				const FSLWorldStateSkeletalLayout& Layout = SkeletalLayouts[LayoutIdx];
+				for (int32 BlockIdx = Layout.BlockBegin; BlockIdx < Layout.BlockEnd; ++BlockIdx)
+				{
+					OutIdxs.Add(BlockIdx);
+				}
+				NextFreeIdx = Layout.BlockEnd;
+			}
+			else
+			{
+				OutIdxs.Add(Idx);
+			}
+		}
+	};
+};
+
+/**
+ * Output of the world state writer (database, episode file, ..),
+ * opened and closed on the game thread, written from the writer thread
+ */
+class ISLWorldStateSink
+{
+public:
+	// Virtual dtor
+	virtual ~ISLWorldStateSink() {};
+
+	// Prepare the output for frames with the given layout
+	virtual bool Open(const FSLWorldStateLayout& InLayout) = 0;
+
+	// Write the frame, all poses if MovedIdxs is null (keyframe) otherwise only the (sorted) moved ones, returns the number of written entries
+	virtual int32 WriteFrame(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs) = 0;
+
+	// Called after every frame and when the writer exits (bForce), lets the sink write out its buffered data
+	virtual void Flush(bool bForce) {};
+
+	// Max time the writer should wait between two flush calls
+	virtual uint32 GetFlushWaitTimeMs() const { return 100; };
+
+	// Write the remaining data and close the output (called after the writer exited)
+	virtual void Close() = 0;
+};
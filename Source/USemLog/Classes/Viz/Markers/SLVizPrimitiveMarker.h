@@ -42,14 +42,8 @@ public:
 	//virtual void AddInstances(const TArray<FTransform>& Poses) override;
 
 protected:
-	// Virtual add instance function
-	virtual void AddInstanceChecked(const FTransform& Pose) override;
-
-	// Virtual update instance transform
-	virtual bool UpdateInstanceTransform(int32 Index, const FTransform& Pose) override;
-
-	// Virtual add instances function
-	virtual void AddInstancesChecked(const TArray<FTransform>& Poses) override;
+	// Virtual instance transform of the pose (with the marker scale)
+	virtual FTransform GetInstanceTransform(const FTransform& Pose) const override;
 
 	// Get the static mesh of the primitive type
 	UStaticMesh* GetPrimitiveStaticMesh(ESLVizPrimitiveMarkerType InType) const;
@@ -13,7 +13,8 @@ class USkeletalMesh;
 class UPoseableMeshComponent;
 
 /**
- * Class capable of visualizing skeletal meshes as arrays of poseable meshes
+ * Class capable of visualizing skeletal meshes as arrays of poseable meshes,
+ * the poseable mesh instances are pooled and their number is capped (the poses are skipped with a time stride)
  */
 UCLASS()
 class USEMLOG_API USLVizSkeletalMeshMarker : public USLVizBaseMarker
@@ -49,6 +50,9 @@ public:
 	void AddInstances(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
 		const FSLVizTimelineParams& TimelineParams);
 
+	// Set the maximal number of live poseable mesh instances (the poses above it are skipped using a time stride)
+	void SetMaxNumInstances(int32 InMaxNumInstances) { MaxNumInstances = FMath::Max(InMaxNumInstances, 1); };
+
 	//~ Begin ActorComponent Interface
 	// Unregister the component, remove it from its outer Actor's Components array and mark for pending kill
 	virtual void DestroyComponent(bool bPromoteChildren = false) override;
@@ -78,11 +82,11 @@ protected:
 	// Clear the timeline and the related members
 	void ClearAndStopTimeline();
 
-	// Update timeline with the given number of new instances
+	// Update timeline with the given number of new instances (with a max number of instances the slots are reused as a ring)
 	void UpdateTimeline(int32 NumNewInstances);
 
-	// Update timeline with max number of instances
-	void UpdateTimelineWithMaxNumInstances(int32 NumNewInstances);
+	// Show the timeline pose in its instance slot
+	void ShowTimelineInstance(int32 PoseIndex);
 
 	// Set visual without the materials (avoid boilerplate code)
 	void SetPoseableMeshComponentVisual(USkeletalMesh* SkelMesh);
@@ -90,6 +94,15 @@ protected:
 	// Create poseable mesh component instance attached and registered to this marker
 	UPoseableMeshComponent* CreateNewPoseableMeshInstance();
 
+	// Get a visible poseable mesh instance from the pool, or create a new one
+	UPoseableMeshComponent* AcquirePoseableMeshInstance();
+
+	// Set the world pose and bone poses of the instance
+	void SetInstancePose(UPoseableMeshComponent* PMC, const TPair<FTransform, TMap<int32, FTransform>>& SkeletalPose);
+
+	// Destroy the pooled instances
+	void DestroyPooledInstances();
+
 protected:
 	// Poseable mesh reference
 	UPROPERTY()
@@ -99,6 +112,30 @@ protected:
 	UPROPERTY()
 	TArray<UPoseableMeshComponent*> PMCInstances;
 
+	// Hidden instances ready to be reused
+	UPROPERTY()
+	TArray<UPoseableMeshComponent*> PMCPool;
+
+	// Timeline pose index shown by every instance (INDEX_NONE if not part of the timeline)
+	TArray<int32> InstancePoseIndexes;
+
+	// Instance slot of the first timeline pose
+	int32 TimelineFirstSlot;
+
+	// Instance slot to overwrite next once the max number of instances is reached (ring)
+	int32 NextEvictSlot;
+
+	// Maximal number of live instances
+	int32 MaxNumInstances;
+
+	// Reused buffers of the bone poses
+	TArray<int32> BoneIndexesBuffer;
+	TArray<FTransform> BonePosesBuffer;
+	TArray<FTransform> ComponentSpaceBuffer;
+
 	// Timeline poses
 	TArray<TPair<FTransform, TMap<int32, FTransform>>> TimelinePoses;
+
+	/* Constants */
+	static constexpr int32 DefaultMaxNumInstances = 128;
 };
@@ -65,21 +65,24 @@ protected:
 	// Virtual add instance function
 	virtual void AddInstanceChecked(const FTransform& Pose);
 
-	// Virtual update instance transform
-	virtual bool UpdateInstanceTransform(int32 Index, const FTransform& Pose);
-
 	// Virtual add instances function
 	virtual void AddInstancesChecked(const TArray<FTransform>& Poses);
 
+	// Virtual instance transform of the pose
+	virtual FTransform GetInstanceTransform(const FTransform& Pose) const;
+
+	// Add the poses from the [First, First + Num) range as new instances with a single render state update
+	void AddInstancesChecked(const TArray<FTransform>& Poses, int32 First, int32 Num);
+
+	// Overwrite the timeline ring slots with the poses from the [First, First + Num) range (does not dirty the render state)
+	void UpdateInstancesChecked(const TArray<FTransform>& Poses, int32 First, int32 Num);
+
 	// Clear the timeline and the related members
 	void ClearAndStopTimeline();
 
-	// Update timeline with the given number of new instances
+	// Update timeline with the given number of new instances (with a max number of instances the oldest ones are overwritten)
 	void UpdateTimeline(int32 NumNewInstances);
 
-	// Update timeline with max number of instances
-	void UpdateTimelineWithMaxNumInstances(int32 NumNewInstances);
-
 protected:
 	// A component that efficiently renders multiple instances of the same StaticMesh.
 	UPROPERTY()
@@ -87,4 +90,7 @@ protected:
 
 	// Timeline poses
 	TArray<FTransform> TimelinePoses;
+
+	// Reused buffer of the instance transforms sent to the ISMC in one batch
+	TArray<FTransform> InstanceTransformsBuffer;
 };
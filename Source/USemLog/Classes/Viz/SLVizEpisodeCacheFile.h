@@ -0,0 +1,36 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Forward declarations
+class ASLIndividualManager;
+struct FSLVizEpisodeData;
+
+/**
+ * Persistent cache of the compiled replay episodes:
+ * [header][actor ids][bone ids][static actor ids][16 byte aligned raw arrays of the timestamps, static poses, bindings, keyframes and deltas],
+ * the file is keyed by the task (database) and episode (collection), and stores the hash of the episode content signature,
+ * the slots are stored as individual ids and validated against the current world when loaded
+ */
+struct USEMLOG_API FSLVizEpisodeCacheFile
+{
+public:
+	// Cache file path of the task and episode
+	static FString GetFilePath(const FString& TaskId, const FString& EpisodeId);
+
+	// Write the compiled episode to its cache file
+	static bool Save(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature,
+		const FSLVizEpisodeData& InEpisodeData);
+
+	// Load the compiled episode from its cache file (false if missing, outdated, or not matching the world individuals)
+	static bool Load(ASLIndividualManager* IndividualManager, const FString& TaskId, const FString& EpisodeId,
+		const FString& ContentSignature, FSLVizEpisodeData& OutEpisodeData);
+
+private:
+	// Read the data and rebind its slots to the world (false if not valid)
+	static bool Read(ASLIndividualManager* IndividualManager, const uint8* Data, int64 Size, uint32 ContentHash,
+		FSLVizEpisodeData& OutEpisodeData);
+};
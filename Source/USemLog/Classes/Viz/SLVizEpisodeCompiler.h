@@ -0,0 +1,115 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Mongo/SLMongoEpisodeFrames.h"
+#include "Viz/SLVizEpisodeManager.h"
+
+// Forward declarations
+class ASLIndividualManager;
+
+/**
+ * Compiles the mongo episode frames into the replay episode data in two phases:
+ * Prepare (game thread) resolves every interned id once to its replay slot and reads the initial world poses,
+ * Run / StartAsync (any thread) builds the keyframes and deltas without touching any world object
+ */
+class USEMLOG_API FSLVizEpisodeCompiler
+{
+public:
+	// Ctor
+	FSLVizEpisodeCompiler(const FString& InTaskId, const FString& InEpisodeId, const FString& InContentSignature = FString());
+
+	// Dtor, cancels and waits for any running compilation
+	~FSLVizEpisodeCompiler();
+
+	// Resolve the ids of the frames to the world individuals and read their initial poses (game thread only)
+	bool Prepare(ASLIndividualManager* IndividualManager, FSLMongoEpisodeFrames&& InFrames);
+
+	// Compile the frames on the calling thread (returns false if it failed or was cancelled)
+	bool Run();
+
+	// Compile the frames on the thread pool
+	bool StartAsync();
+
+	// True if the compilation was started in the background
+	bool IsStarted() const { return bStarted; };
+
+	// True if the background compilation finished (successfully or not)
+	bool IsDone() const { return !Future.IsValid() || Future.IsReady(); };
+
+	// Request the compilation to stop, the result will not be valid
+	void Cancel() { bCancelRequested = true; };
+
+	// True if the compilation was asked to stop
+	bool IsCancelled() const { return bCancelRequested; };
+
+	// Progress of the compilation [0, 1]
+	float GetProgress() const;
+
+	// Wait for the compilation and get the episode data (invalid if it failed or was cancelled)
+	FSLVizEpisodeDataPtr GetResult();
+
+	// Task (database) id of the episode
+	const FString& GetTaskId() const { return TaskId; };
+
+	// Episode (collection) id
+	const FString& GetEpisodeId() const { return EpisodeId; };
+
+	// Content signature of the episode when it was queried
+	const FString& GetContentSignature() const { return ContentSignature; };
+
+private:
+	// Build the keyframes and deltas from the frames and the resolved slots
+	bool CompileFrames();
+
+	// Move the actors which keep their pose during the whole episode from the slots to the static actors
+	void PruneStaticActors();
+
+private:
+	// Task (database) id
+	FString TaskId;
+
+	// Episode (collection) id
+	FString EpisodeId;
+
+	// Content signature of the episode
+	FString ContentSignature;
+
+	// Input frames, released after the compilation
+	FSLMongoEpisodeFrames Frames;
+
+	// Actor slot of every interned id (INDEX_NONE if not an actor)
+	TArray<int32> IdxToActorSlot;
+
+	// Bone slot of every interned id (INDEX_NONE if not a bone)
+	TArray<int32> IdxToBoneSlot;
+
+	// Slot poses before the first frame (the current world poses)
+	FSLVizEpisodeFrameData InitialFrame;
+
+	// Episode data being compiled
+	TSharedPtr<FSLVizEpisodeData, ESPMode::ThreadSafe> EpisodeData;
+
+	// Background compilation result
+	TFuture<bool> Future;
+
+	// Number of frames to compile
+	int32 NumTotalFrames;
+
+	// Number of compiled frames (progress)
+	FThreadSafeCounter NumCompiledFrames;
+
+	// Set to stop the compilation
+	FThreadSafeBool bCancelRequested;
+
+	// True if prepared
+	bool bPrepared;
+
+	// True if the background compilation started
+	bool bStarted;
+};
@@ -13,49 +13,300 @@ class UPoseableMeshComponent;
 class APlayerController;
 
 /*
-* Holds the poses of all the individuals in the world
+* Actor and bone slots of an episode, the frame poses are stored by slot index
+*/
+struct FSLVizEpisodeBindings
+{
+	// Actor of every actor slot
+	TArray<AActor*> Actors;
+
+	// Individual id of every actor slot
+	TArray<FString> ActorIds;
+
+	// Skeletal components, their bone slots are stored contiguously
+	TArray<UPoseableMeshComponent*> SkeletalComponents;
+
+	// Bone slots of component i are in [ComponentBoneOffsets[i], ComponentBoneOffsets[i + 1])
+	TArray<int32> ComponentBoneOffsets;
+
+	// Component index of every bone slot
+	TArray<int32> BoneComponents;
+
+	// Bone index of every bone slot
+	TArray<int32> BoneIndexes;
+
+	// Individual id of every bone slot
+	TArray<FString> BoneIds;
+
+	// Actors which do not move during the episode, their pose is applied only once when the episode is loaded
+	TArray<AActor*> StaticActors;
+
+	// Individual id of every static actor
+	TArray<FString> StaticActorIds;
+
+	// Number of actor slots
+	int32 NumActors() const { return Actors.Num(); };
+
+	// Number of static actors
+	int32 NumStaticActors() const { return StaticActors.Num(); };
+
+	// Number of bone slots
+	int32 NumBones() const { return BoneIndexes.Num(); };
+
+	// Memory used by the bindings
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T NumBytes = Actors.GetAllocatedSize() + ActorIds.GetAllocatedSize() + SkeletalComponents.GetAllocatedSize() 
+			+ ComponentBoneOffsets.GetAllocatedSize() + BoneComponents.GetAllocatedSize() + BoneIndexes.GetAllocatedSize() + BoneIds.GetAllocatedSize()
+			+ StaticActors.GetAllocatedSize() + StaticActorIds.GetAllocatedSize();
+		for (const FString& Id : ActorIds)
+		{
+			NumBytes += Id.GetAllocatedSize();
+		}
+		for (const FString& Id : BoneIds)
+		{
+			NumBytes += Id.GetAllocatedSize();
+		}
+		for (const FString& Id : StaticActorIds)
+		{
+			NumBytes += Id.GetAllocatedSize();
+		}
+		return NumBytes;
+	};
+
+	// Clear the bindings
+	void Empty()
+	{
+		Actors.Empty();
+		ActorIds.Empty();
+		SkeletalComponents.Empty();
+		ComponentBoneOffsets.Empty();
+		BoneComponents.Empty();
+		BoneIndexes.Empty();
+		BoneIds.Empty();
+		StaticActors.Empty();
+		StaticActorIds.Empty();
+	};
+};
+
+/*
+* Holds the poses of all the individuals in the world, indexed by their slot
 */
 struct FSLVizEpisodeFrameData
 {
-	// Array of the actors and their poses
-	TMap<AActor*, FTransform> ActorPoses;
+	// Pose of every actor slot
+	TArray<FTransform> ActorPoses;
 
-	// Array of the skeletal components and their bone poses (the actor locations are included above)
-	TMap<UPoseableMeshComponent*, TMap<int32, FTransform>> BonePoses;
+	// Pose of every bone slot (the actor locations are included above)
+	TArray<FTransform> BonePoses;
 };
 
 /*
-* Holds the frames from the recorded episode
+* Holds the frames from the recorded episode as full keyframes every N frames and the changes of every frame,
+* all poses are stored in flat arrays addressed by the binding slots
 */
 struct FSLVizEpisodeData
 {
+	// Default number of frames between two keyframes
+	static constexpr int32 DefaultKeyframeInterval = 64;
+
 	// Id of the episode
 	FString Id;
 
 	// Array of the timestamps
 	TArray<float> Timestamps;
 
-	// Array of the compact frames (used for fast gotos)
-	TArray<FSLVizEpisodeFrameData> FullFrames;
+	// Actors and bones the poses are applied to
+	FSLVizEpisodeBindings Bindings;
+
+	// Pose of every static actor (applied once when the episode is loaded)
+	TArray<FTransform> StaticActorPoses;
+
+	// Number of frames between two keyframes (a frame is rebuilt from at most KeyframeInterval - 1 compact frames)
+	int32 KeyframeInterval = DefaultKeyframeInterval;
+
+	// Actor poses of every KeyframeInterval-th frame, NumActors() entries per keyframe (used for fast gotos)
+	TArray<FTransform> KeyframeActorPoses;
+
+	// Bone poses of every KeyframeInterval-th frame, NumBones() entries per keyframe
+	TArray<FTransform> KeyframeBonePoses;
+
+	// Actor changes of frame i are in [DeltaActorOffsets[i], DeltaActorOffsets[i + 1]) (used for fast replays)
+	TArray<int32> DeltaActorOffsets;
 
-	// Array of the compact frames (used for fast replays)
-	TArray<FSLVizEpisodeFrameData> CompactFrames;
+	// Actor slot of every actor change
+	TArray<int32> DeltaActorSlots;
+
+	// Pose of every actor change
+	TArray<FTransform> DeltaActorPoses;
+
+	// Bone changes of frame i are in [DeltaBoneOffsets[i], DeltaBoneOffsets[i + 1])
+	TArray<int32> DeltaBoneOffsets;
+
+	// Bone slot of every bone change (sorted in every frame)
+	TArray<int32> DeltaBoneSlots;
+
+	// Pose of every bone change
+	TArray<FTransform> DeltaBonePoses;
 
 	// Default ctor
 	FSLVizEpisodeData() {};
 
 	// Reserve array size ctor
-	FSLVizEpisodeData(int32 ArraySize)
+	FSLVizEpisodeData(int32 ArraySize, int32 InKeyframeInterval = DefaultKeyframeInterval)
 	{
+		KeyframeInterval = FMath::Max(InKeyframeInterval, 1);
 		Timestamps.Reserve(ArraySize);
-		FullFrames.Reserve(ArraySize);
-		CompactFrames.Reserve(ArraySize);
+		DeltaActorOffsets.Reserve(ArraySize + 1);
+		DeltaBoneOffsets.Reserve(ArraySize + 1);
+	};
+
+	// Number of frames
+	int32 NumFrames() const { return Timestamps.Num(); };
+
+	// Number of stored keyframes
+	int32 NumKeyframes() const 
+	{
+		return Bindings.NumActors() > 0 ? KeyframeActorPoses.Num() / Bindings.NumActors() 
+			: Bindings.NumBones() > 0 ? KeyframeBonePoses.Num() / Bindings.NumBones()
+			: Timestamps.Num() > 0 ? GetKeyframeIndex(Timestamps.Num() - 1) + 1 : 0;
+	};
+
+	// Number of skeletal components with bone changes after the first frame
+	int32 NumDynamicComponents() const
+	{
+		if (DeltaBoneOffsets.Num() < 2)
+		{
+			return 0;
+		}
+		TBitArray<> ComponentMoved(false, Bindings.SkeletalComponents.Num());
+		for (int32 Idx = DeltaBoneOffsets[1]; Idx < DeltaBoneSlots.Num(); ++Idx)
+		{
+			ComponentMoved[Bindings.BoneComponents[DeltaBoneSlots[Idx]]] = true;
+		}
+		int32 NumMoved = 0;
+		for (TConstSetBitIterator<> BitItr(ComponentMoved); BitItr; ++BitItr)
+		{
+			NumMoved++;
+		}
+		return NumMoved;
+	};
+
+	// Summary of how much of the scene moves during the episode
+	FString GetDynamicsInfo() const
+	{
+		const int32 NumAllActors = Bindings.NumActors() + Bindings.NumStaticActors();
+		const int32 NumDynamicComps = NumDynamicComponents();
+		return FString::Printf(TEXT("actors(dynamic=%d, static=%d, dynamic=%.1f%%); skeletal components(dynamic=%d, static=%d); bones=%d"),
+			Bindings.NumActors(), Bindings.NumStaticActors(), NumAllActors > 0 ? 100.f * Bindings.NumActors() / NumAllActors : 0.f,
+			NumDynamicComps, Bindings.SkeletalComponents.Num() - NumDynamicComps, Bindings.NumBones());
 	};
 
 	// Check if there is data in the episode and it is in sync
 	bool IsValid() const 
 	{
-		return Timestamps.Num() > 2 && Timestamps.Num() == FullFrames.Num();
+		return Timestamps.Num() > 2 
+			&& DeltaActorOffsets.Num() == Timestamps.Num() + 1
+			&& DeltaBoneOffsets.Num() == Timestamps.Num() + 1
+			&& NumKeyframes() == GetKeyframeIndex(Timestamps.Num() - 1) + 1;
+	};
+
+	// Check if a full copy of the frame should be stored
+	bool IsKeyframe(int32 FrameIndex) const { return FrameIndex % KeyframeInterval == 0; };
+
+	// Index of the keyframe the frame is rebuilt from
+	int32 GetKeyframeIndex(int32 FrameIndex) const { return FrameIndex / KeyframeInterval; };
+
+	// Start a new frame, the following changes are added to it
+	void AddFrame(float Ts)
+	{
+		if (DeltaActorOffsets.Num() == 0)
+		{
+			DeltaActorOffsets.Add(0);
+			DeltaBoneOffsets.Add(0);
+		}
+		Timestamps.Add(Ts);
+		DeltaActorOffsets.Add(DeltaActorOffsets.Last());
+		DeltaBoneOffsets.Add(DeltaBoneOffsets.Last());
+	};
+
+	// Add an actor change to the last frame
+	void AddActorChange(int32 Slot, const FTransform& Pose)
+	{
+		DeltaActorSlots.Add(Slot);
+		DeltaActorPoses.Add(Pose);
+		DeltaActorOffsets.Last()++;
+	};
+
+	// Add a bone change to the last frame
+	void AddBoneChange(int32 Slot, const FTransform& Pose)
+	{
+		DeltaBoneSlots.Add(Slot);
+		DeltaBonePoses.Add(Pose);
+		DeltaBoneOffsets.Last()++;
+	};
+
+	// Store the full frame as the next keyframe
+	void AddKeyframe(const FSLVizEpisodeFrameData& Frame)
+	{
+		KeyframeActorPoses.Append(Frame.ActorPoses);
+		KeyframeBonePoses.Append(Frame.BonePoses);
+	};
+
+	// Overwrite the poses of the full frame with the changes of the given frame
+	void ApplyChanges(int32 FrameIndex, FSLVizEpisodeFrameData& InOutFrame) const
+	{
+		for (int32 Idx = DeltaActorOffsets[FrameIndex]; Idx < DeltaActorOffsets[FrameIndex + 1]; ++Idx)
+		{
+			InOutFrame.ActorPoses[DeltaActorSlots[Idx]] = DeltaActorPoses[Idx];
+		}
+		for (int32 Idx = DeltaBoneOffsets[FrameIndex]; Idx < DeltaBoneOffsets[FrameIndex + 1]; ++Idx)
+		{
+			InOutFrame.BonePoses[DeltaBoneSlots[Idx]] = DeltaBonePoses[Idx];
+		}
+	};
+
+	// Rebuild the full frame from the nearest previous keyframe and the following compact frames
+	bool BuildFrame(int32 FrameIndex, FSLVizEpisodeFrameData& OutFrame) const
+	{
+		const int32 KeyframeIndex = GetKeyframeIndex(FrameIndex);
+		if (!Timestamps.IsValidIndex(FrameIndex) || KeyframeIndex >= NumKeyframes())
+		{
+			return false;
+		}
+		OutFrame.ActorPoses.Reset(Bindings.NumActors());
+		OutFrame.ActorPoses.Append(KeyframeActorPoses.GetData() + KeyframeIndex * Bindings.NumActors(), Bindings.NumActors());
+		OutFrame.BonePoses.Reset(Bindings.NumBones());
+		OutFrame.BonePoses.Append(KeyframeBonePoses.GetData() + KeyframeIndex * Bindings.NumBones(), Bindings.NumBones());
+		for (int32 Idx = KeyframeIndex * KeyframeInterval + 1; Idx <= FrameIndex; ++Idx)
+		{
+			ApplyChanges(Idx, OutFrame);
+		}
+		return true;
+	};
+
+	// Memory used by the episode
+	SIZE_T GetAllocatedSize() const
+	{
+		return Id.GetAllocatedSize() + Timestamps.GetAllocatedSize() + Bindings.GetAllocatedSize() + StaticActorPoses.GetAllocatedSize()
+			+ KeyframeActorPoses.GetAllocatedSize() + KeyframeBonePoses.GetAllocatedSize()
+			+ DeltaActorOffsets.GetAllocatedSize() + DeltaActorSlots.GetAllocatedSize() + DeltaActorPoses.GetAllocatedSize()
+			+ DeltaBoneOffsets.GetAllocatedSize() + DeltaBoneSlots.GetAllocatedSize() + DeltaBonePoses.GetAllocatedSize();
+	};
+
+	// Release the unused slack of the arrays
+	void Shrink()
+	{
+		Timestamps.Shrink();
+		StaticActorPoses.Shrink();
+		KeyframeActorPoses.Shrink();
+		KeyframeBonePoses.Shrink();
+		DeltaActorOffsets.Shrink();
+		DeltaActorSlots.Shrink();
+		DeltaActorPoses.Shrink();
+		DeltaBoneOffsets.Shrink();
+		DeltaBoneSlots.Shrink();
+		DeltaBonePoses.Shrink();
 	};
 
 	// Clear all the data in the episode
@@ -63,11 +314,22 @@ struct FSLVizEpisodeData
 	{
 		Id = "";
 		Timestamps.Empty(); 
-		FullFrames.Empty();
-		CompactFrames.Empty();
+		Bindings.Empty();
+		StaticActorPoses.Empty();
+		KeyframeActorPoses.Empty();
+		KeyframeBonePoses.Empty();
+		DeltaActorOffsets.Empty();
+		DeltaActorSlots.Empty();
+		DeltaActorPoses.Empty();
+		DeltaBoneOffsets.Empty();
+		DeltaBoneSlots.Empty();
+		DeltaBonePoses.Empty();
 	};
 };
 
+// Compiled episodes are immutable once built, they are shared between the cache and the episode manager without copies
+typedef TSharedPtr<const FSLVizEpisodeData, ESPMode::ThreadSafe> FSLVizEpisodeDataPtr;
+
 
 /**
  * Class to load and skim through episodes
@@ -93,13 +355,13 @@ public:
 	bool IsWorldConverted() const { return bWorldSetAsVisualOnly; };
 
 	// Load episode data
-	void LoadEpisode(const FSLVizEpisodeData& InEpisodeData);
+	void LoadEpisode(const FSLVizEpisodeDataPtr& InEpisodeData);
 
 	// Check if an episode is loaded
 	bool IsEpisodeLoaded() const { return bEpisodeLoaded; };
 
 	// Get loaded episode id
-	FString GetEpisodeId() const { return EpisodeData.Id; };
+	FString GetEpisodeId() const { return EpisodeData.IsValid() ? EpisodeData->Id : FString(); };
 
 	// Remove episode data
 	void ClearEpisode();
@@ -131,13 +393,31 @@ public:
 	// Stop replay, goto first frame
 	void StopReplay();
 
+	// Compare the single pass bone pose application with the previous by-name world space one on the current frame
+	void BenchmarkBonePoses(int32 NumIterations = 100);
+
 private:
 	// Start replay
 	void StartReplay();
 
-	// Apply frame poses
+	// Apply the poses of the actors which do not move during the episode
+	void ApplyStaticPoses();
+
+	// Apply all the poses of the full frame
 	void ApplyPoses(const FSLVizEpisodeFrameData& Frame);
 
+	// Apply only the changes of the given frame (the previous frame needs to be already applied)
+	void ApplyFrameChanges(int32 FrameIndex);
+
+	// Start the realtime replay from the given (already applied) frame
+	void ResetRealtimeReplay(int32 FrameIndex);
+
+	// Advance the realtime replay with the passed wall clock time (return false if the replay end was reached)
+	bool UpdateRealtimeReplay();
+
+	// Apply the poses of the changed slots of the realtime replay
+	void ApplyDirtyPoses();
+
 	// Apply next frame changes (return false if there are no more frames)
 	bool ApplyNextFrameChanges();
 
@@ -157,8 +437,26 @@ protected:
 	// True if it currently in an active replay
 	uint8 bReplayRunning : 1;
 
-	// Episode data
-	FSLVizEpisodeData EpisodeData;
+	// True if the replay follows the wall clock instead of one frame per update
+	uint8 bRealtimeReplay : 1;
+
+	// True if the realtime replay interpolates between the recorded frames
+	uint8 bInterpolateReplay : 1;
+
+	// True if the poses of the static actors of the loaded episode are applied
+	uint8 bStaticPosesApplied : 1;
+
+	// Reference to the loaded (shared) episode data, the manager only owns the playhead
+	FSLVizEpisodeDataPtr EpisodeData;
+
+	// Reused full frame of the gotos
+	FSLVizEpisodeFrameData GotoFrameData;
+
+	// Reused component space poses of the bone pose application
+	TArray<FTransform> ComponentSpaceBuffer;
+
+	// Reused bone indexes of the changed bones of a component
+	TArray<int32> ComponentBoneIndexesBuffer;
 
 	// Current frame index
 	int32 ActiveFrameIndex;
@@ -174,6 +472,27 @@ protected:
 
 	// Default replay update rate
 	float EpisodeDefaultUpdateRate;
+
+	// Playback speed of the realtime replay
+	float ReplaySpeedFactor;
+
+	// Current episode time of the realtime replay
+	float ReplayTime;
+
+	// Wall clock time of the last realtime replay update
+	double LastReplayWallTime;
+
+	// Recorded poses at the active frame of the realtime replay
+	FSLVizEpisodeFrameData ReplayFrameData;
+
+	// Poses to apply (recorded or interpolated) of the realtime replay
+	FSLVizEpisodeFrameData ReplayApplyFrameData;
+
+	// Actor slots whose pose changed since the last realtime update
+	TBitArray<> DirtyActorSlots;
+
+	// Skeletal components with changed bones since the last realtime update
+	TBitArray<> DirtyComponents;
 };
 
 
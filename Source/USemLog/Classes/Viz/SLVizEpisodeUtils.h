@@ -10,7 +10,8 @@
 class UWorld;
 class AActor;
 class ASLIndividualManager;
-struct FSLVizEpisodeData;
+class UPoseableMeshComponent;
+struct FSLVizEpisodeBindings;
 
 /**
  * Viz visual parameters (color and material type)
@@ -24,14 +25,31 @@ public:
 	// Add a poseable mesh component clone to the skeletal actors
 	static void AddPoseablMeshComponentsToSkeletalActors(UWorld* World);	
 
-	// Build the full replay episode data from the mongo compact form (returns true if no errors occured)
-	static bool BuildEpisodeData(ASLIndividualManager* IndividualManager, 
-		const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
-		FSLVizEpisodeData& OutVizEpisodeData);
+	// Create the actor and bone slots of the episode individuals (the bone slots are grouped by component),
+	// every id index gets its actor or bone slot (INDEX_NONE if the individual has no replayable pose)
+	static bool BuildEpisodeBindings(ASLIndividualManager* IndividualManager, const TArray<FString>& Ids,
+		FSLVizEpisodeBindings& OutBindings, TArray<int32>& OutIdxToActorSlot, TArray<int32>& OutIdxToBoneSlot);
+
+	// Resolve the individual to the actor or the (poseable mesh, bone index) its poses are applied to (false if not found)
+	static bool ResolveIndividual(ASLIndividualManager* IndividualManager, const FString& Id,
+		AActor*& OutActor, UPoseableMeshComponent*& OutPMC, int32& OutBoneIndex);
+
+	// True if the actor has static mobility (its pose is never applied by the replay)
+	static bool IsStaticMobilityActor(AActor* Actor);
 
 	// Executes a binary search for element Item in array Array using the <= operator (from ProfilerCommon::FBinaryFindIndex)
 	static int32 BinarySearchLessEqual(const TArray<float>& Array, float Value);
 
+	// Set the world space bone poses with a single parent-first pass directly in the bone space transforms (bone indexes sorted ascending)
+	static void SetBoneWorldPoses(UPoseableMeshComponent* PMC, const int32* BoneIndexes, const FTransform* WorldPoses, int32 Num,
+		TArray<FTransform>& ComponentSpaceBuffer);
+
+	// Set the world space bone poses (bone index to pose) with a single parent-first pass
+	static void SetBoneWorldPoses(UPoseableMeshComponent* PMC, const TMap<int32, FTransform>& BonePoses);
+
+	// Interpolate between the two poses (lerp for location and scale, slerp for rotation)
+	static FTransform InterpolatePoses(const FTransform& A, const FTransform& B, float Alpha);
+
 private:
 	// Check if actor requires any special attention when switching to visual only world (return true if the components should be left alone)
 	static bool IsSpecialCaseActor(AActor* Actor);
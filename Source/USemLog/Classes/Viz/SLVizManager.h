@@ -17,6 +17,8 @@ class ASLIndividualManager;
 class ASLVizCameraDirector;
 class USLVizBaseMarker;
 class UMeshComponent;
+class FSLVizEpisodeCompiler;
+struct FSLMongoEpisodeFrames;
 
 /*
 *
@@ -37,6 +39,9 @@ protected:
 	// Called when actor removed from game or game ended
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	// Called every frame, only enabled while episodes are compiled in the background
+	virtual void Tick(float DeltaTime) override;
+
 public:
 	// Load required managers
 	void Init();
@@ -148,6 +153,20 @@ public:
 		const FLinearColor& Color, ESLVizMaterialType MaterialType,
 		const FSLVizTimelineParams& TimelineParams);
 
+	/* Skeletal bones as primitive markers */
+	// Create a lightweight marker of the skeletal poses, the bones are drawn as instanced primitives
+	bool CreateSkeletalBonesMarker(const FString& MarkerId,
+		const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+		ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+		const FLinearColor& Color = FLinearColor::Green, ESLVizMaterialType MaterialType = ESLVizMaterialType::Unlit);
+
+	// Create a lightweight timeline marker of the skeletal poses, the bones are drawn as instanced primitives
+	bool CreateSkeletalBonesMarkerTimeline(const FString& MarkerId,
+		const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+		ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+		const FLinearColor& Color, ESLVizMaterialType MaterialType,
+		const FSLVizTimelineParams& TimelineParams);
+
 	// Remove marker with the given id
 	bool RemoveMarker(const FString& Id);
 
@@ -167,6 +186,31 @@ public:
 	// Check if the episode is already cached
 	bool IsEpisodeCached(const FString& Id) const { return CachedEpisodeData.Contains(Id); };
 
+	// Compile the episode frames on the thread pool, the episode is cached (and written to its cache file) when done
+	bool CacheEpisodeDataAsync(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature,
+		FSLMongoEpisodeFrames&& InMongoEpisodeFrames);
+
+	// Check if the episode is compiled in the background
+	bool IsEpisodeCompiling(const FString& Id) const { return EpisodeCompilers.Contains(Id); };
+
+	// Progress [0, 1] of the background episode compilation (false if the episode is not compiling)
+	bool GetEpisodeCompileProgress(const FString& Id, float& OutProgress) const;
+
+	// Stop the background episode compilation (false if the episode is not compiling)
+	bool CancelEpisodeCompilation(const FString& Id);
+
+	// Cancel all background episode compilations
+	void CancelAllEpisodeCompilations();
+
+	// Memory used by the cached episodes
+	SIZE_T GetCachedEpisodesAllocatedSize() const;
+
+	// Load the episode from its cache file into the cached episodes (false if missing, outdated or not matching the world)
+	bool LoadEpisodeCacheFile(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature);
+
+	// Write the cached episode to its cache file, loaded in the following sessions as long as the content signature matches
+	bool SaveEpisodeCacheFile(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature) const;
+
 	// Load cached episode data
 	bool LoadCachedEpisodeData(const FString& Id);
 
@@ -197,6 +241,9 @@ public:
 	// Stop replay (if active, and goto frame 0)
 	void StopReplay();
 
+	// Compare the single pass bone pose application with the previous by-name one on the current frame of the loaded episode
+	void BenchmarkBonePoses(int32 NumIterations = 100);
+
 
 	/* View */
 	// Move the view to a given position
@@ -227,6 +274,10 @@ private:
 
 	// Get the vizualization camera director from the world (or spawn a new one)
 	bool SetCameraDirector();
+
+	/* Episode compilation */
+	// Move the finished background compilations to the cached episodes
+	void CollectCompiledEpisodes();
 	
 private:
 	// True if the manager is initialized
@@ -265,6 +316,17 @@ private:
 
 
 	/* Cached data */
-	// Episode id to viz episode data
-	TMap<FString, FSLVizEpisodeData> CachedEpisodeData;
+	// Episode id to viz episode data (shared with the episode manager when loaded)
+	TMap<FString, FSLVizEpisodeDataPtr> CachedEpisodeData;
+
+	// Persist the compiled episodes on disk and load them in the following sessions
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger")
+	bool bUseEpisodeCacheFiles = true;
+
+	// Episode id to its background compilation
+	TMap<FString, TSharedPtr<FSLVizEpisodeCompiler>> EpisodeCompilers;
+
+	// How often to check for finished background compilations
+	UPROPERTY(EditAnywhere, Category = "Semantic Logger", meta = (ClampMin = 0))
+	float EpisodeCompileCheckInterval = 0.1f;
 };
@@ -127,7 +127,24 @@ public:
 		const FLinearColor& InColor, ESLVizMaterialType MaterialType);
 
 
+	/* Skeletal bones as primitive markers */
+	// Create a lightweight skeletal marker, every bone pose is drawn as an instanced primitive
+	USLVizPrimitiveMarker* CreateSkeletalBonesPrimitiveMarker(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+		ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+		const FLinearColor& InColor, ESLVizMaterialType MaterialType = ESLVizMaterialType::Unlit);
+
+	// Create a lightweight skeletal timeline marker, every bone pose is drawn as an instanced primitive
+	USLVizPrimitiveMarker* CreateSkeletalBonesPrimitiveMarkerTimeline(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+		ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+		const FLinearColor& InColor, ESLVizMaterialType MaterialType,
+		const FSLVizTimelineParams& TimelineParams);
+
+
 private:
+	// Flatten the bone poses of the skeletal poses, returns the max number of bones of a pose
+	static int32 GetSkeletalBonePoses(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+		TArray<FTransform>& OutBonePoses);
+
 	// Create and store marker helper function
 	template <class T>
 	T* CreateAndAddNewMarker(UObject* Outer)
@@ -148,6 +148,18 @@ struct FSLVizEpisodePlayParams
 	UPROPERTY(EditAnywhere, Category = "Properties")
 	int32 StepSize = 1;
 
+	// Follow the wall clock instead of one frame per update (frames are skipped when behind, interpolated when ahead)
+	UPROPERTY(EditAnywhere, Category = "Realtime")
+	bool bRealtime = false;
+
+	// Playback speed of the realtime replay
+	UPROPERTY(EditAnywhere, Category = "Realtime", meta = (editcondition = "bRealtime", ClampMin = 0.01))
+	float SpeedFactor = 1.f;
+
+	// Interpolate the poses between the recorded frames of the realtime replay (slerp for rotations)
+	UPROPERTY(EditAnywhere, Category = "Realtime", meta = (editcondition = "bRealtime"))
+	bool bInterpolate = true;
+
 	// Default ctor
 	FSLVizEpisodePlayParams() {};
 
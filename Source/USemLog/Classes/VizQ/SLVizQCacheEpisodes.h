@@ -19,13 +19,36 @@ class USLVizQCacheEpisodes : public USLVizQBase
 	GENERATED_BODY()
 
 protected:
+#if WITH_EDITOR
+	// Called when a property is changed in the editor
+	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif // WITH_EDITOR
+
 	// Virtual implementation of the execute function
 	virtual void ExecuteImpl(ASLKnowrobManager* KRManager) override;
 
+	// Log the progress of the episodes compiled in the background
+	void LogCompileProgress(ASLKnowrobManager* KRManager) const;
+
+	// Cancel the background compilation of the episodes
+	void CancelCompilation(ASLKnowrobManager* KRManager) const;
+
 protected:
 	UPROPERTY(EditAnywhere, Category = "Cache Episodes")
 	FString Task;
 
 	UPROPERTY(EditAnywhere, Category = "Cache Episodes")
 	TArray<FString> Episodes;
+
+	// Compile the episodes on the thread pool instead of blocking the game thread
+	UPROPERTY(EditAnywhere, Category = "Cache Episodes")
+	bool bCompileInBackground = true;
+
+
+	/* Manual interaction */
+	UPROPERTY(EditAnywhere, Category = "Manual Interaction|Cache Episodes", meta = (editcondition = "bCompileInBackground"))
+	bool bProgressButton = false;
+
+	UPROPERTY(EditAnywhere, Category = "Manual Interaction|Cache Episodes", meta = (editcondition = "bCompileInBackground"))
+	bool bCancelButton = false;
 };
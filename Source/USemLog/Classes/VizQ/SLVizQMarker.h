@@ -20,6 +20,7 @@ enum class ESLVizQMarkerMeshType : uint8
 	Primitive			UMETA(DisplayName = "Primitive"),
 	StaticMesh			UMETA(DisplayName = "Static Mesh"),
 	SkeletalMesh		UMETA(DisplayName = "Skeletal Mesh"),
+	SkeletalBones		UMETA(DisplayName = "Skeletal Bones"),
 };
 
 /**
@@ -90,7 +91,7 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Marker|Visual")
 	ESLVizQMarkerMeshType MeshType = ESLVizQMarkerMeshType::Primitive;
 
-	UPROPERTY(EditAnywhere, Category = "Marker|Visual", meta = (editcondition = "MeshType!=ESLVizQMarkerMeshType::Primitive"))
+	UPROPERTY(EditAnywhere, Category = "Marker|Visual", meta = (editcondition = "MeshType!=ESLVizQMarkerMeshType::Primitive && MeshType!=ESLVizQMarkerMeshType::SkeletalBones"))
 	bool bUseOriginalColor = false;
 
 	UPROPERTY(EditAnywhere, Category = "Marker|Visual", meta = (editcondition = "!bUseOriginalColor"))
@@ -101,10 +102,10 @@ public:
 
 
 	/* Visual params */
-	UPROPERTY(EditAnywhere, Category = "Marker|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerMeshType::Primitive"))
+	UPROPERTY(EditAnywhere, Category = "Marker|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerMeshType::Primitive || MeshType==ESLVizQMarkerMeshType::SkeletalBones"))
 	ESLVizPrimitiveMarkerType PrimitiveType = ESLVizPrimitiveMarkerType::Box;
 
-	UPROPERTY(EditAnywhere, Category = "Marker|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerMeshType::Primitive"))
+	UPROPERTY(EditAnywhere, Category = "Marker|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerMeshType::Primitive || MeshType==ESLVizQMarkerMeshType::SkeletalBones"))
 	float Size = 0.05f;
 
 
@@ -20,6 +20,7 @@ enum class ESLVizQMarkerArrayMeshType : uint8
 	Primitive			UMETA(DisplayName = "Primitive"),
 	StaticMesh			UMETA(DisplayName = "Static Mesh"),
 	SkeletalMesh		UMETA(DisplayName = "Skeletal Mesh"),
+	SkeletalBones		UMETA(DisplayName = "Skeletal Bones"),
 };
 
 /**
@@ -90,7 +91,7 @@ public:
 	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual")
 	ESLVizQMarkerArrayMeshType MeshType = ESLVizQMarkerArrayMeshType::Primitive;
 
-	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual", meta = (editcondition = "MeshType!=ESLVizQMarkerArrayMeshType::Primitive"))
+	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual", meta = (editcondition = "MeshType!=ESLVizQMarkerArrayMeshType::Primitive && MeshType!=ESLVizQMarkerArrayMeshType::SkeletalBones"))
 	bool bUseOriginalColor = false;
 
 	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual", meta = (editcondition = "!bUseOriginalColor"))
@@ -101,10 +102,10 @@ public:
 
 
 	/* Visual params */
-	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerArrayMeshType::Primitive"))
+	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerArrayMeshType::Primitive || MeshType==ESLVizQMarkerArrayMeshType::SkeletalBones"))
 	ESLVizPrimitiveMarkerType PrimitiveType = ESLVizPrimitiveMarkerType::Box;
 
-	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerArrayMeshType::Primitive"))
+	UPROPERTY(EditAnywhere, Category = "MarkerArray|Visual|Primitive", meta = (editcondition = "MeshType==ESLVizQMarkerArrayMeshType::Primitive || MeshType==ESLVizQMarkerArrayMeshType::SkeletalBones"))
 	float Size = 0.05f;
 
 protected:
@@ -50,7 +50,7 @@ bool FSLSemanticMapWriter::WriteToFile(UWorld* World, const FSLSemanticMapWriter
 	AddWorldIndividuals(SemMap, World);
 
 	// Write map to file	
-	return FFileHelper::SaveStringToFile(SemMap->ToString(), *FullFilePath);
+	return FSLOwlWriter::WriteDocToFile(*SemMap, FullFilePath);
 }
 
 // Create semantic map template
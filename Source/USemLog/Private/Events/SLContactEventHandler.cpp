@@ -67,6 +67,86 @@ void FSLContactEventHandler::Finish(float EndTime, bool bForced)
 	}
 }
 
+// Log the timings of the pending events lookups with the given number of simultaneous contacts (previous linear scan vs keyed table)
+void FSLContactEventHandler::BenchmarkPendingEvents(int32 NumContacts)
+{
+	NumContacts = FMath::Max(NumContacts, 1);
+
+	// The individuals are only used as lookup keys, they are never dereferenced
+	TArray<USLBaseIndividual*> Others;
+	TArray<TSharedPtr<FSLContactEvent>> Events;
+	for (int32 Idx = 0; Idx < NumContacts; ++Idx)
+	{
+		USLBaseIndividual* Other = reinterpret_cast<USLBaseIndividual*>(static_cast<UPTRINT>(Idx + 1) * 16);
+		Others.Add(Other);
+		Events.Emplace(MakeShareable(new FSLContactEvent(FString::FromInt(Idx), Idx * 0.001f, Idx, nullptr, Other)));
+	}
+
+	// All the contacts are started, then three quarters of them end in a random order, the rest are finished all at once
+	FRandomStream Rand(42);
+	TArray<USLBaseIndividual*> EndOrder = Others;
+	for (int32 Idx = EndOrder.Num() - 1; Idx > 0; --Idx)
+	{
+		EndOrder.Swap(Idx, Rand.RandRange(0, Idx));
+	}
+	EndOrder.SetNum(NumContacts * 3 / 4);
+
+	// Previous linear scan
+	TArray<FString> ScanFinishedIds;
+	double ExecBegin = FPlatformTime::Seconds();
+	TArray<TSharedPtr<FSLContactEvent>> ScanStarted;
+	for (const auto& Ev : Events)
+	{
+		ScanStarted.Emplace(Ev);
+	}
+	for (USLBaseIndividual* Other : EndOrder)
+	{
+		for (auto EventItr(ScanStarted.CreateIterator()); EventItr; ++EventItr)
+		{
+			if ((*EventItr)->Individual2 == Other)
+			{
+				ScanFinishedIds.Add((*EventItr)->Id);
+				EventItr.RemoveCurrent();
+				break;
+			}
+		}
+	}
+	for (const auto& Ev : ScanStarted)
+	{
+		ScanFinishedIds.Add(Ev->Id);
+	}
+	const double ScanDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Keyed table
+	TArray<FString> TableFinishedIds;
+	ExecBegin = FPlatformTime::Seconds();
+	TSLPendingEventTable<USLBaseIndividual*, TSharedPtr<FSLContactEvent>> TableStarted;
+	for (const auto& Ev : Events)
+	{
+		TableStarted.Add(Ev->Individual2, Ev);
+	}
+	TSharedPtr<FSLContactEvent> Finished;
+	for (USLBaseIndividual* Other : EndOrder)
+	{
+		if (TableStarted.RemoveOldest(Other, Finished))
+		{
+			TableFinishedIds.Add(Finished->Id);
+		}
+	}
+	TArray<TSharedPtr<FSLContactEvent>> Remaining;
+	TableStarted.RemoveAll(Remaining);
+	for (const auto& Ev : Remaining)
+	{
+		TableFinishedIds.Add(Ev->Id);
+	}
+	const double TableDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Pending contact events (contacts=%d, ended=%d): scan=[%f], table=[%f] seconds (speedup=%.2fx); identical finish order=%s;"),
+		*FString(__FUNCTION__), __LINE__, NumContacts, EndOrder.Num(),
+		ScanDuration, TableDuration, TableDuration > 0.0 ? ScanDuration / TableDuration : 0.0,
+		ScanFinishedIds == TableFinishedIds ? TEXT("true") : TEXT("false"));
+}
+
 // Start new contact event
 void FSLContactEventHandler::AddNewContactEvent(const FSLContactResult& InResult)
 {
@@ -76,33 +156,26 @@ void FSLContactEventHandler::AddNewContactEvent(const FSLContactResult& InResult
 		FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID()),
 		InResult.Self, InResult.Other));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending contacts array
-	StartedContactEvents.Emplace(Event);
+	// Add event to the pending contacts (indexed by the other individual)
+	StartedContactEvents.Add(InResult.Other, Event);
 }
 
 // Publish finished event
 bool FSLContactEventHandler::FinishContactEvent(USLBaseIndividual* InOther, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedContactEvents.CreateIterator()); EventItr; ++EventItr)
+	// It is enough to search by the other individual, the oldest started event is finished first
+	TSharedPtr<FSLContactEvent> Event;
+	if (StartedContactEvents.RemoveOldest(InOther, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual2 == InOther)
-		{
-			// Set the event end time
-			(*EventItr)->EndTime = EndTime;
+		// Set the event end time
+		Event->EndTime = EndTime;
 
-			// Avoid publishing short events
-			if (((*EventItr)->EndTime - (*EventItr)->StartTime) > ContactEventMin)
-			{
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-
-			return true;
+		// Avoid publishing short events
+		if ((Event->EndTime - Event->StartTime) > ContactEventMin)
+		{
+			OnSemanticEvent.ExecuteIfBound(Event);
 		}
+		return true;
 	}
 	return false;
 }
@@ -114,30 +187,24 @@ void FSLContactEventHandler::AddNewSupportedByEvent(USLBaseIndividual* Supported
 	TSharedPtr<FSLSupportedByEvent> Event = MakeShareable(new FSLSupportedByEvent(
 		FSLUuid::NewGuidInBase64Url(), StartTime, EventPairId, Supported, Supporting));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending array
-	StartedSupportedByEvents.Emplace(Event);
+	// Add event to the pending events (indexed by the pair id)
+	StartedSupportedByEvents.Add(EventPairId, Event);
 }
 
 // Finish then publish the event
 bool FSLContactEventHandler::FinishSupportedByEvent(const uint64 InPairId, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedSupportedByEvents.CreateIterator()); EventItr; ++EventItr)
+	TSharedPtr<FSLSupportedByEvent> Event;
+	if (StartedSupportedByEvents.RemoveOldest(InPairId, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->PairId == InPairId)
+		// Ignore short events
+		if (EndTime - Event->StartTime > SupportedByEventMin)
 		{
-			// Ignore short events
-			if (EndTime - (*EventItr)->StartTime > SupportedByEventMin)
-			{
-				// Set end time and publish event
-				(*EventItr)->EndTime = EndTime;
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
+			// Set end time and publish event
+			Event->EndTime = EndTime;
+			OnSemanticEvent.ExecuteIfBound(Event);
 		}
+		return true;
 	}
 	return false;
 }
@@ -145,8 +212,10 @@ bool FSLContactEventHandler::FinishSupportedByEvent(const uint64 InPairId, float
 // Terminate and publish pending contact events (this usually is called at end play)
 void FSLContactEventHandler::FinishAllEvents(float EndTime)
 {
-	// Finish contact events
-	for (auto& Ev : StartedContactEvents)
+	// Finish contact events (in the order they started)
+	TArray<TSharedPtr<FSLContactEvent>> ContactEvents;
+	StartedContactEvents.RemoveAll(ContactEvents);
+	for (auto& Ev : ContactEvents)
 	{
 		// Ignore short events
 		if (EndTime - Ev->StartTime > ContactEventMin)
@@ -156,10 +225,11 @@ void FSLContactEventHandler::FinishAllEvents(float EndTime)
 			OnSemanticEvent.ExecuteIfBound(Ev);
 		}
 	}
-	StartedContactEvents.Empty();
 
-	// Finish supported by events
-	for (auto& Ev : StartedSupportedByEvents)
+	// Finish supported by events (in the order they started)
+	TArray<TSharedPtr<FSLSupportedByEvent>> SupportedByEvents;
+	StartedSupportedByEvents.RemoveAll(SupportedByEvents);
+	for (auto& Ev : SupportedByEvents)
 	{
 		// Ignore short events
 		if ((EndTime - Ev->StartTime) > SupportedByEventMin)
@@ -169,7 +239,6 @@ void FSLContactEventHandler::FinishAllEvents(float EndTime)
 			OnSemanticEvent.ExecuteIfBound(Ev);
 		}
 	}
-	StartedSupportedByEvents.Empty();
 }
 
 // Event called when a semantic overlap event begins
@@ -0,0 +1,492 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventJournal.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#if SL_WITH_LIBMONGO_C
+THIRD_PARTY_INCLUDES_START
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include <mongoc/mongoc.h>
+	#include "Windows/HideWindowsPlatformTypes.h"
+#else
+	#include <mongoc/mongoc.h>
+#endif // #if PLATFORM_WINDOWS
+THIRD_PARTY_INCLUDES_END
+#endif //SL_WITH_LIBMONGO_C
+
+// Journal file constants
+static const uint32 SLEventJournalMagic = 0x56454C53;		// "SLEV"
+static const uint32 SLEventJournalVersion = 2;
+static const int32 SLEventJournalWriteChunkSize = 64 * 1024;
+static const double SLEventJournalMaxWriteDelay = 1.0;
+static const int32 SLEventJournalMongoBulkSize = 1000;
+
+// Append the raw bytes of the value to the buffer
+template<typename T>
+static void SLAppendJournalValue(TArray<uint8>& Buffer, const T& Value)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+}
+
+// Append the string as length prefixed UTF-8
+static void SLAppendJournalString(TArray<uint8>& Buffer, const FString& Str)
+{
+	FTCHARToUTF8 Conv(*Str);
+	SLAppendJournalValue(Buffer, (uint32)Conv.Length());
+	Buffer.Append(reinterpret_cast<const uint8*>(Conv.Get()), Conv.Length());
+}
+
+// Read the raw bytes of the value from the data (false if out of bounds)
+template<typename T>
+static bool SLReadJournalValue(const TArray<uint8>& Data, int32& InOutOffset, T& OutValue)
+{
+	if (InOutOffset < 0 || InOutOffset + (int32)sizeof(T) > Data.Num())
+	{
+		return false;
+	}
+	FMemory::Memcpy(&OutValue, Data.GetData() + InOutOffset, sizeof(T));
+	InOutOffset += sizeof(T);
+	return true;
+}
+
+// Read a length prefixed UTF-8 string from the data (false if out of bounds)
+static bool SLReadJournalString(const TArray<uint8>& Data, int32& InOutOffset, FString& OutStr)
+{
+	uint32 Len;
+	if (!SLReadJournalValue(Data, InOutOffset, Len) || InOutOffset + (int64)Len > Data.Num())
+	{
+		return false;
+	}
+	FUTF8ToTCHAR Conv(reinterpret_cast<const ANSICHAR*>(Data.GetData() + InOutOffset), Len);
+	OutStr = FString(Conv.Length(), Conv.Get());
+	InOutOffset += Len;
+	return true;
+}
+
+// Read a count prefixed array of strings from the data (false if out of bounds)
+static bool SLReadJournalStrings(const TArray<uint8>& Data, int32& InOutOffset, TArray<FString>& OutStrs)
+{
+	uint32 Num;
+	if (!SLReadJournalValue(Data, InOutOffset, Num) || Num > (uint32)(Data.Num() - InOutOffset) / sizeof(uint32))
+	{
+		return false;
+	}
+	OutStrs.SetNum(Num);
+	for (auto& Str : OutStrs)
+	{
+		if (!SLReadJournalString(Data, InOutOffset, Str))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Journal writer */
+// Ctor
+FSLEventJournal::FSLEventJournal() : OwlWriter(1)
+{
+	FileHandle = nullptr;
+	bWriteFailed = false;
+	NumWrittenBytes = 0;
+	NumRecords = 0;
+	LastWriteTime = 0.0;
+}
+
+// Dtor
+FSLEventJournal::~FSLEventJournal()
+{
+	if (FileHandle)
+	{
+		Close();
+	}
+}
+
+// Create the journal file
+bool FSLEventJournal::Open(const FString& InFilePath, bool bOverwrite)
+{
+	if (FileHandle)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Event journal %s is already open.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+	FilePath = InFilePath;
+	FPaths::RemoveDuplicateSlashes(FilePath);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.FileExists(*FilePath) && !bOverwrite)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Event journal %s already exists and should not be overwritten.."),
+			*FString(__func__), __LINE__, *FilePath);
+		return false;
+	}
+
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+	FileHandle = PlatformFile.OpenWrite(*FilePath);
+	if (FileHandle == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."),
+			*FString(__func__), __LINE__, *FilePath);
+		return false;
+	}
+
+	bWriteFailed = false;
+	NumWrittenBytes = 0;
+	NumRecords = 0;
+	WriteBuffer.Empty(SLEventJournalWriteChunkSize);
+	SLAppendJournalValue(WriteBuffer, SLEventJournalMagic);
+	SLAppendJournalValue(WriteBuffer, SLEventJournalVersion);
+	return WriteOut();
+}
+
+// Serialize the finished event and append it to the journal
+void FSLEventJournal::Append(const ISLEvent& Event)
+{
+	if (FileHandle == nullptr)
+	{
+		return;
+	}
+
+	// The record size is patched after the fields are written
+	const int32 RecordBegin = WriteBuffer.Num();
+	SLAppendJournalValue(WriteBuffer, (uint32)0);
+	SLAppendJournalValue(WriteBuffer, Event.StartTime);
+	SLAppendJournalValue(WriteBuffer, Event.EndTime);
+	SLAppendJournalString(WriteBuffer, Event.Id);
+	SLAppendJournalString(WriteBuffer, Event.TypeName());
+	SLAppendJournalString(WriteBuffer, Event.Context());
+	SLAppendJournalString(WriteBuffer, Event.Tooltip());
+
+	// Participants and type specific values, used by the event store columns
+	ParticipantsBuffer.Reset();
+	Event.GetParticipants(ParticipantsBuffer);
+	ParticipantsBuffer.Remove(nullptr);
+	SLAppendJournalValue(WriteBuffer, (uint32)ParticipantsBuffer.Num());
+	for (const auto& Individual : ParticipantsBuffer)
+	{
+		SLAppendJournalString(WriteBuffer, Individual->GetIdValue());
+	}
+	FSLEventTypedValues TypedValues;
+	Event.GetTypedValues(TypedValues);
+	SLAppendJournalValue(WriteBuffer, TypedValues.PairId);
+	SLAppendJournalString(WriteBuffer, TypedValues.SubType);
+	SLAppendJournalValue(WriteBuffer, TypedValues.TaskSuccess);
+
+	OwlWriter.Reset();
+	OwlWriter.WriteNode(Event.ToOwlNode());
+	SLAppendJournalString(WriteBuffer, OwlWriter.GetBuffer());
+	const uint32 RecordSize = WriteBuffer.Num() - RecordBegin - sizeof(uint32);
+	FMemory::Memcpy(WriteBuffer.GetData() + RecordBegin, &RecordSize, sizeof(uint32));
+
+	NumRecords++;
+	Flush(false);
+}
+
+// Write the buffered records to disk if they are too many or too old
+void FSLEventJournal::Flush(bool bForce)
+{
+	if (WriteBuffer.Num() > 0 && (bForce || WriteBuffer.Num() >= SLEventJournalWriteChunkSize
+		|| FPlatformTime::Seconds() - LastWriteTime >= SLEventJournalMaxWriteDelay))
+	{
+		WriteOut();
+	}
+}
+
+// Write the remaining records and close the file
+void FSLEventJournal::Close()
+{
+	if (bWriteFailed)
+	{
+		// The journal was already closed by the failed write
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Event journal %s is incomplete, writing failed after %.2f kb (appended events=%d).."),
+			*FString(__FUNCTION__), __LINE__, *FilePath, NumWrittenBytes / 1024.0, NumRecords);
+		bWriteFailed = false;
+		return;
+	}
+
+	if (FileHandle == nullptr)
+	{
+		return;
+	}
+
+	if (!WriteOut())
+	{
+		// The failed write closed the journal
+		Close();
+		return;
+	}
+	delete FileHandle;
+	FileHandle = nullptr;
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Event journal %s: events=%d; kb=%.2f;"),
+		*FString(__FUNCTION__), __LINE__, *FilePath, NumRecords, NumWrittenBytes / 1024.0);
+}
+
+// Default journal file path of the task and episode
+FString FSLEventJournal::GetJournalFilePath(const FString& TaskId, const FString& EpisodeId)
+{
+	return FPaths::ProjectDir() + TEXT("/SL/Tasks/") + TaskId + TEXT("/") + EpisodeId + TEXT("_EV.slev");
+}
+
+// Write the buffered bytes to disk
+bool FSLEventJournal::WriteOut()
+{
+	LastWriteTime = FPlatformTime::Seconds();
+	if (FileHandle == nullptr || WriteBuffer.Num() == 0)
+	{
+		return FileHandle != nullptr;
+	}
+
+	if (!FileHandle->Write(WriteBuffer.GetData(), WriteBuffer.Num()))
+	{
+		// Appending after a partial write would corrupt the records, stop appending and close the journal
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %d bytes to %s, the journal is closed.."),
+			*FString(__func__), __LINE__, WriteBuffer.Num(), *FilePath);
+		bWriteFailed = true;
+		delete FileHandle;
+		FileHandle = nullptr;
+		WriteBuffer.Empty();
+		return false;
+	}
+	NumWrittenBytes += WriteBuffer.Num();
+	WriteBuffer.Reset();
+	return true;
+}
+
+
+/* Journal reader */
+// Ctor
+FSLEventJournalReader::FSLEventJournalReader()
+{
+	Reader = nullptr;
+	RecordsOffset = 0;
+	bTruncated = false;
+}
+
+// Dtor
+FSLEventJournalReader::~FSLEventJournalReader()
+{
+	Close();
+}
+
+// Open the file and check its header
+bool FSLEventJournalReader::Open(const FString& InFilePath)
+{
+	Close();
+	FilePath = InFilePath;
+	FPaths::RemoveDuplicateSlashes(FilePath);
+
+	Reader = IFileManager::Get().CreateFileReader(*FilePath);
+	if (Reader == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read %s.."), *FString(__func__), __LINE__, *FilePath);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	if (Reader->TotalSize() >= 2 * (int64)sizeof(uint32))
+	{
+		Reader->Serialize(&Magic, sizeof(uint32));
+		Reader->Serialize(&Version, sizeof(uint32));
+	}
+	if (Magic != SLEventJournalMagic || Version != SLEventJournalVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is not a valid event journal.."), *FString(__func__), __LINE__, *FilePath);
+		Close();
+		return false;
+	}
+	RecordsOffset = Reader->Tell();
+	return true;
+}
+
+// Close the file
+void FSLEventJournalReader::Close()
+{
+	if (Reader)
+	{
+		delete Reader;
+		Reader = nullptr;
+	}
+	RecordBuffer.Empty();
+	RecordsOffset = 0;
+	bTruncated = false;
+}
+
+// Go back to the first record
+bool FSLEventJournalReader::Rewind()
+{
+	if (Reader == nullptr)
+	{
+		return false;
+	}
+	Reader->Seek(RecordsOffset);
+	bTruncated = false;
+	return true;
+}
+
+// Read the next record (false at the end of the journal or at a cut record)
+bool FSLEventJournalReader::Next(FSLEventJournalRecord& OutRecord)
+{
+	if (Reader == nullptr || bTruncated)
+	{
+		return false;
+	}
+
+	const int64 Remaining = Reader->TotalSize() - Reader->Tell();
+	if (Remaining == 0)
+	{
+		return false;
+	}
+
+	uint32 RecordSize = 0;
+	if (Remaining < (int64)sizeof(uint32))
+	{
+		bTruncated = true;
+	}
+	else
+	{
+		Reader->Serialize(&RecordSize, sizeof(uint32));
+		bTruncated = RecordSize > Remaining - sizeof(uint32);
+	}
+	if (bTruncated)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d The last record of %s is incomplete, the journal was not closed properly.."),
+			*FString(__func__), __LINE__, *FilePath);
+		return false;
+	}
+
+	RecordBuffer.SetNumUninitialized(RecordSize, false);
+	Reader->Serialize(RecordBuffer.GetData(), RecordSize);
+
+	int32 Offset = 0;
+	bTruncated = !SLReadJournalValue(RecordBuffer, Offset, OutRecord.StartTime)
+		|| !SLReadJournalValue(RecordBuffer, Offset, OutRecord.EndTime)
+		|| !SLReadJournalString(RecordBuffer, Offset, OutRecord.Id)
+		|| !SLReadJournalString(RecordBuffer, Offset, OutRecord.TypeName)
+		|| !SLReadJournalString(RecordBuffer, Offset, OutRecord.Context)
+		|| !SLReadJournalString(RecordBuffer, Offset, OutRecord.Tooltip)
+		|| !SLReadJournalStrings(RecordBuffer, Offset, OutRecord.ParticipantIds)
+		|| !SLReadJournalValue(RecordBuffer, Offset, OutRecord.TypedValues.PairId)
+		|| !SLReadJournalString(RecordBuffer, Offset, OutRecord.TypedValues.SubType)
+		|| !SLReadJournalValue(RecordBuffer, Offset, OutRecord.TypedValues.TaskSuccess)
+		|| !SLReadJournalString(RecordBuffer, Offset, OutRecord.OwlNode);
+	if (bTruncated)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Invalid record in %s, stopping.."), *FString(__func__), __LINE__, *FilePath);
+		return false;
+	}
+	return true;
+}
+
+// Write the journal records as documents of the episode events collection (bulk inserts)
+bool FSLEventJournalReader::ImportToMongo(const FString& InFilePath,
+	const FSLLoggerLocationParams& InLocationParameters,
+	const FSLLoggerDBServerParams& InDBServerParameters)
+{
+#if SL_WITH_LIBMONGO_C
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	FSLEventJournalReader Journal;
+	if (!Journal.Open(InFilePath))
+	{
+		return false;
+	}
+
+	// Connect to the database
+	mongoc_init();
+	bson_error_t error;
+	const FString Uri = TEXT("mongodb://") + InDBServerParameters.Ip + TEXT(":") + FString::FromInt(InDBServerParameters.Port);
+	mongoc_client_t* client = mongoc_client_new(TCHAR_TO_UTF8(*Uri));
+	if (!client)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not connect to %s.."), *FString(__func__), __LINE__, *Uri);
+		mongoc_cleanup();
+		return false;
+	}
+	mongoc_client_set_appname(client, "SL_EventJournalImport");
+	const FString CollName = InLocationParameters.EpisodeId + TEXT(".events");
+	mongoc_collection_t* collection = mongoc_client_get_collection(client,
+		TCHAR_TO_UTF8(*InLocationParameters.TaskId), TCHAR_TO_UTF8(*CollName));
+	if (InLocationParameters.bOverwrite)
+	{
+		// Fails if the collection does not exist yet
+		mongoc_collection_drop(collection, NULL);
+	}
+
+	// Unordered bulks of flat event documents
+	bool bSuccess = true;
+	int32 NumDocs = 0;
+	int32 NumBulkDocs = 0;
+	mongoc_bulk_operation_t* bulk = nullptr;
+	FSLEventJournalRecord Record;
+	while (bSuccess)
+	{
+		const bool bHasRecord = Journal.Next(Record);
+		if (bHasRecord)
+		{
+			if (bulk == nullptr)
+			{
+				bson_t bulk_opts;
+				bson_init(&bulk_opts);
+				BSON_APPEND_BOOL(&bulk_opts, "ordered", false);
+				bulk = mongoc_collection_create_bulk_operation_with_opts(collection, &bulk_opts);
+				bson_destroy(&bulk_opts);
+				NumBulkDocs = 0;
+			}
+
+			bson_t* doc = bson_new();
+			BSON_APPEND_UTF8(doc, "id", TCHAR_TO_UTF8(*Record.Id));
+			BSON_APPEND_UTF8(doc, "type", TCHAR_TO_UTF8(*Record.TypeName));
+			BSON_APPEND_DOUBLE(doc, "start", Record.StartTime);
+			BSON_APPEND_DOUBLE(doc, "end", Record.EndTime);
+			BSON_APPEND_UTF8(doc, "context", TCHAR_TO_UTF8(*Record.Context));
+			BSON_APPEND_UTF8(doc, "tooltip", TCHAR_TO_UTF8(*Record.Tooltip));
+			BSON_APPEND_UTF8(doc, "owl", TCHAR_TO_UTF8(*Record.OwlNode));
+			mongoc_bulk_operation_insert(bulk, doc);
+			bson_destroy(doc);
+			NumBulkDocs++;
+		}
+
+		if (bulk && (!bHasRecord || NumBulkDocs >= SLEventJournalMongoBulkSize))
+		{
+			bson_t reply;
+			bSuccess = mongoc_bulk_operation_execute(bulk, &reply, &error) != 0;
+			if (bSuccess)
+			{
+				NumDocs += NumBulkDocs;
+			}
+			else
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Bulk insert of %d events failed, err.: %s"),
+					*FString(__func__), __LINE__, NumBulkDocs, *FString(error.message));
+			}
+			bson_destroy(&reply);
+			mongoc_bulk_operation_destroy(bulk);
+			bulk = nullptr;
+		}
+
+		if (!bHasRecord)
+		{
+			break;
+		}
+	}
+
+	mongoc_collection_destroy(collection);
+	mongoc_client_destroy(client);
+	mongoc_cleanup();
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Imported %d events from %s into %s.%s in %f seconds.."),
+		*FString(__FUNCTION__), __LINE__, NumDocs, *InFilePath,
+		*InLocationParameters.TaskId, *CollName, FPlatformTime::Seconds() - ExecBegin);
+	return bSuccess;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d SL_WITH_LIBMONGO_C flag is 0, aborting.."),
+		*FString(__func__), __LINE__);
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
@@ -0,0 +1,357 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Events/SLEventStore.h"
+#include "Events/SLEventJournal.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+// Store file constants
+static const uint32 SLEventStoreMagic = 0x53454C53;		// "SLES"
+static const uint32 SLEventStoreVersion = 2;
+
+// Index of the string, added if new
+int32 FSLEventStoreNames::Intern(const FString& Name)
+{
+	if (const int32* Idx = Indices.Find(Name))
+	{
+		return *Idx;
+	}
+	const int32 NewIdx = Names.Add(Name);
+	Indices.Add(Name, NewIdx);
+	return NewIdx;
+}
+
+// Index of the string, INDEX_NONE if not stored
+int32 FSLEventStoreNames::Find(const FString& Name) const
+{
+	const int32* Idx = Indices.Find(Name);
+	return Idx ? *Idx : INDEX_NONE;
+}
+
+// Remove all the strings
+void FSLEventStoreNames::Empty()
+{
+	Names.Empty();
+	Indices.Empty();
+}
+
+// Serialize the strings (the lookup is rebuilt when loading)
+void FSLEventStoreNames::Serialize(FArchive& Ar)
+{
+	Ar << Names;
+	if (Ar.IsLoading())
+	{
+		Indices.Empty(Names.Num());
+		for (int32 Idx = 0; Idx < Names.Num(); ++Idx)
+		{
+			Indices.Add(Names[Idx], Idx);
+		}
+	}
+}
+
+
+// Ctor
+FSLEventStore::FSLEventStore()
+{
+	ParticipantOffsets.Add(0);
+}
+
+// Fill the columns with the records of the journal and build the indexes, replaces the current events
+bool FSLEventStore::BuildFromJournal(FSLEventJournalReader& Journal)
+{
+	Empty();
+	if (!Journal.Rewind())
+	{
+		return false;
+	}
+
+	FSLEventJournalRecord Record;
+	while (Journal.Next(Record))
+	{
+		AddRecord(Record);
+	}
+	BuildParticipantIndex();
+	BuildTimeIndex();
+	return true;
+}
+
+// Remove all the events
+void FSLEventStore::Empty()
+{
+	TypeNames.Empty();
+	IndividualIds.Empty();
+	Contexts.Empty();
+	SubTypes.Empty();
+	Ids.Empty();
+	TypeIdxs.Empty();
+	StartTimes.Empty();
+	EndTimes.Empty();
+	ParticipantOffsets.Empty();
+	ParticipantOffsets.Add(0);
+	ParticipantIdxs.Empty();
+	ContextIdxs.Empty();
+	Tooltips.Empty();
+	PairIds.Empty();
+	SubTypeIdxs.Empty();
+	TaskSuccesses.Empty();
+	ParticipantEvents.Empty();
+	SortedEventIdxs.Empty();
+	SortedMaxEnds.Empty();
+}
+
+// Indices of the events overlapping the [StartTime, EndTime] range sorted by start time,
+// optionally only the ones of the given type and/or with the given participant (individual id)
+void FSLEventStore::Query(float InStartTime, float InEndTime, TArray<int32>& OutEventIdxs,
+	const FString& InTypeName, const FString& InParticipantId) const
+{
+	// Unknown type or participant, nothing can match
+	const int32 TypeIdx = InTypeName.IsEmpty() ? INDEX_NONE : TypeNames.Find(InTypeName);
+	const int32 IndividualIdx = InParticipantId.IsEmpty() ? INDEX_NONE : IndividualIds.Find(InParticipantId);
+	if ((!InTypeName.IsEmpty() && TypeIdx == INDEX_NONE)
+		|| (!InParticipantId.IsEmpty() && IndividualIdx == INDEX_NONE))
+	{
+		return;
+	}
+
+	// The events of a participant are usually far fewer than the ones in the time range
+	if (IndividualIdx != INDEX_NONE)
+	{
+		TArray<int32> ParticipantResults;
+		for (const int32 EventIdx : ParticipantEvents[IndividualIdx])
+		{
+			if (Matches(EventIdx, InStartTime, InEndTime, TypeIdx))
+			{
+				ParticipantResults.Add(EventIdx);
+			}
+		}
+		ParticipantResults.Sort([this](int32 A, int32 B)
+		{
+			return StartTimes[A] < StartTimes[B] || (StartTimes[A] == StartTimes[B] && A < B);
+		});
+		OutEventIdxs.Append(ParticipantResults);
+		return;
+	}
+
+	QueryTimeIndex(0, SortedEventIdxs.Num(), InStartTime, InEndTime, TypeIdx, OutEventIdxs);
+}
+
+// Indices of the events of the participant (individual id) sorted by start time
+void FSLEventStore::QueryParticipant(const FString& InParticipantId, TArray<int32>& OutEventIdxs) const
+{
+	Query(-MAX_FLT, MAX_FLT, OutEventIdxs, FString(), InParticipantId);
+}
+
+// Individual ids of the event participants
+void FSLEventStore::GetParticipantIds(int32 EventIdx, TArray<FString>& OutIds) const
+{
+	for (int32 Idx = ParticipantOffsets[EventIdx]; Idx < ParticipantOffsets[EventIdx + 1]; ++Idx)
+	{
+		OutIds.Add(IndividualIds.Get(ParticipantIdxs[Idx]));
+	}
+}
+
+// Write the columns to the binary file
+bool FSLEventStore::SaveToFile(const FString& InFilePath, bool bOverwrite)
+{
+	FString FilePath = InFilePath;
+	FPaths::RemoveDuplicateSlashes(FilePath);
+	if (FPaths::FileExists(FilePath) && !bOverwrite)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Event store %s already exists and should not be overwritten.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	uint32 Magic = SLEventStoreMagic;
+	uint32 Version = SLEventStoreVersion;
+	*Writer << Magic << Version;
+	SerializeColumns(*Writer);
+
+	const bool bSuccess = Writer->Close() && !Writer->IsError();
+	if (!bSuccess)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+	}
+	return bSuccess;
+}
+
+// Load the columns from the binary file, replaces the current events
+bool FSLEventStore::LoadFromFile(const FString& InFilePath)
+{
+	FString FilePath = InFilePath;
+	FPaths::RemoveDuplicateSlashes(FilePath);
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+	if (!Reader.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for reading.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic << Version;
+	if (Magic != SLEventStoreMagic || Version != SLEventStoreVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is not an event store (or has an unknown version %u).."),
+			*FString(__FUNCTION__), __LINE__, *FilePath, Version);
+		return false;
+	}
+
+	Empty();
+	SerializeColumns(*Reader);
+
+	// All the columns should have one entry per event
+	const int32 NumEvents = Ids.Num();
+	if (Reader->IsError() || TypeIdxs.Num() != NumEvents || StartTimes.Num() != NumEvents || EndTimes.Num() != NumEvents
+		|| ContextIdxs.Num() != NumEvents || Tooltips.Num() != NumEvents || PairIds.Num() != NumEvents
+		|| SubTypeIdxs.Num() != NumEvents || TaskSuccesses.Num() != NumEvents || ParticipantOffsets.Num() != NumEvents + 1
+		|| ParticipantOffsets[0] != 0 || ParticipantOffsets.Last() != ParticipantIdxs.Num() || !BuildParticipantIndex())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is corrupted.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		Empty();
+		return false;
+	}
+	BuildTimeIndex();
+	return true;
+}
+
+// Default store file path of the task and episode
+FString FSLEventStore::GetStoreFilePath(const FString& TaskId, const FString& EpisodeId)
+{
+	return FPaths::ProjectDir() + TEXT("/SL/Tasks/") + TaskId + TEXT("/") + EpisodeId + TEXT("_EV.sles");
+}
+
+// Append the journal record to the columns (the indexes are built after all the records are added)
+void FSLEventStore::AddRecord(const FSLEventJournalRecord& Record)
+{
+	Ids.Add(Record.Id);
+	TypeIdxs.Add(TypeNames.Intern(Record.TypeName));
+	StartTimes.Add(Record.StartTime);
+	EndTimes.Add(Record.EndTime);
+
+	// An individual is stored once even if it has multiple roles in the event
+	TArray<int32, TInlineAllocator<4>> EventParticipantIdxs;
+	for (const auto& ParticipantId : Record.ParticipantIds)
+	{
+		EventParticipantIdxs.AddUnique(IndividualIds.Intern(ParticipantId));
+	}
+	ParticipantIdxs.Append(EventParticipantIdxs);
+	ParticipantOffsets.Add(ParticipantIdxs.Num());
+
+	ContextIdxs.Add(Contexts.Intern(Record.Context));
+	Tooltips.Add(Record.Tooltip);
+	PairIds.Add(Record.TypedValues.PairId);
+	SubTypeIdxs.Add(SubTypes.Intern(Record.TypedValues.SubType));
+	TaskSuccesses.Add(Record.TypedValues.TaskSuccess);
+}
+
+// Serialize the dictionaries and the columns (the indexes are not stored)
+void FSLEventStore::SerializeColumns(FArchive& Ar)
+{
+	TypeNames.Serialize(Ar);
+	IndividualIds.Serialize(Ar);
+	Contexts.Serialize(Ar);
+	SubTypes.Serialize(Ar);
+	Ar << Ids << TypeIdxs << StartTimes << EndTimes
+		<< ParticipantOffsets << ParticipantIdxs << ContextIdxs << Tooltips
+		<< PairIds << SubTypeIdxs << TaskSuccesses;
+}
+
+// Build the participant postings from the participant columns (false if the columns are inconsistent)
+bool FSLEventStore::BuildParticipantIndex()
+{
+	if (ParticipantOffsets.Num() != Ids.Num() + 1 || ParticipantOffsets[0] != 0)
+	{
+		return false;
+	}
+
+	ParticipantEvents.Empty(IndividualIds.Num());
+	ParticipantEvents.SetNum(IndividualIds.Num());
+	for (int32 EventIdx = 0; EventIdx < Ids.Num(); ++EventIdx)
+	{
+		// The offsets should be monotonic and within the participants column before they are used for indexing
+		if (ParticipantOffsets[EventIdx + 1] < ParticipantOffsets[EventIdx]
+			|| ParticipantOffsets[EventIdx + 1] > ParticipantIdxs.Num()
+			|| !TypeNames.IsValidIndex(TypeIdxs[EventIdx]) || !Contexts.IsValidIndex(ContextIdxs[EventIdx])
+			|| !SubTypes.IsValidIndex(SubTypeIdxs[EventIdx]))
+		{
+			return false;
+		}
+		for (int32 Idx = ParticipantOffsets[EventIdx]; Idx < ParticipantOffsets[EventIdx + 1]; ++Idx)
+		{
+			if (!ParticipantEvents.IsValidIndex(ParticipantIdxs[Idx]))
+			{
+				return false;
+			}
+			ParticipantEvents[ParticipantIdxs[Idx]].Add(EventIdx);
+		}
+	}
+	return true;
+}
+
+// Sort the events by start time and compute the subtree max end times (implicit interval tree)
+void FSLEventStore::BuildTimeIndex()
+{
+	SortedEventIdxs.SetNumUninitialized(Ids.Num());
+	for (int32 Idx = 0; Idx < SortedEventIdxs.Num(); ++Idx)
+	{
+		SortedEventIdxs[Idx] = Idx;
+	}
+	SortedEventIdxs.Sort([this](int32 A, int32 B)
+	{
+		return StartTimes[A] < StartTimes[B] || (StartTimes[A] == StartTimes[B] && A < B);
+	});
+	SortedMaxEnds.SetNumUninitialized(SortedEventIdxs.Num());
+	BuildMaxEnd(0, SortedEventIdxs.Num());
+}
+
+// Collect the events of the implicit interval tree node range overlapping [InStartTime, InEndTime]
+void FSLEventStore::QueryTimeIndex(int32 Lo, int32 Hi, float InStartTime, float InEndTime, int32 TypeIdx, TArray<int32>& OutEventIdxs) const
+{
+	if (Lo >= Hi)
+	{
+		return;
+	}
+
+	// No event of the range ends after the query start
+	const int32 Mid = Lo + (Hi - Lo) / 2;
+	if (SortedMaxEnds[Mid] < InStartTime)
+	{
+		return;
+	}
+
+	QueryTimeIndex(Lo, Mid, InStartTime, InEndTime, TypeIdx, OutEventIdxs);
+
+	// The node and the right range start after the query end
+	const int32 EventIdx = SortedEventIdxs[Mid];
+	if (StartTimes[EventIdx] > InEndTime)
+	{
+		return;
+	}
+	if (Matches(EventIdx, InStartTime, InEndTime, TypeIdx))
+	{
+		OutEventIdxs.Add(EventIdx);
+	}
+
+	QueryTimeIndex(Mid + 1, Hi, InStartTime, InEndTime, TypeIdx, OutEventIdxs);
+}
+
+// Compute the max end time of the node range, returns it
+float FSLEventStore::BuildMaxEnd(int32 Lo, int32 Hi)
+{
+	if (Lo >= Hi)
+	{
+		return -MAX_FLT;
+	}
+	const int32 Mid = Lo + (Hi - Lo) / 2;
+	SortedMaxEnds[Mid] = FMath::Max3(EndTimes[SortedEventIdxs[Mid]], BuildMaxEnd(Lo, Mid), BuildMaxEnd(Mid + 1, Hi));
+	return SortedMaxEnds[Mid];
+}
@@ -68,30 +68,25 @@ void FSLGraspEventHandler::AddNewEvent(USLBaseIndividual* Self, USLBaseIndividua
 		FSLUuid::PairEncodeCantor(Self->GetUniqueID(), Other->GetUniqueID()),
 		Self, Other, InType));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending array
-	StartedEvents.Emplace(Event);
+	// Add event to the pending events (indexed by the grasped individual)
+	StartedEvents.Add(Other, Event);
 }
 
 // Publish finished event
 bool FSLGraspEventHandler::FinishEvent(USLBaseIndividual* Other, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
+	// It is enough to search by the other individual, the oldest started event is finished first
+	TSharedPtr<FSLGraspEvent> Event;
+	if (StartedEvents.RemoveOldest(Other, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual == Other)
+		// Ignore short events
+		if ((EndTime - Event->StartTime) > GraspEventMin)
 		{
-			// Ignore short events
-			if ((EndTime - (*EventItr)->StartTime) > GraspEventMin)
-			{
-				// Set end time and publish event
-				(*EventItr)->EndTime = EndTime;
-				OnSemanticEvent.ExecuteIfBound(*EventItr);
-			}
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
+			// Set end time and publish event
+			Event->EndTime = EndTime;
+			OnSemanticEvent.ExecuteIfBound(Event);
 		}
+		return true;
 	}
 	return false;
 }
@@ -99,8 +94,10 @@ bool FSLGraspEventHandler::FinishEvent(USLBaseIndividual* Other, float EndTime)
 // Terminate and publish pending events (this usually is called at end play)
 void FSLGraspEventHandler::FinishAllEvents(float EndTime)
 {
-	// Finish events
-	for (auto& Ev : StartedEvents)
+	// Finish events (in the order they started)
+	TArray<TSharedPtr<FSLGraspEvent>> Events;
+	StartedEvents.RemoveAll(Events);
+	for (auto& Ev : Events)
 	{
 		// Ignore short events
 		if ((EndTime - Ev->StartTime) > GraspEventMin)
@@ -110,7 +107,6 @@ void FSLGraspEventHandler::FinishAllEvents(float EndTime)
 			OnSemanticEvent.ExecuteIfBound(Ev);
 		}
 	}
-	StartedEvents.Empty();
 }
 
 
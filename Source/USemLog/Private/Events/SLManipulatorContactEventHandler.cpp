@@ -69,28 +69,22 @@ void FSLManipulatorContactEventHandler::AddNewEvent(const FSLContactResult& InRe
 		FSLUuid::PairEncodeCantor(InResult.Self->GetUniqueID(), InResult.Other->GetUniqueID()),
 		InResult.Self, InResult.Other));
 	Event->EpisodeId = EpisodeId;
-	// Add event to the pending contacts array
-	StartedEvents.Emplace(Event);
+	// Add event to the pending contacts (indexed by the other individual)
+	StartedEvents.Add(InResult.Other, Event);
 }
 
 // Publish finished event
 bool FSLManipulatorContactEventHandler::FinishEvent(USLBaseIndividual* InOther, float EndTime)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto EventItr(StartedEvents.CreateIterator()); EventItr; ++EventItr)
+	// It is enough to search by the other individual, the oldest started event is finished first
+	TSharedPtr<FSLContactEvent> Event;
+	if (StartedEvents.RemoveOldest(InOther, Event))
 	{
-		// It is enough to compare against the other id when searching
-		if ((*EventItr)->Individual2 == InOther)
-		{
-			// Set the event end time
-			(*EventItr)->EndTime = EndTime;
-
-			OnSemanticEvent.ExecuteIfBound(*EventItr);
+		// Set the event end time
+		Event->EndTime = EndTime;
 
-			// Remove event from the pending list
-			EventItr.RemoveCurrent();
-			return true;
-		}
+		OnSemanticEvent.ExecuteIfBound(Event);
+		return true;
 	}
 	return false;
 }
@@ -98,14 +92,15 @@ bool FSLManipulatorContactEventHandler::FinishEvent(USLBaseIndividual* InOther,
 // Terminate and publish pending contact events (this usually is called at end play)
 void FSLManipulatorContactEventHandler::FinishAllEvents(float EndTime)
 {
-	// Finish contact events
-	for (auto& Ev : StartedEvents)
+	// Finish contact events (in the order they started)
+	TArray<TSharedPtr<FSLContactEvent>> Events;
+	StartedEvents.RemoveAll(Events);
+	for (auto& Ev : Events)
 	{
 		// Set end time and publish event
 		Ev->EndTime = EndTime;
 		OnSemanticEvent.ExecuteIfBound(Ev);
 	}
-	StartedEvents.Empty();
 }
 
 
@@ -178,4 +178,17 @@ FString FSLSlicingEvent::ToString() const
 			*PerformedBy->GetInfo(), *DeviceUsed->GetInfo(), *ObjectActedOn->GetInfo(), PairId);
 	}
 }
+
+// Get the individuals taking part in the event
+void FSLSlicingEvent::GetParticipants(TArray<USLBaseIndividual*>& OutParticipants) const
+{
+	OutParticipants.Add(PerformedBy);
+	OutParticipants.Add(DeviceUsed);
+	OutParticipants.Add(ObjectActedOn);
+	if (bTaskSuccessful)
+	{
+		// The slice only exists if the task was successful
+		OutParticipants.Add(CreatedSlice);
+	}
+}
 /* End ISLEvent interface */
\ No newline at end of file
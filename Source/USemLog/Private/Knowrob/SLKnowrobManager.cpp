@@ -13,6 +13,11 @@
 #include "Components/InputComponent.h"
 #include "Runtime/SLSymbolicLogger.h"
 #include "Runtime/SLWorldStateLogger.h"
+#include "Runtime/SLWorldStateFileSink.h"
+#include "Events/SLEventJournal.h"
+#include "Events/SLEventStore.h"
+#include "Events/SLContactEventHandler.h"
+#include "Owl/SLOwlExperimentStatics.h"
 #include "TimerManager.h"
 
 #if WITH_EDITOR
@@ -169,6 +174,54 @@ void ASLKnowrobManager::PostEditChangeProperty(struct FPropertyChangedEvent& Pro
         SymbolicLogger->Finish();
 		WorldStateLogger->Finish();
     }
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLKnowrobManager, bImportEpisodeFileButtonHack))
+	{
+		bImportEpisodeFileButtonHack = false;
+		const FString FilePath = FSLWorldStateFileSink::GetEpisodeFilePath(LocationParameters.TaskId, LocationParameters.EpisodeId);
+		if (!FSLWorldStateEpisodeFileReader::ImportToMongo(FilePath, WorldStateLoggerParameters, LocationParameters, DBServerParameters))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d %s could not import the episode file %s.."),
+				*FString(__FUNCTION__), __LINE__, *GetName(), *FilePath);
+		}
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLKnowrobManager, bImportEventJournalButtonHack))
+	{
+		bImportEventJournalButtonHack = false;
+		const FString FilePath = FSLEventJournal::GetJournalFilePath(LocationParameters.TaskId, LocationParameters.EpisodeId);
+		if (!FSLEventJournalReader::ImportToMongo(FilePath, LocationParameters, DBServerParameters))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d %s could not import the event journal %s.."),
+				*FString(__FUNCTION__), __LINE__, *GetName(), *FilePath);
+		}
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLKnowrobManager, bQueryEventStoreButtonHack))
+	{
+		bQueryEventStoreButtonHack = false;
+		QueryEventStore(LocationParameters.TaskId, LocationParameters.EpisodeId,
+			EventQueryStartTime, EventQueryEndTime, EventQueryTypeName, EventQueryParticipantId);
+	}
+
+	/* Benchmarks */
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLKnowrobManager, bBenchmarkBonePosesButtonHack))
+	{
+		bBenchmarkBonePosesButtonHack = false;
+		if (!VizManager || !VizManager->IsValidLowLevel() || VizManager->IsPendingKillOrUnreachable() || !VizManager->IsInit())
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Viz manager is not valid or not init.. "), *FString(__FUNCTION__), __LINE__);
+			return;
+		}
+		VizManager->BenchmarkBonePoses(BenchmarkNumIterations);
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLKnowrobManager, bBenchmarkOwlWriterButtonHack))
+	{
+		bBenchmarkOwlWriterButtonHack = false;
+		FSLOwlExperimentStatics::BenchmarkWriter(BenchmarkNumEvents);
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(ASLKnowrobManager, bBenchmarkPendingEventsButtonHack))
+	{
+		bBenchmarkPendingEventsButtonHack = false;
+		FSLContactEventHandler::BenchmarkPendingEvents(BenchmarkNumContacts);
+	}
 }
 #endif // WITH_EDITOR
 
@@ -402,6 +455,44 @@ ASLKnowrobManager* ASLKnowrobManager::GetExistingOrSpawnNew(UWorld* World)
 	return Manager;
 }
 
+// Load the event store file of the task and episode and log the events overlapping the time range,
+// optionally only the ones of the given type and/or with the given participant (individual id)
+bool ASLKnowrobManager::QueryEventStore(const FString& TaskId, const FString& EpisodeId, float StartTime, float EndTime,
+	const FString& TypeName, const FString& ParticipantId) const
+{
+	FSLEventStore EventStore;
+	if (!EventStore.LoadFromFile(FSLEventStore::GetStoreFilePath(TaskId, EpisodeId)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s could not load the event store of %s/%s.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *TaskId, *EpisodeId);
+		return false;
+	}
+
+	// An inverted time range returns all the events of the participant (participant index only)
+	TArray<int32> EventIdxs;
+	if (StartTime > EndTime && !ParticipantId.IsEmpty() && TypeName.IsEmpty())
+	{
+		EventStore.QueryParticipant(ParticipantId, EventIdxs);
+	}
+	else
+	{
+		EventStore.Query(StartTime, EndTime, EventIdxs, TypeName, ParticipantId);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d %s event store query [%f, %f] type=%s participant=%s returned %d/%d events:"),
+		*FString(__FUNCTION__), __LINE__, *GetName(), StartTime, EndTime, *TypeName, *ParticipantId, EventIdxs.Num(), EventStore.Num());
+	TArray<FString> ParticipantIds;
+	for (const int32 EventIdx : EventIdxs)
+	{
+		ParticipantIds.Reset();
+		EventStore.GetParticipantIds(EventIdx, ParticipantIds);
+		UE_LOG(LogTemp, Log, TEXT("\t %s %s [%f, %f] participants=[%s];"),
+			*EventStore.GetTypeName(EventIdx), *EventStore.GetId(EventIdx), EventStore.GetStartTime(EventIdx),
+			EventStore.GetEndTime(EventIdx), *FString::Join(ParticipantIds, TEXT(", ")));
+	}
+	return true;
+}
+
 // Setup user input bindings
 void ASLKnowrobManager::SetupInputBindings()
 {
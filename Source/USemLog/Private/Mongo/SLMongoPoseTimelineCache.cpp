@@ -0,0 +1,226 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Mongo/SLMongoPoseTimelineCache.h"
+#include "Algo/BinarySearch.h"
+
+/* Timeline */
+// Index of the last entry at or before the given time (INDEX_NONE if the timeline starts later)
+int32 FSLMongoPoseTimeline::FindFloor(float Ts) const
+{
+	return Algo::UpperBound(Timestamps, Ts) - 1;
+}
+
+// Get the last pose at or before the given time (false if the timeline starts later)
+bool FSLMongoPoseTimeline::GetPoseAt(float Ts, FTransform& OutPose) const
+{
+	const int32 Idx = FindFloor(Ts);
+	if (Idx == INDEX_NONE)
+	{
+		return false;
+	}
+	OutPose = Poses[Idx];
+	return true;
+}
+
+// Get the poses between the given timestamps, consecutive poses are at least DeltaT apart if DeltaT is positive
+void FSLMongoPoseTimeline::GetTrajectory(float StartTs, float EndTs, float DeltaT, TArray<FTransform>& OutPoses) const
+{
+	const int32 BeginIdx = Algo::LowerBound(Timestamps, StartTs);
+	const int32 EndIdx = Algo::UpperBound(Timestamps, EndTs);
+	if (BeginIdx >= EndIdx)
+	{
+		return;
+	}
+
+	if (DeltaT > 0.f)
+	{
+		float PrevTs = -BIG_NUMBER;
+		for (int32 Idx = BeginIdx; Idx < EndIdx; ++Idx)
+		{
+			if (Timestamps[Idx] - PrevTs > DeltaT)
+			{
+				OutPoses.Add(Poses[Idx]);
+				PrevTs = Timestamps[Idx];
+			}
+		}
+	}
+	else
+	{
+		OutPoses.Append(Poses.GetData() + BeginIdx, EndIdx - BeginIdx);
+	}
+}
+
+
+/* Episode timelines */
+// Build the timelines from the (time sorted) episode frames
+void FSLMongoEpisodeTimelines::Build(const FSLMongoEpisodeFrames& EpisodeFrames)
+{
+	// Interned index to timeline
+	TArray<FSLMongoPoseTimeline> IdxTimelines;
+	IdxTimelines.SetNum(EpisodeFrames.Ids.Num());
+	for (int32 FrameIdx = 0; FrameIdx < EpisodeFrames.NumFrames(); ++FrameIdx)
+	{
+		const float Ts = EpisodeFrames.Timestamps[FrameIdx];
+		for (int32 EntryIdx = EpisodeFrames.FrameOffsets[FrameIdx]; EntryIdx < EpisodeFrames.FrameOffsets[FrameIdx + 1]; ++EntryIdx)
+		{
+			FSLMongoPoseTimeline& Timeline = IdxTimelines[EpisodeFrames.EntryIdxs[EntryIdx]];
+			Timeline.Timestamps.Add(Ts);
+			Timeline.Poses.Add(EpisodeFrames.EntryPoses[EntryIdx]);
+		}
+	}
+
+	Timelines.Empty(IdxTimelines.Num());
+	for (int32 Idx = 0; Idx < IdxTimelines.Num(); ++Idx)
+	{
+		if (IdxTimelines[Idx].Timestamps.Num() > 0)
+		{
+			Timelines.Emplace(EpisodeFrames.Ids[Idx], MoveTemp(IdxTimelines[Idx]));
+		}
+	}
+
+	NumBytes = Timelines.GetAllocatedSize();
+	for (auto& IdTimelinePair : Timelines)
+	{
+		IdTimelinePair.Value.Timestamps.Shrink();
+		IdTimelinePair.Value.Poses.Shrink();
+		NumBytes += IdTimelinePair.Key.GetAllocatedSize() + IdTimelinePair.Value.GetAllocatedSize();
+	}
+}
+
+// Get the pose of the individual at the given time (same as the database query, identity if not found)
+FTransform FSLMongoEpisodeTimelines::GetIndividualPoseAt(const FString& Id, float Ts) const
+{
+	FTransform Pose;
+	if (const FSLMongoPoseTimeline* Timeline = Timelines.Find(Id))
+	{
+		Timeline->GetPoseAt(Ts, Pose);
+	}
+	return Pose;
+}
+
+// Get the poses of the individual between the given timestamps (same as the database query)
+TArray<FTransform> FSLMongoEpisodeTimelines::GetIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT) const
+{
+	TArray<FTransform> Trajectory;
+	if (const FSLMongoPoseTimeline* Timeline = Timelines.Find(Id))
+	{
+		Timeline->GetTrajectory(StartTs, EndTs, DeltaT, Trajectory);
+	}
+	if (Trajectory.Num() == 0)
+	{
+		Trajectory.Add(GetIndividualPoseAt(Id, StartTs));
+	}
+	return Trajectory;
+}
+
+
+/* Cache */
+// Ctor
+FSLMongoPoseTimelineCache::FSLMongoPoseTimelineCache()
+{
+	MaxBytes = 512 * 1024 * 1024;
+	NumBytes = 0;
+}
+
+// Dtor
+FSLMongoPoseTimelineCache::~FSLMongoPoseTimelineCache()
+{
+	Empty();
+}
+
+// Set the memory budget, evicts episodes if it is exceeded
+void FSLMongoPoseTimelineCache::SetMaxMemory(int64 InMaxBytes)
+{
+	// Previously oversized episodes might fit in a larger budget
+	if (InMaxBytes > MaxBytes)
+	{
+		OversizedKeys.Empty();
+	}
+	MaxBytes = InMaxBytes;
+	Evict(0);
+}
+
+// Get the cached episode and mark it as most recently used (nullptr if not cached)
+const FSLMongoEpisodeTimelines* FSLMongoPoseTimelineCache::Find(const FString& TaskId, const FString& EpisodeId)
+{
+	const FString Key = GetKey(TaskId, EpisodeId);
+	FSLMongoEpisodeTimelines** EpisodeTimelines = Episodes.Find(Key);
+	if (EpisodeTimelines == nullptr)
+	{
+		return nullptr;
+	}
+	LruKeys.Remove(Key);
+	LruKeys.Add(Key);
+	return *EpisodeTimelines;
+}
+
+// Build and cache the episode timelines (nullptr if the episode does not fit in the memory budget)
+const FSLMongoEpisodeTimelines* FSLMongoPoseTimelineCache::Add(const FString& TaskId, const FString& EpisodeId,
+	const FSLMongoEpisodeFrames& EpisodeFrames)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+	const FString Key = GetKey(TaskId, EpisodeId);
+
+	FSLMongoEpisodeTimelines* EpisodeTimelines = new FSLMongoEpisodeTimelines();
+	EpisodeTimelines->Build(EpisodeFrames);
+	if ((int64)EpisodeTimelines->NumBytes > MaxBytes)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s needs %.2f MB, more than the pose cache budget of %.2f MB, it will not be cached.."),
+			*FString(__FUNCTION__), __LINE__, *Key, EpisodeTimelines->NumBytes / (1024.0 * 1024.0), MaxBytes / (1024.0 * 1024.0));
+		delete EpisodeTimelines;
+		OversizedKeys.Add(Key);
+		return nullptr;
+	}
+
+	// Replace any previous version of the episode
+	if (FSLMongoEpisodeTimelines** PrevEpisodeTimelines = Episodes.Find(Key))
+	{
+		NumBytes -= (*PrevEpisodeTimelines)->NumBytes;
+		delete *PrevEpisodeTimelines;
+		Episodes.Remove(Key);
+		LruKeys.Remove(Key);
+	}
+
+	Evict(EpisodeTimelines->NumBytes);
+	Episodes.Add(Key, EpisodeTimelines);
+	LruKeys.Add(Key);
+	NumBytes += EpisodeTimelines->NumBytes;
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Cached episode %s: individuals=%d; mb=%.2f (total=%.2f, episodes=%d); duration=[%f] seconds..;"),
+		*FString(__FUNCTION__), __LINE__, *Key, EpisodeTimelines->Timelines.Num(), EpisodeTimelines->NumBytes / (1024.0 * 1024.0),
+		NumBytes / (1024.0 * 1024.0), Episodes.Num(), FPlatformTime::Seconds() - ExecBegin);
+	return EpisodeTimelines;
+}
+
+// Remove all cached episodes
+void FSLMongoPoseTimelineCache::Empty()
+{
+	for (auto& KeyEpisodePair : Episodes)
+	{
+		delete KeyEpisodePair.Value;
+	}
+	Episodes.Empty();
+	LruKeys.Empty();
+	OversizedKeys.Empty();
+	NumBytes = 0;
+}
+
+// Remove the least recently used episodes until the extra bytes fit in the budget
+void FSLMongoPoseTimelineCache::Evict(int64 NumExtraBytes)
+{
+	while (LruKeys.Num() > 0 && NumBytes + NumExtraBytes > MaxBytes)
+	{
+		const FString Key = LruKeys[0];
+		LruKeys.RemoveAt(0);
+
+		FSLMongoEpisodeTimelines* EpisodeTimelines = nullptr;
+		if (Episodes.RemoveAndCopyValue(Key, EpisodeTimelines))
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Evicting episode %s from the pose cache (%.2f MB).."),
+				*FString(__FUNCTION__), __LINE__, *Key, EpisodeTimelines->NumBytes / (1024.0 * 1024.0));
+			NumBytes -= EpisodeTimelines->NumBytes;
+			delete EpisodeTimelines;
+		}
+	}
+}
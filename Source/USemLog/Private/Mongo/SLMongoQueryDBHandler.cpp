@@ -2,6 +2,8 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "Mongo/SLMongoQueryDBHandler.h"
+#include "Runtime/SLWorldStatePoseCodec.h"
+#include "Async/Async.h"
 
 #if SL_WITH_ROS_CONVERSIONS
 #include "Conversions.h"
@@ -188,6 +190,13 @@ bool FSLMongoQueryDBHandler::SetCollection(const FString& InCollName)
 	// Set collection
 	collection = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*InCollName));
 	bCollectionSet = true;
+
+	// Check if the poses are stored packed
+	if (LoadPoseTable())
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Collection %s stores packed poses (encoding=%d, ids=%d).."),
+			*FString(__func__), __LINE__, *InCollName, (int32)PoseTable.Encoding, PoseTable.Ids.Num());
+	}
 	return true;
 #else
 	UE_LOG(LogTemp, Error, TEXT("%s::%d Mongo module is missing.."), *FString(__func__), __LINE__);
@@ -202,6 +211,7 @@ void FSLMongoQueryDBHandler::Disconnect()
 	bConnected = false;
 	bDatabaseSet = false;
 	bCollectionSet = false;
+	PoseTable.Empty();
 
 #if SL_WITH_LIBMONGO_C
 	// Release handles and clean up libmongoc
@@ -241,8 +251,16 @@ FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float
 	}
 
 #if SL_WITH_LIBMONGO_C	
+	if (PoseTable.IsPacked())
+	{
+		return GetPackedIndividualPoseAt(Id, Ts);
+	}
+
 	double ExecBegin = FPlatformTime::Seconds();
 
+	// The last keyframe has all individuals, no need to look further back
+	const double KeyframeTs = GetKeyframeTs(Ts);
+
 	bson_error_t error;
 	const bson_t *doc;
 	mongoc_cursor_t *cursor;
@@ -252,7 +270,7 @@ FTransform FSLMongoQueryDBHandler::GetIndividualPoseAt(const FString& Id, float
 		"{",
 			"$match",
 			"{",
-				"timestamp", "{", "$lte", BCON_DOUBLE(Ts), "}",
+				"timestamp", "{", "$gte", BCON_DOUBLE(KeyframeTs), "$lte", BCON_DOUBLE(Ts), "}",
 				"individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
 			"}",
 		"}",
@@ -324,6 +342,16 @@ TArray<FTransform> FSLMongoQueryDBHandler::GetIndividualTrajectory(const FString
 	}
 
 #if SL_WITH_LIBMONGO_C
+	if (PoseTable.IsPacked())
+	{
+		Trajectory = GetPackedIndividualTrajectory(Id, StartTs, EndTs, DeltaT);
+		if (Trajectory.Num() == 0)
+		{
+			Trajectory.Add(GetIndividualPoseAt(Id, StartTs));
+		}
+		return Trajectory;
+	}
+
 	double ExecBegin = FPlatformTime::Seconds();
 
 	bson_error_t error;
@@ -428,8 +456,16 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 	}
 
 #if SL_WITH_LIBMONGO_C	
+	if (PoseTable.IsPacked())
+	{
+		return GetPackedSkeletalIndividualPoseAt(Id, Ts);
+	}
+
 	double ExecBegin = FPlatformTime::Seconds();
 
+	// The last keyframe has all individuals, no need to look further back
+	const double KeyframeTs = GetKeyframeTs(Ts);
+
 	bson_error_t error;
 	const bson_t *doc;
 	mongoc_cursor_t *cursor;
@@ -439,7 +475,7 @@ TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetSkeletalIn
 		"{",
 			"$match",
 			"{",
-				"timestamp", "{", "$lte", BCON_DOUBLE(Ts), "}",
+				"timestamp", "{", "$gte", BCON_DOUBLE(KeyframeTs), "$lte", BCON_DOUBLE(Ts), "}",
 				"skel_individuals.id", BCON_UTF8(TCHAR_TO_ANSI(*Id)),		// yields faster results if we match against the id from the start
 			"}",
 		"}",
@@ -533,6 +569,16 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSk
 	}
 
 #if SL_WITH_LIBMONGO_C
+	if (PoseTable.IsPacked())
+	{
+		SkeletalTrajectoryPair = GetPackedSkeletalIndividualTrajectory(Id, StartTs, EndTs, DeltaT);
+		if (SkeletalTrajectoryPair.Num() == 0)
+		{
+			SkeletalTrajectoryPair.Add(GetSkeletalIndividualPoseAt(Id, StartTs));
+		}
+		return SkeletalTrajectoryPair;
+	}
+
 	double ExecBegin = FPlatformTime::Seconds();
 
 	bson_error_t error;
@@ -675,112 +721,224 @@ TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetSk
 // Get the whole episode data
 TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpisodeData() const
 {
-	TArray<TPair<float, TMap<FString, FTransform>>> EpisodeData;
+	FSLMongoEpisodeFrames EpisodeFrames;
+	GetEpisodeFrames(EpisodeFrames);
+	return EpisodeFrames.ToEpisodeData();
+}
+
+// Stream the whole episode into flat frames, the documents are decoded in parallel while the cursor is read
+bool FSLMongoQueryDBHandler::GetEpisodeFrames(FSLMongoEpisodeFrames& OutFrames,
+	const FSLMongoEpisodeProgressCallback& OnProgress, int32 BatchSize) const
+{
+	OutFrames.Empty();
 	if (!IsReady())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
-		return EpisodeData;
-	}	
+		return false;
+	}
 
 #if SL_WITH_LIBMONGO_C
 	double ExecBegin = FPlatformTime::Seconds();
+	BatchSize = FMath::Max(BatchSize, 1);
 
 	bson_error_t error;
-	bson_t opts;
 	const bson_t *doc;
 	mongoc_cursor_t *cursor;
-	bson_t *pipeline;
 
-	pipeline = BCON_NEW("pipeline", "[",
-		"{",
-			"$match",
+	// Total number of frames, used for the progress
+	bson_t* count_filter = BCON_NEW("timestamp", "{", "$exists", BCON_BOOL(true), "}");
+	const int64 NumTotalFrames = mongoc_collection_count_documents(collection, count_filter, NULL, NULL, NULL, &error);
+	bson_destroy(count_filter);
+
+	if (PoseTable.IsPacked())
+	{
+		// The packed documents reference the individuals by their pose table index
+		for (const auto& Id : PoseTable.Ids)
+		{
+			OutFrames.Intern(Id);
+		}
+		cursor = FindPackedFrames(-BIG_NUMBER, BIG_NUMBER, false);
+	}
+	else
+	{
+		bson_t* pipeline = BCON_NEW("pipeline", "[",
 			"{",
-				"timestamp", 
+				"$match",
 				"{",
-					"$exists", BCON_BOOL(true),
+					"timestamp",
+					"{",
+						"$exists", BCON_BOOL(true),
+					"}",
 				"}",
 			"}",
-		"}",
-		"{",
-			"$sort",
 			"{",
-				"timestamp", BCON_INT32(1),
+				"$sort",
+				"{",
+					"timestamp", BCON_INT32(1),
+				"}",
 			"}",
-		"}",
-		"{",
-			"$project",
 			"{",
-				"_id", BCON_INT32(0),
-				"timestamp", BCON_INT32(1),
-				"individuals", BCON_UTF8("$individuals"),
+				"$project",
+				"{",
+					"_id", BCON_INT32(0),
+					"timestamp", BCON_INT32(1),
+					"individuals", BCON_UTF8("$individuals"),
+				"}",
 			"}",
-		"}",
-		"]");
-
-	// If the episode is very large the hard drive needs to be used to cache results
-	bson_init(&opts);
-	BSON_APPEND_BOOL(&opts, "allowDiskUse", true);
-	cursor = mongoc_collection_aggregate(
-		collection, MONGOC_QUERY_NONE, pipeline, &opts, NULL);
+			"]");
 
+		// If the episode is very large the hard drive needs to be used to cache results
+		bson_t* opts = BCON_NEW("allowDiskUse", BCON_BOOL(true), "batchSize", BCON_INT32(BatchSize));
+		cursor = mongoc_collection_aggregate(collection, MONGOC_QUERY_NONE, pipeline, opts, NULL);
+		bson_destroy(pipeline);
+		bson_destroy(opts);
+	}
 	double QueryDuration = FPlatformTime::Seconds() - ExecBegin;
 
-	int32 FrameIdx = 0;
-	// Read cursor if no errors occured
-	if (!mongoc_cursor_error(cursor, &error))
+	// Batches decoded by the thread pool, merged in cursor order
+	const int32 MaxPendingBatches = FMath::Max(2, 2 * FPlatformMisc::NumberOfWorkerThreadsToSpawn());
+	TArray<TFuture<FSLMongoEpisodeBatch*>> PendingBatches;
+	int32 NumDecodedFrames = 0;
+
+	// Move the decoded batch into the output and report the progress
+	auto MergeOldestBatch = [&]()
 	{
-		while (mongoc_cursor_next(cursor, &doc))
+		FSLMongoEpisodeBatch* Batch = PendingBatches[0].Get();
+		PendingBatches.RemoveAt(0);
+
+		TArray<int32> LocalToFrameIdx;
+		for (const auto& Id : Batch->LocalIds)
 		{
-			if (FrameIdx++ % 250 == 0) { UE_LOG(LogTemp, Log, TEXT(" mongo processing frame %d .."), FrameIdx++); }
-			bson_iter_t frame_iter;
-			if (bson_iter_init(&frame_iter, doc))
+			LocalToFrameIdx.Add(OutFrames.Intern(Id));
+		}
+
+		int32 EntryIdx = 0;
+		for (int32 FrameIdx = 0; FrameIdx < Batch->Timestamps.Num(); ++FrameIdx)
+		{
+			OutFrames.AddFrame(Batch->Timestamps[FrameIdx]);
+			for (int32 Num = 0; Num < Batch->NumEntries[FrameIdx]; ++Num, ++EntryIdx)
 			{
-				TMap<FString, FTransform> CurrIndividualsData;
-				float CurrTs;
-				
-				if (bson_iter_find(&frame_iter, "timestamp"))
-				{
-					CurrTs = bson_iter_double(&frame_iter);
-				}
+				const int32 Idx = Batch->Idxs[EntryIdx];
+				OutFrames.AddEntry(Batch->bUseLocalIds ? LocalToFrameIdx[Idx] : Idx, Batch->Poses[EntryIdx]);
+			}
+		}
+		NumDecodedFrames += Batch->Timestamps.Num();
+		delete Batch;
 
-				bson_iter_t individuals_iter;
-				if (bson_iter_find(&frame_iter, "individuals") && bson_iter_recurse(&frame_iter, &individuals_iter))
-				{
-					while (bson_iter_next(&individuals_iter))
-					{
-						FString Id;
-						bson_iter_t individual_val_iter;
-						if (bson_iter_recurse(&individuals_iter, &individual_val_iter) && bson_iter_find(&individual_val_iter, "id"))
-						{
-							Id = FString(bson_iter_utf8(&individual_val_iter, NULL));
-						}
-						CurrIndividualsData.Emplace(Id, GetPose(&individuals_iter));
-					}
-				}
-				EpisodeData.Emplace(CurrTs, CurrIndividualsData);
+		if (OnProgress)
+		{
+			OnProgress(NumDecodedFrames, (int32)FMath::Max<int64>(NumTotalFrames, NumDecodedFrames));
+		}
+	};
+
+	// Hand over a batch of document copies to the thread pool
+	TArray<bson_t*> Docs;
+	auto DispatchBatch = [&]()
+	{
+		if (Docs.Num() == 0)
+		{
+			return;
+		}
+		if (PendingBatches.Num() >= MaxPendingBatches)
+		{
+			MergeOldestBatch();
+		}
+		PendingBatches.Emplace(Async(EAsyncExecution::ThreadPool, [this, BatchDocs = MoveTemp(Docs)]()
+		{
+			FSLMongoEpisodeBatch* Batch = new FSLMongoEpisodeBatch();
+			DecodeEpisodeBatch(BatchDocs, *Batch);
+			for (bson_t* batch_doc : BatchDocs)
+			{
+				bson_destroy(batch_doc);
 			}
+			return Batch;
+		}));
+		Docs.Reset();
+	};
+
+	// The cursor is read on this thread only
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		Docs.Add(bson_copy(doc));
+		if (Docs.Num() >= BatchSize)
+		{
+			DispatchBatch();
 		}
 	}
-	else
+	DispatchBatch();
+	double CursorReadDuration = FPlatformTime::Seconds() - ExecBegin - QueryDuration;
+
+	while (PendingBatches.Num() > 0)
+	{
+		MergeOldestBatch();
+	}
+
+	const bool bSuccess = !mongoc_cursor_error(cursor, &error);
+	if (!bSuccess)
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
 			*FString(__func__), __LINE__, *FString(error.message));
 	}
-	double CursorReadDuration = FPlatformTime::Seconds() - ExecBegin - QueryDuration;
-
 	mongoc_cursor_destroy(cursor);
-	bson_destroy(pipeline);
-	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor(num=%d)=[%f], total=[%f] seconds..;"),
-		*FString(__func__), __LINE__, QueryDuration, EpisodeData.Num(), CursorReadDuration, FPlatformTime::Seconds() - ExecBegin);
-#endif
-	return EpisodeData;
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: query=[%f], cursor(num=%d)=[%f], total=[%f] seconds; ids=%d; entries=%d; mb=%.2f..;"),
+		*FString(__func__), __LINE__, QueryDuration, OutFrames.NumFrames(), CursorReadDuration, FPlatformTime::Seconds() - ExecBegin,
+		OutFrames.Ids.Num(), OutFrames.EntryIdxs.Num(), OutFrames.GetAllocatedSize() / (1024.0 * 1024.0));
+	return bSuccess;
+#else
+	return false;
+#endif // SL_WITH_LIBMONGO_C
 }
 
-// Get the whole episode data in an async thread
-TArray<TPair<float, TMap<FString, FTransform>>> FSLMongoQueryDBHandler::GetEpisodeDataAsync() const
+// Get a signature of the episode content (number of frames and the last frame), empty if not available
+FString FSLMongoQueryDBHandler::GetEpisodeSignature() const
 {
-	// TODO
-	return TArray<TPair<float, TMap<FString, FTransform>>>();
+	if (!IsReady())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d DB handler is not ready, make sure the server, database, and collection is set.."), *FString(__FUNCTION__), __LINE__);
+		return FString();
+	}
+
+	FString Signature;
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	const bson_t *doc;
+
+	bson_t* filter = BCON_NEW("timestamp", "{", "$exists", BCON_BOOL(true), "}");
+	const int64 NumFrames = mongoc_collection_count_documents(collection, filter, NULL, NULL, NULL, &error);
+	if (NumFrames < 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"), *FString(__func__), __LINE__, *FString(error.message));
+		bson_destroy(filter);
+		return FString();
+	}
+
+	// Served by the timestamp index
+	bson_t* opts = BCON_NEW(
+		"sort", "{", "timestamp", BCON_INT32(-1), "}",
+		"projection", "{", "_id", BCON_INT32(1), "timestamp", BCON_INT32(1), "}",
+		"limit", BCON_INT64(1));
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+
+	char oid_str[25] = "";
+	double LastTs = 0.0;
+	if (mongoc_cursor_next(cursor, &doc))
+	{
+		LastTs = GetTs(doc);
+		bson_iter_t iter;
+		if (bson_iter_init_find(&iter, doc, "_id") && BSON_ITER_HOLDS_OID(&iter))
+		{
+			bson_oid_to_string(bson_iter_oid(&iter), oid_str);
+		}
+	}
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+	bson_destroy(opts);
+
+	Signature = FString::Printf(TEXT("frames=%lld;last_ts=%.6f;last_id=%s;encoding=%d;"),
+		NumFrames, LastTs, ANSI_TO_TCHAR(oid_str), (int32)PoseTable.Encoding);
+#endif // SL_WITH_LIBMONGO_C
+	return Signature;
 }
 
 // Get the episode data at the given timestamp (frame)
@@ -949,4 +1107,420 @@ double FSLMongoQueryDBHandler::GetTs(const bson_t* doc) const
 	}
 	return -1.f;
 }
-#endif // SL_WITH_LIBMONGO_C
\ No newline at end of file
+
+// Get the timestamp of the last keyframe at or before the given time (-BIG_NUMBER if there are no keyframes)
+double FSLMongoQueryDBHandler::GetKeyframeTs(float Ts) const
+{
+	double KeyframeTs = -BIG_NUMBER;
+	const bson_t *doc;
+
+	// Served by the partial keyframe index
+	bson_t* filter = BCON_NEW(
+		"keyframe", BCON_BOOL(true),
+		"timestamp", "{", "$lte", BCON_DOUBLE(Ts), "}");
+	bson_t* opts = BCON_NEW(
+		"sort", "{", "timestamp", BCON_INT32(-1), "}",
+		"projection", "{", "_id", BCON_INT32(0), "timestamp", BCON_INT32(1), "}",
+		"limit", BCON_INT64(1));
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+	if (mongoc_cursor_next(cursor, &doc))
+	{
+		KeyframeTs = GetTs(doc);
+	}
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+	bson_destroy(opts);
+	return KeyframeTs;
+}
+
+/* Packed poses */
+// Load the packed pose table of the collection (false if the collection uses the document encoding)
+bool FSLMongoQueryDBHandler::LoadPoseTable()
+{
+	PoseTable.Empty();
+
+	const bson_t* doc;
+	bson_t* filter = BCON_NEW("pose_table", "{", "$exists", BCON_BOOL(true), "}");
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(collection, filter, NULL, NULL);
+
+	if (mongoc_cursor_next(cursor, &doc))
+	{
+		bson_iter_t iter;
+		bson_iter_t table_iter;
+		bson_iter_t arr_iter;
+		if (bson_iter_init_find(&iter, doc, "pose_table") && bson_iter_recurse(&iter, &table_iter))
+		{
+			while (bson_iter_next(&table_iter))
+			{
+				const char* key = bson_iter_key(&table_iter);
+				if (FCStringAnsi::Strcmp(key, "encoding") == 0)
+				{
+					PoseTable.Encoding = (ESLWorldStatePoseEncoding)bson_iter_int32(&table_iter);
+				}
+				else if (FCStringAnsi::Strcmp(key, "ids") == 0 && bson_iter_recurse(&table_iter, &arr_iter))
+				{
+					while (bson_iter_next(&arr_iter))
+					{
+						PoseTable.Ids.Add(FString(UTF8_TO_TCHAR(bson_iter_utf8(&arr_iter, NULL))));
+					}
+				}
+				else if (FCStringAnsi::Strcmp(key, "listed") == 0 && bson_iter_recurse(&table_iter, &arr_iter))
+				{
+					while (bson_iter_next(&arr_iter))
+					{
+						PoseTable.ListedMask.Add(bson_iter_bool(&arr_iter));
+					}
+				}
+				else if (FCStringAnsi::Strcmp(key, "skel") == 0 && bson_iter_recurse(&table_iter, &arr_iter))
+				{
+					while (bson_iter_next(&arr_iter))
+					{
+						int32 SkelPoseIdx = INDEX_NONE;
+						TArray<TPair<int32, int32>> Bones;
+						bson_iter_t skel_iter;
+						bson_iter_t bones_iter;
+						bson_iter_t bone_iter;
+						if (bson_iter_recurse(&arr_iter, &skel_iter) && bson_iter_find(&skel_iter, "pose_idx"))
+						{
+							SkelPoseIdx = bson_iter_int32(&skel_iter);
+						}
+						if (bson_iter_recurse(&arr_iter, &skel_iter) && bson_iter_find(&skel_iter, "bones") && bson_iter_recurse(&skel_iter, &bones_iter))
+						{
+							while (bson_iter_next(&bones_iter))
+							{
+								bson_iter_t value;
+								int32 BoneIndex = INDEX_NONE;
+								int32 BonePoseIdx = INDEX_NONE;
+								if (bson_iter_recurse(&bones_iter, &bone_iter) && bson_iter_find(&bone_iter, "idx"))
+								{
+									BoneIndex = bson_iter_int32(&bone_iter);
+								}
+								if (bson_iter_recurse(&bones_iter, &value) && bson_iter_find(&value, "pose_idx"))
+								{
+									BonePoseIdx = bson_iter_int32(&value);
+								}
+								Bones.Emplace(BoneIndex, BonePoseIdx);
+							}
+						}
+						PoseTable.SkeletalBones.Emplace(SkelPoseIdx, Bones);
+					}
+				}
+			}
+		}
+	}
+
+	bson_error_t error;
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	mongoc_cursor_destroy(cursor);
+	bson_destroy(filter);
+
+	if (!PoseTable.IsPacked())
+	{
+		PoseTable.Empty();
+		return false;
+	}
+
+	for (int32 Idx = 0; Idx < PoseTable.Ids.Num(); ++Idx)
+	{
+		PoseTable.IdToPoseIdx.Add(PoseTable.Ids[Idx], Idx);
+	}
+	if (PoseTable.ListedMask.Num() != PoseTable.Ids.Num())
+	{
+		PoseTable.ListedMask.Init(true, PoseTable.Ids.Num());
+	}
+	return true;
+}
+
+// Get the pose with the given index from the packed document (false if it is not in the document)
+bool FSLMongoQueryDBHandler::GetPose(const bson_t* doc, int32 PoseIdx, FTransform& OutPose) const
+{
+	bson_iter_t iter;
+	bson_subtype_t subtype;
+	uint32_t len = 0;
+	const uint8_t* data = NULL;
+	if (bson_iter_init_find(&iter, doc, "poses") && BSON_ITER_HOLDS_BINARY(&iter))
+	{
+		bson_iter_binary(&iter, &subtype, &len, &data);
+		return FSLWorldStatePoseCodec::FindPose(data, len, PoseIdx, OutPose);
+	}
+	return false;
+}
+
+// Get all the poses from the packed document
+bool FSLMongoQueryDBHandler::GetPoses(const bson_t* doc, TArray<int32>& OutIdxs, TArray<FTransform>& OutPoses) const
+{
+	bson_iter_t iter;
+	bson_subtype_t subtype;
+	uint32_t len = 0;
+	const uint8_t* data = NULL;
+	if (bson_iter_init_find(&iter, doc, "poses") && BSON_ITER_HOLDS_BINARY(&iter))
+	{
+		bson_iter_binary(&iter, &subtype, &len, &data);
+		return FSLWorldStatePoseCodec::Decode(data, len, OutIdxs, OutPoses);
+	}
+	return false;
+}
+
+// Find the packed frame documents between the given timestamps
+mongoc_cursor_t* FSLMongoQueryDBHandler::FindPackedFrames(float StartTs, float EndTs, bool bNewestFirst) const
+{
+	bson_t* filter = BCON_NEW(
+		"timestamp", "{", "$gte", BCON_DOUBLE(StartTs), "$lte", BCON_DOUBLE(EndTs), "}");
+	bson_t* opts = BCON_NEW(
+		"sort", "{", "timestamp", BCON_INT32(bNewestFirst ? -1 : 1), "}",
+		"projection", "{", "_id", BCON_INT32(0), "timestamp", BCON_INT32(1), "poses", BCON_INT32(1), "}");
+	mongoc_cursor_t* cursor = mongoc_collection_find_with_opts(collection, filter, opts, NULL);
+	bson_destroy(filter);
+	bson_destroy(opts);
+	return cursor;
+}
+
+// Get the skeletal pose from the packed document (false if the skeletal individual is not in the document)
+bool FSLMongoQueryDBHandler::GetPackedSkeletalPose(const bson_t* doc, int32 PoseIdx,
+	TPair<FTransform, TMap<int32, FTransform>>& OutSkeletalPose) const
+{
+	// Moved skeletal individuals are written together with all their bones
+	if (!GetPose(doc, PoseIdx, OutSkeletalPose.Key))
+	{
+		return false;
+	}
+	if (const TArray<TPair<int32, int32>>* Bones = PoseTable.SkeletalBones.Find(PoseIdx))
+	{
+		for (const auto& BonePair : *Bones)
+		{
+			FTransform BonePose;
+			if (GetPose(doc, BonePair.Value, BonePose))
+			{
+				OutSkeletalPose.Value.Emplace(BonePair.Key, BonePose);
+			}
+		}
+	}
+	return true;
+}
+
+// Get the pose of the individual at the given time from the packed documents
+FTransform FSLMongoQueryDBHandler::GetPackedIndividualPoseAt(const FString& Id, float Ts) const
+{
+	FTransform Pose;
+	const int32* PoseIdx = PoseTable.IdToPoseIdx.Find(Id);
+	if (PoseIdx == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Id %s is not in the pose table.."), *FString(__FUNCTION__), __LINE__, *Id);
+		return Pose;
+	}
+
+	double ExecBegin = FPlatformTime::Seconds();
+	bson_error_t error;
+	const bson_t *doc;
+
+	// Walk back in time until a frame containing the individual is found (at most until the last keyframe)
+	mongoc_cursor_t* cursor = FindPackedFrames(GetKeyframeTs(Ts), Ts, true);
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		if (GetPose(doc, *PoseIdx, Pose))
+		{
+			break;
+		}
+	}
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	mongoc_cursor_destroy(cursor);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Duration: total=[%f] seconds..;"),
+		*FString(__func__), __LINE__, FPlatformTime::Seconds() - ExecBegin);
+	return Pose;
+}
+
+// Get the poses of the individual between the given timestamps from the packed documents
+TArray<FTransform> FSLMongoQueryDBHandler::GetPackedIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT) const
+{
+	TArray<FTransform> Trajectory;
+	const int32* PoseIdx = PoseTable.IdToPoseIdx.Find(Id);
+	if (PoseIdx == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Id %s is not in the pose table.."), *FString(__FUNCTION__), __LINE__, *Id);
+		return Trajectory;
+	}
+
+	double ExecBegin = FPlatformTime::Seconds();
+	bson_error_t error;
+	const bson_t *doc;
+
+	double PrevTs = -BIG_NUMBER;
+	mongoc_cursor_t* cursor = FindPackedFrames(StartTs, EndTs, false);
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		FTransform Pose;
+		if (GetPose(doc, *PoseIdx, Pose))
+		{
+			const double CurrTs = GetTs(doc);
+			if (DeltaT <= 0.f || CurrTs - PrevTs > DeltaT)
+			{
+				Trajectory.Add(Pose);
+				PrevTs = CurrTs;
+			}
+		}
+	}
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	mongoc_cursor_destroy(cursor);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Duration: total=[%f] seconds, Num=[%d]..;"),
+		*FString(__func__), __LINE__, FPlatformTime::Seconds() - ExecBegin, Trajectory.Num());
+	return Trajectory;
+}
+
+// Get skeletal individual pose from the packed documents
+TPair<FTransform, TMap<int32, FTransform>> FSLMongoQueryDBHandler::GetPackedSkeletalIndividualPoseAt(const FString& Id, float Ts) const
+{
+	TPair<FTransform, TMap<int32, FTransform>> SkeletalPosePair;
+	const int32* PoseIdx = PoseTable.IdToPoseIdx.Find(Id);
+	if (PoseIdx == nullptr || !PoseTable.SkeletalBones.Contains(*PoseIdx))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Id %s is not a skeletal individual in the pose table.."), *FString(__FUNCTION__), __LINE__, *Id);
+		return SkeletalPosePair;
+	}
+
+	double ExecBegin = FPlatformTime::Seconds();
+	bson_error_t error;
+	const bson_t *doc;
+
+	mongoc_cursor_t* cursor = FindPackedFrames(GetKeyframeTs(Ts), Ts, true);
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		if (GetPackedSkeletalPose(doc, *PoseIdx, SkeletalPosePair))
+		{
+			break;
+		}
+	}
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	mongoc_cursor_destroy(cursor);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Duration: total=[%f] seconds..;"),
+		*FString(__func__), __LINE__, FPlatformTime::Seconds() - ExecBegin);
+	return SkeletalPosePair;
+}
+
+// Get skeletal individual trajectory from the packed documents
+TArray<TPair<FTransform, TMap<int32, FTransform>>> FSLMongoQueryDBHandler::GetPackedSkeletalIndividualTrajectory(const FString& Id, float StartTs, float EndTs, float DeltaT) const
+{
+	TArray<TPair<FTransform, TMap<int32, FTransform>>> SkeletalTrajectoryPair;
+	const int32* PoseIdx = PoseTable.IdToPoseIdx.Find(Id);
+	if (PoseIdx == nullptr || !PoseTable.SkeletalBones.Contains(*PoseIdx))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Id %s is not a skeletal individual in the pose table.."), *FString(__FUNCTION__), __LINE__, *Id);
+		return SkeletalTrajectoryPair;
+	}
+
+	double ExecBegin = FPlatformTime::Seconds();
+	bson_error_t error;
+	const bson_t *doc;
+
+	double PrevTs = -BIG_NUMBER;
+	mongoc_cursor_t* cursor = FindPackedFrames(StartTs, EndTs, false);
+	while (mongoc_cursor_next(cursor, &doc))
+	{
+		const double CurrTs = GetTs(doc);
+		if (DeltaT > 0.f && CurrTs - PrevTs <= DeltaT)
+		{
+			continue;
+		}
+
+		TPair<FTransform, TMap<int32, FTransform>> SkeletalPosePair;
+		if (GetPackedSkeletalPose(doc, *PoseIdx, SkeletalPosePair))
+		{
+			SkeletalTrajectoryPair.Add(SkeletalPosePair);
+			PrevTs = CurrTs;
+		}
+	}
+	if (mongoc_cursor_error(cursor, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	mongoc_cursor_destroy(cursor);
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Duration: total=[%f] seconds, Num=[%d]..;"),
+		*FString(__func__), __LINE__, FPlatformTime::Seconds() - ExecBegin, SkeletalTrajectoryPair.Num());
+	return SkeletalTrajectoryPair;
+}
+
+// Decode the frame documents of a batch (called from the thread pool)
+void FSLMongoQueryDBHandler::DecodeEpisodeBatch(const TArray<bson_t*>& Docs, FSLMongoEpisodeBatch& OutBatch) const
+{
+	OutBatch.bUseLocalIds = !PoseTable.IsPacked();
+	OutBatch.Timestamps.Reserve(Docs.Num());
+	OutBatch.NumEntries.Reserve(Docs.Num());
+
+	TMap<FString, int32> LocalIdToIdx;
+	TArray<int32> Idxs;
+	TArray<FTransform> Poses;
+	for (const bson_t* doc : Docs)
+	{
+		int32 NumEntries = 0;
+		if (PoseTable.IsPacked())
+		{
+			Idxs.Reset();
+			Poses.Reset();
+			if (!GetPoses(doc, Idxs, Poses))
+			{
+				continue;
+			}
+			for (int32 Slot = 0; Slot < Idxs.Num(); ++Slot)
+			{
+				// Same content as the individuals array of the document encoding
+				const int32 Idx = Idxs[Slot];
+				if (PoseTable.Ids.IsValidIndex(Idx) && PoseTable.ListedMask[Idx])
+				{
+					OutBatch.Idxs.Add(Idx);
+					OutBatch.Poses.Add(Poses[Slot]);
+					NumEntries++;
+				}
+			}
+		}
+		else
+		{
+			bson_iter_t frame_iter;
+			bson_iter_t individuals_iter;
+			if (bson_iter_init_find(&frame_iter, doc, "individuals") && bson_iter_recurse(&frame_iter, &individuals_iter))
+			{
+				while (bson_iter_next(&individuals_iter))
+				{
+					FString Id;
+					bson_iter_t individual_val_iter;
+					if (bson_iter_recurse(&individuals_iter, &individual_val_iter) && bson_iter_find(&individual_val_iter, "id"))
+					{
+						Id = FString(UTF8_TO_TCHAR(bson_iter_utf8(&individual_val_iter, NULL)));
+					}
+
+					int32 LocalIdx;
+					if (const int32* Idx = LocalIdToIdx.Find(Id))
+					{
+						LocalIdx = *Idx;
+					}
+					else
+					{
+						LocalIdx = OutBatch.LocalIds.Add(Id);
+						LocalIdToIdx.Add(Id, LocalIdx);
+					}
+					OutBatch.Idxs.Add(LocalIdx);
+					OutBatch.Poses.Add(GetPose(&individuals_iter));
+					NumEntries++;
+				}
+			}
+		}
+		OutBatch.Timestamps.Add(GetTs(doc));
+		OutBatch.NumEntries.Add(NumEntries);
+	}
+}
+#endif // SL_WITH_LIBMONGO_C
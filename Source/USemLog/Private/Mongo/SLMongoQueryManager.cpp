@@ -14,6 +14,7 @@ ASLMongoQueryManager::ASLMongoQueryManager()
 	bConnected = false;
 	bTaskSet = false;
 	bEpisodeSet = false;
+	EpisodeTimelines = nullptr;
 
 #if WITH_EDITORONLY_DATA
 	// Make manager sprite smaller (used to easily find the actor in the world)
@@ -153,6 +154,8 @@ void ASLMongoQueryManager::Disconnect()
 	if (bConnected)
 	{
 		DBHandler.Disconnect();
+		PoseCache.Empty();
+		EpisodeTimelines = nullptr;
 		TaskId = "";
 		EpisodeId = "";
 		
@@ -174,6 +177,7 @@ bool ASLMongoQueryManager::SetTask(const FString& InTaskId)
 	{
 		return true;
 	}
+	EpisodeTimelines = nullptr;
 	if (DBHandler.SetDatabase(InTaskId))
 	{
 		TaskId = InTaskId;
@@ -205,6 +209,7 @@ bool ASLMongoQueryManager::SetEpisode(const FString& InEpisodeId)
 	{
 		return true;
 	}
+	EpisodeTimelines = nullptr;
 	if (DBHandler.SetCollection(InEpisodeId))
 	{
 		EpisodeId = InEpisodeId;
@@ -238,6 +243,7 @@ FTransform ASLMongoQueryManager::GetIndividualPoseAt(const FString& InEpisodeId,
 {
 	if (SetEpisode(InEpisodeId))
 	{
+		SetEpisodeTimelines();
 		return GetIndividualPoseAt(IndividualId, Ts);
 	}
 	else
@@ -250,6 +256,10 @@ FTransform ASLMongoQueryManager::GetIndividualPoseAt(const FString& InEpisodeId,
 // Get the individual pose
 FTransform ASLMongoQueryManager::GetIndividualPoseAt(const FString& IndividualId, float Ts) const
 {
+	if (EpisodeTimelines)
+	{
+		return EpisodeTimelines->GetIndividualPoseAt(IndividualId, Ts);
+	}
 	return DBHandler.GetIndividualPoseAt(IndividualId, Ts);
 }
 
@@ -272,6 +282,7 @@ TArray<FTransform> ASLMongoQueryManager::GetIndividualTrajectory(const FString&
 {
 	if (SetEpisode(InEpisodeId))
 	{
+		SetEpisodeTimelines();
 		return GetIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
 	}
 	else
@@ -284,6 +295,10 @@ TArray<FTransform> ASLMongoQueryManager::GetIndividualTrajectory(const FString&
 // Get the individual trajectory 
 TArray<FTransform> ASLMongoQueryManager::GetIndividualTrajectory(const FString& IndividualId, float StartTs, float EndTs, float DeltaT) const
 {
+	if (EpisodeTimelines)
+	{
+		return EpisodeTimelines->GetIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
+	}
 	return DBHandler.GetIndividualTrajectory(IndividualId, StartTs, EndTs, DeltaT);
 }
 
@@ -391,6 +406,76 @@ TArray<TPair<float, TMap<FString, FTransform>>> ASLMongoQueryManager::GetEpisode
 	return DBHandler.GetEpisodeData();
 }
 
+// Load the active episode into the pose cache (if enabled and it fits the memory budget)
+void ASLMongoQueryManager::SetEpisodeTimelines()
+{
+	if (!bUsePoseCache)
+	{
+		EpisodeTimelines = nullptr;
+		return;
+	}
+	if (EpisodeTimelines)
+	{
+		return;
+	}
+
+	PoseCache.SetMaxMemory((int64)PoseCacheMaxMemoryMB * 1024 * 1024);
+	EpisodeTimelines = PoseCache.Find(TaskId, EpisodeId);
+	if (EpisodeTimelines == nullptr && !PoseCache.IsOversized(TaskId, EpisodeId))
+	{
+		FSLMongoEpisodeFrames EpisodeFrames;
+		if (DBHandler.GetEpisodeFrames(EpisodeFrames))
+		{
+			EpisodeTimelines = PoseCache.Add(TaskId, EpisodeId, EpisodeFrames);
+		}
+	}
+}
+
+// Get the episode as flat frames with task and episode init
+bool ASLMongoQueryManager::GetEpisodeFrames(const FString& InTaskId, const FString& InEpisodeId, FSLMongoEpisodeFrames& OutFrames,
+	const FSLMongoEpisodeProgressCallback& OnProgress)
+{
+	if (!SetTask(InTaskId))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task: %s .."), *FString(__FUNCTION__), __LINE__, *InTaskId);
+		return false;
+	}
+	if (!SetEpisode(InEpisodeId))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set episode: %s .."), *FString(__FUNCTION__), __LINE__, *InEpisodeId);
+		return false;
+	}
+	return GetEpisodeFrames(OutFrames, OnProgress);
+}
+
+// Get the episode as flat frames
+bool ASLMongoQueryManager::GetEpisodeFrames(FSLMongoEpisodeFrames& OutFrames, const FSLMongoEpisodeProgressCallback& OnProgress) const
+{
+	return DBHandler.GetEpisodeFrames(OutFrames, OnProgress);
+}
+
+// Get a signature of the episode content with task and episode init
+FString ASLMongoQueryManager::GetEpisodeSignature(const FString& InTaskId, const FString& InEpisodeId)
+{
+	if (!SetTask(InTaskId))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set task: %s .."), *FString(__FUNCTION__), __LINE__, *InTaskId);
+		return FString();
+	}
+	if (!SetEpisode(InEpisodeId))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not set episode: %s .."), *FString(__FUNCTION__), __LINE__, *InEpisodeId);
+		return FString();
+	}
+	return GetEpisodeSignature();
+}
+
+// Get a signature of the episode content
+FString ASLMongoQueryManager::GetEpisodeSignature() const
+{
+	return DBHandler.GetEpisodeSignature();
+}
+
 // Spawn or get manager from the world
 ASLMongoQueryManager* ASLMongoQueryManager::GetExistingOrSpawnNew(UWorld* World)
 {
@@ -25,6 +25,10 @@ USLContactMonitorBox::USLContactMonitorBox()
 	bIsFinished = false;
 
 	bLogSupportedByEvents = true;
+	bSupportedByCheckScheduled = false;
+	bOverlapEndFlushScheduled = false;
+
+	Scheduler = nullptr;
 
 	OwnerIndividualComponent = nullptr;
 
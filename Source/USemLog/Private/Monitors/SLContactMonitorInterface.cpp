@@ -2,6 +2,7 @@
 // Author: Andrei Haidu (http://haidu.eu)
 
 #include "Monitors/SLContactMonitorInterface.h"
+#include "Monitors/SLContactMonitorScheduler.h"
 #include "Individuals/SLIndividualUtils.h"
 #include "Components/MeshComponent.h"
 #include "Utils/SLUuid.h"
@@ -11,12 +12,19 @@ void ISLContactMonitorInterface::Finish(bool bForced)
 {
 	if (!bIsFinished && (bIsInit || bIsStarted))
 	{
-		// Publish any pending delayed events	
-		for(const auto& Ev : RecentlyEndedOverlapEvents)
+		// Publish any pending delayed events (in the order they ended)
+		TArray<FSLOverlapEndEvent> PendingEvents;
+		RecentlyEndedOverlapEvents.RemoveAll(PendingEvents);
+		for(const auto& Ev : PendingEvents)
 		{
 			PublishDelayedOverlapEndEvent(Ev);
 		}
-		RecentlyEndedOverlapEvents.Empty();
+
+		// Stop any scheduled checks
+		if (Scheduler)
+		{
+			Scheduler->RemoveMonitor(this);
+		}
 		
 		// Disable overlap events
 		ShapeComponent->SetGenerateOverlapEvents(false);
@@ -35,7 +43,6 @@ bool ISLContactMonitorInterface::InitContactMonitorInterface(UShapeComponent* In
 	{
 		World = InWorld;
 		ShapeComponent = InShapeComponent;
-		DelayTimerDelegate.BindRaw(this, &ISLContactMonitorInterface::DelayedOverlapEndEventCallback);
 		return true;
 	}
 	return false;
@@ -59,11 +66,12 @@ void ISLContactMonitorInterface::TriggerInitialOverlaps()
 // Start checking for supported by events
 void ISLContactMonitorInterface::StartSupportedByUpdateCheck()
 {
-	if(World)
+	// The candidates are checked by the scheduler, the monitor is scheduled only while it has candidates
+	if (!Scheduler)
 	{
-		// Start updating the timer, will be paused if there are no candidates
-		SupportedByTimerDelegate.BindRaw(this, &ISLContactMonitorInterface::SupportedByUpdateCheckBegin);
-		World->GetTimerManager().SetTimer(SupportedByTimerHandle, SupportedByTimerDelegate, SupportedByUpdateRate, true);
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s has no scheduler, supported by events will not be logged.."),
+			*FString(__FUNCTION__), __LINE__, *ShapeComponent->GetFullName());
+		bLogSupportedByEvents = false;
 	}
 }
 
@@ -71,73 +79,59 @@ void ISLContactMonitorInterface::StartSupportedByUpdateCheck()
 // TODO is a supported by end update look required?
 void ISLContactMonitorInterface::SupportedByUpdateCheckBegin()
 {
-	// Check if candidates are in a supported by event
-	for (auto CandidateItr(SupportedByCandidates.CreateIterator()); CandidateItr; ++CandidateItr)
+	// Candidates are part of a started event if the relative speed on Z between the two objects is smaller than the threshold,
+	// they are removed from the candidates and broadcast in the order they were added
+	TArray<FSLContactResult> SupportedByResults;
+	SupportedByCandidates.RemoveAllIf([](const FSLContactResult& Candidate)
 	{
 		// Get relative vertical speed
-		const float RelVertSpeed = FMath::Abs(CandidateItr->SelfMeshComponent->GetComponentVelocity().Z -
-			CandidateItr->OtherMeshComponent->GetComponentVelocity().Z);
-		
-		// Check that the relative speed on Z between the two objects is smaller than the threshold
-		if (RelVertSpeed < SupportedByMaxVertSpeed)
+		const float RelVertSpeed = FMath::Abs(Candidate.SelfMeshComponent->GetComponentVelocity().Z -
+			Candidate.OtherMeshComponent->GetComponentVelocity().Z);
+		return RelVertSpeed < SupportedByMaxVertSpeed;
+	}, SupportedByResults);
+
+	for (const FSLContactResult& Candidate : SupportedByResults)
+	{
+		if (Candidate.bIsOtherASemanticOverlapArea)
 		{
-			if (CandidateItr->bIsOtherASemanticOverlapArea)
+			// Check which is supporting and which is supported
+			// TODO simple height comparison for now
+			if (Candidate.SelfMeshComponent->GetComponentLocation().Z >
+				Candidate.OtherMeshComponent->GetComponentLocation().Z)
 			{
-				// Check which is supporting and which is supported
-				// TODO simple height comparison for now
-				if (CandidateItr->SelfMeshComponent->GetComponentLocation().Z >
-					CandidateItr->OtherMeshComponent->GetComponentLocation().Z)
-				{
-					USLBaseIndividual* Supported = CandidateItr->Self;
-					USLBaseIndividual* Supporting = CandidateItr->Other;
-					const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
-					OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-					IsSupportedByPariIds.Add(PairId);
-				}
-				else
-				{
-					USLBaseIndividual* Supported = CandidateItr->Other;
-					USLBaseIndividual* Supporting = CandidateItr->Self;
-					const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
-					OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-					// Self item is supporting another, to not add it to the supportedby events id
-				}
+				USLBaseIndividual* Supported = Candidate.Self;
+				USLBaseIndividual* Supporting = Candidate.Other;
+				const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
+				OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
+				IsSupportedByPariIds.Add(PairId);
 			}
-			else 
+			else
 			{
-				// Other can only support, self can only be supported
-				USLBaseIndividual* Supported = CandidateItr->Self;
-				USLBaseIndividual* Supporting = CandidateItr->Other;
+				USLBaseIndividual* Supported = Candidate.Other;
+				USLBaseIndividual* Supporting = Candidate.Self;
 				const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
 				OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
-				IsSupportedByPariIds.Add(PairId);
+				// Self item is supporting another, to not add it to the supportedby events id
 			}
-			// Remove candidate, it is now part of a started event
-			CandidateItr.RemoveCurrent();
 		}
-	}
-	
-	// PauseGraspDetection timer
-	if (SupportedByCandidates.Num() == 0)
-	{
-		World->GetTimerManager().PauseTimer(SupportedByTimerHandle);
+		else 
+		{
+			// Other can only support, self can only be supported
+			USLBaseIndividual* Supported = Candidate.Self;
+			USLBaseIndividual* Supporting = Candidate.Other;
+			const uint64 PairId = FSLUuid::PairEncodeCantor(Supported->GetUniqueID(), Supporting->GetUniqueID());
+			OnBeginSLSupportedBy.Broadcast(Supported, Supporting, World->GetTimeSeconds(), PairId);
+			IsSupportedByPariIds.Add(PairId);
+		}
 	}
 }
 
-// Remove candidate from array
+// Remove candidate from the candidates
 bool ISLContactMonitorInterface::CheckAndRemoveIfJustCandidate(USLBaseIndividual* InOther)
 {
-	// Use iterator to be able to remove the entry from the array
-	for (auto CandidateItr(SupportedByCandidates.CreateIterator()); CandidateItr; ++CandidateItr)
-	{
-		if ((*CandidateItr).Other == InOther)
-		{
-			// Remove candidate from the list
-			CandidateItr.RemoveCurrent();
-			return true; // Found
-		}
-	}
-	return false; // Not in list
+	// Hash lookup by the other individual, the oldest candidate is removed
+	FSLContactResult Candidate;
+	return SupportedByCandidates.RemoveOldest(InOther, Candidate);
 }
 
 // Called on overlap begin events
@@ -185,12 +179,9 @@ void ISLContactMonitorInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 
 		if(bLogSupportedByEvents)
 		{
-			// Add candidate and re-start (if paused) timer cb
-			SupportedByCandidates.Emplace(SemanticOverlapResult);
-			if(World->GetTimerManager().IsTimerPaused(SupportedByTimerHandle))
-			{
-				World->GetTimerManager().UnPauseTimer(SupportedByTimerHandle);
-			}
+			// Add candidate and schedule (if not already) its check
+			SupportedByCandidates.Add(OtherIndividual, SemanticOverlapResult);
+			Scheduler->ScheduleSupportedByCheck(this);
 		}
 	}
 	else if (ISLContactMonitorInterface* OtherContactTrigger = Cast<ISLContactMonitorInterface>(OtherComp))
@@ -211,12 +202,9 @@ void ISLContactMonitorInterface::OnOverlapBegin(UPrimitiveComponent* OverlappedC
 			
 			if(bLogSupportedByEvents)
 			{
-				// Add candidate and re-start (if paused) timer cb
-				SupportedByCandidates.Emplace(SemanticOverlapResult);
-				if(World->GetTimerManager().IsTimerPaused(SupportedByTimerHandle))
-				{
-					World->GetTimerManager().UnPauseTimer(SupportedByTimerHandle);
-				}
+				// Add candidate and schedule (if not already) its check
+				SupportedByCandidates.Add(OtherIndividual, SemanticOverlapResult);
+				Scheduler->ScheduleSupportedByCheck(this);
 			}
 		}
 	}
@@ -245,38 +233,41 @@ void ISLContactMonitorInterface::OnOverlapEnd(UPrimitiveComponent* OverlappedCom
 		return;
 	}
 
-	// Delay publishing the overlap event in case of possible concatenations
-	RecentlyEndedOverlapEvents.Emplace(FSLOverlapEndEvent(OtherComp, OtherIndividual, World->GetTimeSeconds()));
-
-	// Delay publishing for a while, in case the new event is of the same type and should be concatenated
-	if(!World->GetTimerManager().IsTimerActive(DelayTimerHandle))
+	// Without a scheduler the event cannot be delayed for concatenations
+	if (!Scheduler)
 	{
-		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate, DelayValue, false);
+		PublishDelayedOverlapEndEvent(FSLOverlapEndEvent(OtherComp, OtherIndividual, World->GetTimeSeconds()));
+		return;
 	}
+
+	// Delay publishing the overlap event in case of possible concatenations
+	RecentlyEndedOverlapEvents.Add(OtherIndividual, FSLOverlapEndEvent(OtherComp, OtherIndividual, World->GetTimeSeconds()));
+
+	// Delay publishing for a while (if not already), in case the new event is of the same type and should be concatenated
+	const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
+	Scheduler->ScheduleOverlapEndFlush(this, World->GetTimeSeconds() + DelayValue);
 }
 
 // Delayed call of sending the finished event to check for possible concatenation of jittering events of the same type
-void ISLContactMonitorInterface::DelayedOverlapEndEventCallback()
+// (called by the scheduler, returns true if there are still too recent events to publish)
+bool ISLContactMonitorInterface::DelayedOverlapEndEventCallback()
 {
 	// Curr time (keep very recently added events for another delay)
 	const float CurrTime = World->GetTimeSeconds();
 	
-	for (auto OverlapEndEvItr(RecentlyEndedOverlapEvents.CreateIterator()); OverlapEndEvItr; ++OverlapEndEvItr)
+	// Remove the events old enough to have had their chance to be concatenated, publish them in the order they ended
+	TArray<FSLOverlapEndEvent> DueEvents;
+	RecentlyEndedOverlapEvents.RemoveAllIf([CurrTime](const FSLOverlapEndEvent& Ev)
 	{
-		if(PublishDelayedOverlapEndEvent(*OverlapEndEvItr, CurrTime))
-		{
-			// Remove event from the pending list
-			OverlapEndEvItr.RemoveCurrent();
-		}
-	}
-
-	// There are very recent events still available, spin another delay callback to give them a chance to concatenate
-	if(RecentlyEndedOverlapEvents.Num() > 0)
+		return CurrTime - Ev.Time > ConcatenateIfSmaller;
+	}, DueEvents);
+	for (const auto& Ev : DueEvents)
 	{
-		const float DelayValue = ConcatenateIfSmaller + ConcatenateIfSmallerDelay;
-		World->GetTimerManager().SetTimer(DelayTimerHandle, DelayTimerDelegate, DelayValue, false);
+		PublishDelayedOverlapEndEvent(Ev);
 	}
+
+	// There are very recent events still available, the scheduler spins another delay to give them a chance to concatenate
+	return RecentlyEndedOverlapEvents.Num() > 0;
 }
 
 // Broadcast delayed overlaps, if curr time < 0, it guarantees a publish
@@ -332,25 +323,19 @@ bool ISLContactMonitorInterface::PublishDelayedOverlapEndEvent(const FSLOverlapE
 // Skip publishing overlap event if it can be concatenated with the current event start
 bool ISLContactMonitorInterface::SkipOverlapEndEventBroadcast(USLBaseIndividual* InIndividual, float StartTime)
 {
-	for (auto OverlapEndEvItr(RecentlyEndedOverlapEvents.CreateIterator()); OverlapEndEvItr; ++OverlapEndEvItr)
+	// Hash lookup of the events between the same entities, the oldest one within the time difference is removed
+	FSLOverlapEndEvent ConcatenatedEv;
+	if (RecentlyEndedOverlapEvents.RemoveFirstIf(InIndividual, [StartTime](const FSLOverlapEndEvent& Ev)
+	{
+		return StartTime - Ev.Time < ConcatenateIfSmaller;
+	}, ConcatenatedEv))
 	{
-		// Check if it is an event between the same entities
-		if(OverlapEndEvItr->OtherIndividual == InIndividual)
+		// Check if it was the last event, if so, cancel the delayed publishing
+		if(RecentlyEndedOverlapEvents.Num() == 0 && Scheduler)
 		{
-			// Check time difference
-			if(StartTime - OverlapEndEvItr->Time < ConcatenateIfSmaller)
-			{
-				OverlapEndEvItr.RemoveCurrent();
-
-				// Check if it was the last event, if so, pause the delay publisher
-				if(RecentlyEndedOverlapEvents.Num() == 0)
-				{
-					World->GetTimerManager().ClearTimer(DelayTimerHandle);
-				}
-				
-				return true;
-			}
+			Scheduler->CancelOverlapEndFlush(this);
 		}
+		return true;
 	}
 	return false;
 }
@@ -0,0 +1,128 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Monitors/SLContactMonitorScheduler.h"
+#include "Monitors/SLContactMonitorInterface.h"
+
+// Ctor
+FSLContactMonitorScheduler::FSLContactMonitorScheduler()
+{
+	LastSupportedByCheckTime = 0.f;
+}
+
+// Add the monitor to the supported by checks (ignored if it is already scheduled)
+void FSLContactMonitorScheduler::ScheduleSupportedByCheck(ISLContactMonitorInterface* Monitor)
+{
+	if (!Monitor->bSupportedByCheckScheduled)
+	{
+		Monitor->bSupportedByCheckScheduled = true;
+		SupportedByMonitors.Add(Monitor);
+	}
+}
+
+// Publish the delayed overlap end events of the monitor at the given time (ignored if it is already scheduled)
+void FSLContactMonitorScheduler::ScheduleOverlapEndFlush(ISLContactMonitorInterface* Monitor, float FlushTime)
+{
+	if (!Monitor->bOverlapEndFlushScheduled)
+	{
+		Monitor->bOverlapEndFlushScheduled = true;
+		OverlapEndMonitors.Add(Monitor);
+		OverlapEndFlushTimes.Add(FlushTime);
+	}
+}
+
+// Cancel the overlap end flush of the monitor
+void FSLContactMonitorScheduler::CancelOverlapEndFlush(ISLContactMonitorInterface* Monitor)
+{
+	if (Monitor->bOverlapEndFlushScheduled)
+	{
+		const int32 Idx = OverlapEndMonitors.Find(Monitor);
+		OverlapEndMonitors.RemoveAtSwap(Idx, 1, false);
+		OverlapEndFlushTimes.RemoveAtSwap(Idx, 1, false);
+		Monitor->bOverlapEndFlushScheduled = false;
+	}
+}
+
+// Remove the monitor from all the schedules
+void FSLContactMonitorScheduler::RemoveMonitor(ISLContactMonitorInterface* Monitor)
+{
+	CancelOverlapEndFlush(Monitor);
+	if (Monitor->bSupportedByCheckScheduled)
+	{
+		SupportedByMonitors.RemoveSingleSwap(Monitor, false);
+		Monitor->bSupportedByCheckScheduled = false;
+	}
+}
+
+// Run the due supported by checks and overlap end flushes
+void FSLContactMonitorScheduler::Tick(float CurrTime)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+	const int32 NumScheduledMonitors = SupportedByMonitors.Num() + OverlapEndMonitors.Num();
+	int32 NumSupportedByChecks = 0;
+	int32 NumOverlapEndFlushes = 0;
+
+	// All the monitors with candidates are checked in the same sweep, the ones left without candidates are dropped
+	if (SupportedByMonitors.Num() > 0 && CurrTime - LastSupportedByCheckTime >= ISLContactMonitorInterface::SupportedByUpdateRate)
+	{
+		int32 NumKept = 0;
+		for (ISLContactMonitorInterface* Monitor : SupportedByMonitors)
+		{
+			Monitor->SupportedByUpdateCheckBegin();
+			if (Monitor->SupportedByCandidates.Num() > 0)
+			{
+				SupportedByMonitors[NumKept++] = Monitor;
+			}
+			else
+			{
+				Monitor->bSupportedByCheckScheduled = false;
+			}
+		}
+		NumSupportedByChecks = SupportedByMonitors.Num();
+		SupportedByMonitors.SetNum(NumKept, false);
+		LastSupportedByCheckTime = CurrTime;
+	}
+
+	// Publish the due overlap end events, the monitors with too recent events are delayed again
+	int32 NumKept = 0;
+	for (int32 Idx = 0; Idx < OverlapEndMonitors.Num(); ++Idx)
+	{
+		ISLContactMonitorInterface* Monitor = OverlapEndMonitors[Idx];
+		float FlushTime = OverlapEndFlushTimes[Idx];
+		if (CurrTime >= FlushTime)
+		{
+			NumOverlapEndFlushes++;
+			if (!Monitor->DelayedOverlapEndEventCallback())
+			{
+				Monitor->bOverlapEndFlushScheduled = false;
+				continue;
+			}
+			FlushTime = CurrTime + ISLContactMonitorInterface::ConcatenateIfSmaller + ISLContactMonitorInterface::ConcatenateIfSmallerDelay;
+		}
+		OverlapEndMonitors[NumKept] = Monitor;
+		OverlapEndFlushTimes[NumKept] = FlushTime;
+		NumKept++;
+	}
+	OverlapEndMonitors.SetNum(NumKept, false);
+	OverlapEndFlushTimes.SetNum(NumKept, false);
+
+	Stats.AddTick(NumSupportedByChecks, NumOverlapEndFlushes, NumScheduledMonitors, FPlatformTime::Seconds() - ExecBegin);
+}
+
+// Clear the schedules and the statistics
+void FSLContactMonitorScheduler::Reset()
+{
+	for (ISLContactMonitorInterface* Monitor : SupportedByMonitors)
+	{
+		Monitor->bSupportedByCheckScheduled = false;
+	}
+	for (ISLContactMonitorInterface* Monitor : OverlapEndMonitors)
+	{
+		Monitor->bOverlapEndFlushScheduled = false;
+	}
+	SupportedByMonitors.Empty();
+	OverlapEndMonitors.Empty();
+	OverlapEndFlushTimes.Empty();
+	LastSupportedByCheckTime = 0.f;
+	Stats = FSLContactMonitorSchedulerStats();
+}
@@ -24,6 +24,10 @@ USLContactMonitorSphere::USLContactMonitorSphere()
 	bIsFinished = false;
 
 	bLogSupportedByEvents = true;
+	bSupportedByCheckScheduled = false;
+	bOverlapEndFlushScheduled = false;
+
+	Scheduler = nullptr;
 	
 	OwnerIndividualComponent = nullptr;
 
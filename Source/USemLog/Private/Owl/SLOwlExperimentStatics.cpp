@@ -6,6 +6,8 @@
 #include "Owl/SLOwlExperimentStatics.h"
 #include "Misc/Paths.h"
 #include "Misc/FileHelper.h"
+#include "Events/SLEventJournal.h"
+#include "HAL/FileManager.h"
 
 /* Semantic map template creation */
 // Create default experiment document
@@ -115,11 +117,209 @@ void FSLOwlExperimentStatics::WriteToFile(TSharedPtr<FSLOwlExperiment> Experimen
 		FPaths::RemoveDuplicateSlashes(FullFilePath);
 		if (!FPaths::FileExists(FullFilePath) || bOverwrite)
 		{
-			FFileHelper::SaveStringToFile(Experiment->ToString(), *FullFilePath);
+			FSLOwlWriter::WriteDocToFile(*Experiment, FullFilePath);
 		}
 	}
 }
 
+// Write the experiment template with the events of the journal to file, streaming the individuals
+bool FSLOwlExperimentStatics::WriteToFile(TSharedPtr<FSLOwlExperiment> ExperimentTemplate, FSLEventJournalReader& Journal,
+	const FString& Path, bool bOverwrite, const FString& SemMapId, const FString& TaskId)
+{
+	if (!ExperimentTemplate.IsValid() || !Journal.Rewind())
+	{
+		return false;
+	}
+
+	FString FullFilePath = Path + "/" + ExperimentTemplate->Id + TEXT("_ED.owl");
+	FPaths::RemoveDuplicateSlashes(FullFilePath);
+	if (FPaths::FileExists(FullFilePath) && !bOverwrite)
+	{
+		return false;
+	}
+
+	// First pass, the unique timepoints are the only data kept for the whole episode
+	TSet<float> UniqueTimepoints;
+	FSLEventJournalRecord Record;
+	while (Journal.Next(Record))
+	{
+		UniqueTimepoints.Add(Record.StartTime);
+		UniqueTimepoints.Add(Record.EndTime);
+	}
+	TArray<float> Timepoints = UniqueTimepoints.Array();
+	UniqueTimepoints.Empty();
+	Timepoints.Sort();
+
+	FSLOwlWriter Writer;
+	if (!Writer.OpenFile(FullFilePath))
+	{
+		return false;
+	}
+
+	// Template definitions
+	Writer.WriteDocBegin(*ExperimentTemplate);
+
+	// Event individuals (already serialized at the individuals depth)
+	Journal.Rewind();
+	while (Journal.Next(Record))
+	{
+		Writer.WriteRaw(Record.OwlNode);
+	}
+
+	// Timepoint individuals
+	for (int32 Idx = 0; Idx < Timepoints.Num(); ++Idx)
+	{
+		FSLOwlNode TimepointIndividual = FSLOwlExperiment::CreateTimepointIndividual("log", Timepoints[Idx]);
+		if (Idx == 0)
+		{
+			TimepointIndividual.Comment = "Timepoint Individuals";
+		}
+		Writer.WriteNode(TimepointIndividual);
+	}
+
+	// Experiment individual, second pass for the subactions
+	const FSLOwlNode ExperimentIndividual = FSLOwlExperiment::CreateExperimentIndividual(
+		ExperimentTemplate->Prefix, ExperimentTemplate->Id, SemMapId, TaskId, Timepoints);
+	Writer.BeginNode(ExperimentIndividual);
+	for (const auto& ChildNode : ExperimentIndividual.ChildNodes)
+	{
+		Writer.WriteNode(ChildNode);
+	}
+	Journal.Rewind();
+	while (Journal.Next(Record))
+	{
+		Writer.WriteNode(FSLOwlExperiment::CreateSubActionProperty(Record.Id));
+	}
+	Writer.EndNode();
+	Writer.WriteDocEnd();
+	return Writer.Close();
+}
+
+// Previous node serialization, every recursion level returns its concatenated string
+static FString SLConcatNodeToString(const FSLOwlNode& Node, FString& Indent)
+{
+	FString NodeStr;
+	if (!Node.Comment.IsEmpty())
+	{
+		NodeStr += TEXT("\n") + Indent + TEXT("<!-- ") + Node.Comment + TEXT(" -->\n");
+	}
+	if (Node.Name.ToString().IsEmpty())
+	{
+		return NodeStr;
+	}
+	NodeStr += Indent + TEXT("<") + Node.Name.ToString();
+	for (int32 i = 0; i < Node.Attributes.Num(); ++i)
+	{
+		NodeStr += TEXT(" ") + Node.Attributes[i].ToString();
+		if (Node.Attributes.Num() > 1 && i < (Node.Attributes.Num() - 1))
+		{
+			NodeStr += TEXT("\n") + Indent + INDENT_STEP;
+		}
+	}
+	if (Node.ChildNodes.Num() == 0 && Node.Value.IsEmpty())
+	{
+		NodeStr += TEXT("/>\n");
+	}
+	else if (!Node.Value.IsEmpty())
+	{
+		NodeStr += TEXT(">") + Node.Value + TEXT("</") + Node.Name.ToString() + TEXT(">\n");
+	}
+	else
+	{
+		NodeStr += TEXT(">\n");
+		Indent += INDENT_STEP;
+		for (auto& ChildItr : Node.ChildNodes)
+		{
+			NodeStr += SLConcatNodeToString(ChildItr, Indent);
+		}
+		Indent.RemoveFromEnd(INDENT_STEP);
+		NodeStr += Indent + TEXT("</") + Node.Name.ToString() + TEXT(">\n");
+	}
+	return NodeStr;
+}
+
+// Previous document serialization, the root node holds a copy of all the document nodes
+static FString SLConcatDocToString(const FSLOwlDoc& Doc)
+{
+	FString Indent = "";
+	FString DocStr = TEXT("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n\n");
+	DocStr += Doc.EntityDefinitions.ToString();
+	FSLOwlNode Root(FSLOwlPrefixName("rdf", "RDF"), Doc.Namespaces);
+	Root.AddChildNode(Doc.OntologyImports);
+	Root.AddChildNodes(Doc.PropertyDefinitions);
+	Root.AddChildNodes(Doc.DatatypeDefinitions);
+	Root.AddChildNodes(Doc.ClassDefinitions);
+	Root.AddChildNodes(Doc.Individuals);
+	DocStr += SLConcatNodeToString(Root, Indent);
+	return DocStr;
+}
+
+// Compare the streaming writer with the previous recursive string concatenation on a synthetic experiment
+void FSLOwlExperimentStatics::BenchmarkWriter(int32 NumEvents)
+{
+	NumEvents = FMath::Max(NumEvents, 1);
+
+	// Contact like events between a fixed set of objects
+	TSharedPtr<FSLOwlExperiment> Experiment = CreateDefaultExperiment(TEXT("OwlWriterBenchmark"));
+	TSet<float> UniqueTimepoints;
+	for (int32 EvIdx = 0; EvIdx < NumEvents; ++EvIdx)
+	{
+		const float StartTime = EvIdx * 0.1f;
+		const float EndTime = StartTime + 0.5f;
+		FSLOwlNode EvIndividual = CreateEventIndividual("log", FString::Printf(TEXT("ContactEvent_%d"), EvIdx), "TouchingSituation");
+		EvIndividual.AddChildNode(CreateStartTimeProperty("log", StartTime));
+		EvIndividual.AddChildNode(CreateEndTimeProperty("log", EndTime));
+		EvIndividual.AddChildNode(CreateInContactProperty("log", FString::Printf(TEXT("Obj_%d"), EvIdx % 97)));
+		EvIndividual.AddChildNode(CreateInContactProperty("log", FString::Printf(TEXT("Obj_%d"), EvIdx % 89)));
+		Experiment->AddIndividual(EvIndividual);
+		UniqueTimepoints.Add(StartTime);
+		UniqueTimepoints.Add(EndTime);
+	}
+
+	// Timepoint and experiment individuals (the registered timepoints are a linear search, skipped here)
+	TArray<float> Timepoints = UniqueTimepoints.Array();
+	Timepoints.Sort();
+	for (float Ts : Timepoints)
+	{
+		Experiment->AddIndividual(FSLOwlExperiment::CreateTimepointIndividual("log", Ts));
+	}
+	FSLOwlNode ExperimentIndividual = FSLOwlExperiment::CreateExperimentIndividual(
+		Experiment->Prefix, Experiment->Id, TEXT("SemMapId"), TEXT("TaskId"), Timepoints);
+	for (int32 EvIdx = 0; EvIdx < NumEvents; ++EvIdx)
+	{
+		ExperimentIndividual.AddChildNode(FSLOwlExperiment::CreateSubActionProperty(FString::Printf(TEXT("ContactEvent_%d"), EvIdx)));
+	}
+	Experiment->AddIndividual(ExperimentIndividual);
+
+	// Previous recursive concatenation
+	double ExecBegin = FPlatformTime::Seconds();
+	const FString ConcatStr = SLConcatDocToString(*Experiment);
+	const double ConcatDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Writer to memory
+	ExecBegin = FPlatformTime::Seconds();
+	const FString WriterStr = Experiment->ToString();
+	const double WriterDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Previous file output (whole string saved at once)
+	const FString FilePath = FPaths::ProjectSavedDir() + TEXT("/SL/OwlWriterBenchmark_ED.owl");
+	ExecBegin = FPlatformTime::Seconds();
+	FFileHelper::SaveStringToFile(SLConcatDocToString(*Experiment), *FilePath);
+	const double ConcatFileDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Writer to file (chunks)
+	ExecBegin = FPlatformTime::Seconds();
+	FSLOwlWriter::WriteDocToFile(*Experiment, FilePath);
+	const double WriterFileDuration = FPlatformTime::Seconds() - ExecBegin;
+	IFileManager::Get().Delete(*FilePath);
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Owl experiment (events=%d, chars=%d): concat=[%f], writer=[%f] seconds (speedup=%.2fx); to file concat=[%f], writer=[%f] seconds (speedup=%.2fx); identical output=%s;"),
+		*FString(__FUNCTION__), __LINE__, NumEvents, WriterStr.Len(),
+		ConcatDuration, WriterDuration, WriterDuration > 0.0 ? ConcatDuration / WriterDuration : 0.0,
+		ConcatFileDuration, WriterFileDuration, WriterFileDuration > 0.0 ? ConcatFileDuration / WriterFileDuration : 0.0,
+		ConcatStr.Equals(WriterStr, ESearchCase::CaseSensitive) ? TEXT("true") : TEXT("false"));
+}
+
 
 /* Owl individuals creation */
 // Create an object individual
@@ -61,7 +61,7 @@ void FSLOwlTaskStatics::WriteToFile(TSharedPtr<FSLOwlTask> Task, const FString&
 		FPaths::RemoveDuplicateSlashes(FullFilePath);
 		if (!FPaths::FileExists(FullFilePath) || bOverwrite)
 		{
-			FFileHelper::SaveStringToFile(Task->ToString(), *FullFilePath);
+			FSLOwlWriter::WriteDocToFile(*Task, FullFilePath);
 		}
 	}
 }
\ No newline at end of file
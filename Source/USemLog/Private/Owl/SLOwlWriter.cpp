@@ -0,0 +1,305 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Owl/SLOwlWriter.h"
+#include "Owl/SLOwlDoc.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+// Size of the chunks written to the file output
+static const int32 SLOwlWriterChunkSize = 256 * 1024;
+
+// Ctor, memory output, the nodes are indented starting from the given depth
+FSLOwlWriter::FSLOwlWriter(int32 InBaseDepth)
+{
+	FileWriter = nullptr;
+	BaseDepth = InBaseDepth;
+	NumFlushedChars = 0;
+}
+
+// Dtor, closes the file output
+FSLOwlWriter::~FSLOwlWriter()
+{
+	Close();
+}
+
+// Write the output to the given file from now on
+bool FSLOwlWriter::OpenFile(const FString& InFilePath)
+{
+	Close();
+	FilePath = InFilePath;
+	FPaths::RemoveDuplicateSlashes(FilePath);
+	FileWriter = IFileManager::Get().CreateFileWriter(*FilePath);
+	if (FileWriter == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		return false;
+	}
+	Buffer.Reset(SLOwlWriterChunkSize);
+	NumFlushedChars = 0;
+	return true;
+}
+
+// Write the remaining output and close the file (false if any write failed)
+bool FSLOwlWriter::Close()
+{
+	if (FileWriter == nullptr)
+	{
+		return true;
+	}
+
+	FlushToFile(true);
+	const bool bSuccess = FileWriter->Close() && !FileWriter->IsError();
+	if (!bSuccess)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+	}
+	delete FileWriter;
+	FileWriter = nullptr;
+	return bSuccess;
+}
+
+// Write the whole document
+void FSLOwlWriter::WriteDoc(const FSLOwlDoc& Doc)
+{
+	WriteDocBegin(Doc);
+	for (const auto& Node : Doc.Individuals)
+	{
+		WriteNode(Node);
+	}
+	WriteDocEnd();
+}
+
+// Write the document up to its individuals, the root node is left open
+void FSLOwlWriter::WriteDocBegin(const FSLOwlDoc& Doc)
+{
+	Buffer += TEXT("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n\n");
+	WriteEntityDefinitions(Doc.EntityDefinitions);
+	BeginNode(FSLOwlNode(FSLOwlPrefixName("rdf", "RDF"), Doc.Namespaces));
+	WriteNode(Doc.OntologyImports);
+	for (const auto& Node : Doc.PropertyDefinitions)
+	{
+		WriteNode(Node);
+	}
+	for (const auto& Node : Doc.DatatypeDefinitions)
+	{
+		WriteNode(Node);
+	}
+	for (const auto& Node : Doc.ClassDefinitions)
+	{
+		WriteNode(Node);
+	}
+}
+
+// Close the root node of the document
+void FSLOwlWriter::WriteDocEnd()
+{
+	EndNode();
+	FlushToFile(false);
+}
+
+// Write the node with all its children
+void FSLOwlWriter::WriteNode(const FSLOwlNode& Node)
+{
+	WriteComment(Node.Comment);
+
+	// Comment only OR empty node
+	if (Node.Name.IsEmpty())
+	{
+		return;
+	}
+
+	if (Node.ChildNodes.Num() > 0 && Node.Value.IsEmpty())
+	{
+		BeginNode(Node);
+		for (const auto& ChildNode : Node.ChildNodes)
+		{
+			WriteNode(ChildNode);
+		}
+		EndNode();
+		return;
+	}
+
+	WriteIndent();
+	Buffer += TEXT("<");
+	WritePrefixName(Node.Name);
+	WriteAttributes(Node.Attributes);
+	if (Node.Value.IsEmpty())
+	{
+		// No children nor value, close tag
+		Buffer += TEXT("/>\n");
+	}
+	else
+	{
+		// Node cannot have value and children, the value wins
+		Buffer += TEXT(">");
+		Buffer += Node.Value;
+		Buffer += TEXT("</");
+		WritePrefixName(Node.Name);
+		Buffer += TEXT(">\n");
+	}
+	FlushToFile(false);
+}
+
+// Write the comment and the open tag of the node, the children are expected to follow
+void FSLOwlWriter::BeginNode(const FSLOwlNode& Node)
+{
+	WriteComment(Node.Comment);
+	WriteIndent();
+	Buffer += TEXT("<");
+	WritePrefixName(Node.Name);
+	WriteAttributes(Node.Attributes);
+	Buffer += TEXT(">\n");
+	OpenNodes.Push(Node.Name);
+}
+
+// Write the close tag of the last open node
+void FSLOwlWriter::EndNode()
+{
+	if (OpenNodes.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d No open node to close.."), *FString(__FUNCTION__), __LINE__);
+		return;
+	}
+	const FSLOwlPrefixName Name = OpenNodes.Pop(false);
+	WriteIndent();
+	Buffer += TEXT("</");
+	WritePrefixName(Name);
+	Buffer += TEXT(">\n");
+	FlushToFile(false);
+}
+
+// Append already serialized content
+void FSLOwlWriter::WriteRaw(const FString& Str)
+{
+	Buffer += Str;
+	FlushToFile(false);
+}
+
+// Move out the memory output and clear the writer
+FString FSLOwlWriter::ConsumeBuffer()
+{
+	FString Out = MoveTemp(Buffer);
+	Reset();
+	return Out;
+}
+
+// Clear the output and the open nodes, keeps the allocated buffer
+void FSLOwlWriter::Reset()
+{
+	Buffer.Reset();
+	OpenNodes.Reset();
+	NumFlushedChars = 0;
+}
+
+// Write the document directly to the file
+bool FSLOwlWriter::WriteDocToFile(const FSLOwlDoc& Doc, const FString& InFilePath)
+{
+	FSLOwlWriter Writer;
+	if (!Writer.OpenFile(InFilePath))
+	{
+		return false;
+	}
+	Writer.WriteDoc(Doc);
+	return Writer.Close();
+}
+
+// Write the indentation of the current depth (plus the extra steps)
+void FSLOwlWriter::WriteIndent(int32 ExtraDepth)
+{
+	for (int32 Depth = BaseDepth + OpenNodes.Num() + ExtraDepth; Depth > 0; --Depth)
+	{
+		Buffer += INDENT_STEP;
+	}
+}
+
+// Write the prefixed name (e.g. rdf:about)
+void FSLOwlWriter::WritePrefixName(const FSLOwlPrefixName& Name)
+{
+	Buffer += Name.Prefix;
+	if (!Name.LocalName.IsEmpty())
+	{
+		Buffer += TEXT(":");
+		Buffer += Name.LocalName;
+	}
+}
+
+// Write the attributes of an open tag, one per line if there are more
+void FSLOwlWriter::WriteAttributes(const TArray<FSLOwlAttribute>& Attributes)
+{
+	for (int32 Idx = 0; Idx < Attributes.Num(); ++Idx)
+	{
+		const FSLOwlAttribute& Attribute = Attributes[Idx];
+		Buffer += TEXT(" ");
+		WritePrefixName(Attribute.Key);
+		if (Attribute.Value.Ns.IsEmpty())
+		{
+			Buffer += TEXT("=\"");
+		}
+		else
+		{
+			Buffer += TEXT("=\"&");
+			Buffer += Attribute.Value.Ns;
+			Buffer += TEXT(";");
+		}
+		Buffer += Attribute.Value.LocalValue;
+		Buffer += TEXT("\"");
+
+		// Last attribute does not have new line
+		if (Idx < Attributes.Num() - 1)
+		{
+			Buffer += TEXT("\n");
+			WriteIndent(1);
+		}
+	}
+}
+
+// Write the comment of the node
+void FSLOwlWriter::WriteComment(const FString& Comment)
+{
+	if (!Comment.IsEmpty())
+	{
+		Buffer += TEXT("\n");
+		WriteIndent();
+		Buffer += TEXT("<!-- ");
+		Buffer += Comment;
+		Buffer += TEXT(" -->\n");
+	}
+}
+
+// Write the entity definitions
+void FSLOwlWriter::WriteEntityDefinitions(const FSLOwlEntityDTD& EntityDefinitions)
+{
+	if (EntityDefinitions.EntityPairs.Num() == 0)
+	{
+		return;
+	}
+
+	Buffer += TEXT("<!DOCTYPE ");
+	WritePrefixName(EntityDefinitions.Name);
+	Buffer += TEXT("[\n");
+	for (const auto& EntityItr : EntityDefinitions.EntityPairs)
+	{
+		Buffer += INDENT_STEP;
+		Buffer += TEXT("<!ENTITY ");
+		Buffer += EntityItr.Key;
+		Buffer += TEXT(" \"");
+		Buffer += EntityItr.Value;
+		Buffer += TEXT("\">\n");
+	}
+	Buffer += TEXT("]>\n\n");
+}
+
+// Write the buffer to the file if it is large enough (or forced)
+void FSLOwlWriter::FlushToFile(bool bForce)
+{
+	if (FileWriter == nullptr || Buffer.Len() == 0 || (!bForce && Buffer.Len() < SLOwlWriterChunkSize))
+	{
+		return;
+	}
+
+	FTCHARToUTF8 Conv(*Buffer);
+	FileWriter->Serialize(const_cast<ANSICHAR*>(Conv.Get()), Conv.Length());
+	NumFlushedChars += Buffer.Len();
+	Buffer.Reset();
+}
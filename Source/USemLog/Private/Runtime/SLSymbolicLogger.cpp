@@ -15,6 +15,7 @@
 #include "Components/InputComponent.h"
 
 #include "Events/SLGoogleCharts.h"
+#include "Events/SLEventStore.h"
 
 #include "Events/SLContactEventHandler.h"
 #include "Events/SLManipulatorContactEventHandler.h"
@@ -47,9 +48,10 @@
 
 // Sets default values
 ASLSymbolicLogger::ASLSymbolicLogger()
-{
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	// Tick only while started, used by the contact monitors scheduler and the periodic event journal flushing
+	// Tick only while started, used by the contact monitors scheduler
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	// Default values
 	bIsInit = false;
@@ -126,6 +128,14 @@ void ASLSymbolicLogger::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	}
 }
 
+// Called every frame, runs the contact monitors scheduler and flushes the event journal while the logger is started
+void ASLSymbolicLogger::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	ContactMonitorScheduler.Tick(GetWorld()->GetTimeSeconds());
+	EventJournal.Flush(false);
+}
+
 // Init logger (called when the logger is synced externally)
 void ASLSymbolicLogger::Init(const FSLSymbolicLoggerParams& InLoggerParameters,
 	const FSLLoggerLocationParams& InLocationParameters)
@@ -202,6 +212,13 @@ void ASLSymbolicLogger::InitImpl()
 	// Create the document template
 	ExperimentDoc = CreateEventsDocTemplate(ESLOwlExperimentTemplate::Default, LocationParameters.EpisodeId);
 
+	// The finished events are written to disk while logging
+	if (!EventJournal.Open(FSLEventJournal::GetJournalFilePath(LocationParameters.TaskId, LocationParameters.EpisodeId), LocationParameters.bOverwrite))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Symbolic logger (%s) could not open the event journal, the events will not be stored.."),
+			*FString(__FUNCTION__), __LINE__, *GetName());
+	}
+
 	// Setup monitors
 	if (LoggerParameters.EventsSelection.bSelectAll)
 	{
@@ -320,6 +337,12 @@ void ASLSymbolicLogger::StartImpl()
 		Monitor->Start();
 	}
 
+	// Tick the scheduler of the contact monitors and flush the event journal
+	if (ContactMonitors.Num() > 0 || EventJournal.IsOpen())
+	{
+		SetActorTickEnabled(true);
+	}
+
 	//// Start the container Monitors
 	//for (auto& Monitor : ContainerMonitors)
 	//{
@@ -371,8 +394,15 @@ void ASLSymbolicLogger::FinishImpl(bool bForced)
 	for (auto& SLContactMonitor : ContactMonitors)
 	{
 		SLContactMonitor->Finish();
+		SLContactMonitor->SetScheduler(nullptr);
+	}
+	if (ContactMonitors.Num() > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Contact monitors scheduler (monitors=%d) stats: %s"),
+			*FString(__FUNCTION__), __LINE__, ContactMonitors.Num(), *ContactMonitorScheduler.GetStats().ToString());
 	}
 	ContactMonitors.Empty();
+	ContactMonitorScheduler.Reset();
 
 	// Finish the reach Monitors
 	for (auto& SLReachAndPreGraspMonitor : ReachAndPreGraspMonitors)
@@ -402,27 +432,16 @@ void ASLSymbolicLogger::FinishImpl(bool bForced)
 	//}
 	//ContainerMonitors.Empty();
 
-	// Create the experiment owl doc	
-	if (ExperimentDoc.IsValid())
-	{
-		TArray<FString> SubActionIds;		
-		for (const auto& Ev : FinishedEvents)
-		{
-			Ev->AddToOwlDoc(ExperimentDoc.Get());
-			SubActionIds.Add(Ev->Id);
-		}
-
-		// Add stored unique timepoints to doc
-		ExperimentDoc->AddTimepointIndividuals();
+	// All the pending events are published, close the journal
+	EventJournal.Close();
 
-		// Add stored unique objects to doc
-		//ExperimentDoc->AddObjectIndividuals();
-
-		// Add experiment individual to doc	(metadata)	
-		ExperimentDoc->AddExperimentIndividual(SubActionIds, LocationParameters.SemanticMapId, LocationParameters.TaskId);
+	// Stop ticking once the contact monitors are finished and the journal is closed
+	if (IsActorTickEnabled())
+	{
+		SetActorTickEnabled(false);
 	}
 
-	// Write events to file
+	// Export the journal events to file
 	WriteToFile();
 
 #if SL_WITH_ROSBRIDGE
@@ -473,7 +492,7 @@ void ASLSymbolicLogger::SemanticEventFinishedCallback(TSharedPtr<ISLEvent> Event
 {
 	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, FString::Printf(TEXT("%s::%d %s"), *FString(__func__), __LINE__, *Event->ToString()));
 	//UE_LOG(LogTemp, Error, TEXT(">> %s::%d %s"), *FString(__func__), __LINE__, *Event->ToString());
-	FinishedEvents.Add(Event);
+	EventJournal.Append(*Event);
 
 #if SL_WITH_ROSBRIDGE
 	if (LoggerParameters.bPublishToROS)
@@ -488,8 +507,22 @@ void ASLSymbolicLogger::WriteToFile()
 {
 	const FString DirPath = FPaths::ProjectDir() + "/SL/Tasks/" + LocationParameters.TaskId /*+ TEXT("/Episodes/")*/ + "/";
 
+	// The event store columns are only built once the logging is finished, the owl exporter streams the journal records
+	const double ExecBegin = FPlatformTime::Seconds();
+	FSLEventJournalReader Journal;
+	if (!Journal.Open(EventJournal.GetFilePath()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Symbolic logger (%s) could not read the event journal, nothing to write.."),
+			*FString(__FUNCTION__), __LINE__, *GetName());
+		return;
+	}
+
+	// Build the event store columns from the journal
+	FSLEventStore EventStore;
+	const bool bHasEventStore = EventStore.BuildFromJournal(Journal);
+
 	// Write events timelines to file
-	if (LoggerParameters.bWriteTimelines)
+	if (LoggerParameters.bWriteTimelines && bHasEventStore)
 	{
 		FSLGoogleChartsParameters Params;
 		Params.bTooltips = true;
@@ -499,12 +532,22 @@ void ASLSymbolicLogger::WriteToFile()
 		Params.EpisodeId = LocationParameters.EpisodeId;
 		Params.bOverwrite = LocationParameters.bOverwrite;
 		Params.EventsSelection = LoggerParameters.TimelineEventsSelection;
-		FSLGoogleCharts::WriteTimelines(FinishedEvents, DirPath, LocationParameters.EpisodeId, Params);
+		FSLGoogleCharts::WriteTimelines(EventStore, DirPath, LocationParameters.EpisodeId, Params);
 	}
 
-
 	// Write experiment owl to file
-	FSLOwlExperimentStatics::WriteToFile(ExperimentDoc, DirPath, LocationParameters.bOverwrite);
+	FSLOwlExperimentStatics::WriteToFile(ExperimentDoc, Journal, DirPath, LocationParameters.bOverwrite,
+		LocationParameters.SemanticMapId, LocationParameters.TaskId);
+
+	// Write the event store for the post-hoc queries
+	if (bHasEventStore)
+	{
+		EventStore.SaveToFile(FSLEventStore::GetStoreFilePath(LocationParameters.TaskId, LocationParameters.EpisodeId),
+			LocationParameters.bOverwrite);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Symbolic logger (%s) exported %d events in %f seconds.."),
+		*FString(__FUNCTION__), __LINE__, *GetName(), EventJournal.NumEvents(), FPlatformTime::Seconds() - ExecBegin);
 
 	//// Write owl data to file
 	//if (ExperimentDoc.IsValid())
@@ -602,6 +645,7 @@ void ASLSymbolicLogger::InitContactMonitors()
 		{
 			if (IsValidAndLoaded(Itr->GetOwner()))
 			{
+				ContactMonitor->SetScheduler(&ContactMonitorScheduler);
 				ContactMonitor->Init(LoggerParameters.EventsSelection.bSupportedBy);
 				if (ContactMonitor->IsInit())
 				{
@@ -0,0 +1,509 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLWorldStateFileSink.h"
+#include "Runtime/SLWorldStatePoseCodec.h"
+#include "Runtime/SLWorldStateMongoSink.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/MappedFileHandle.h"
+
+// Episode file constants
+static const uint32 SLEpisodeFileMagic = 0x53574C53;		// "SLWS"
+static const uint32 SLEpisodeIndexMagic = 0x49574C53;		// "SLWI"
+static const uint32 SLEpisodeFileVersion = 1;
+static const int32 SLEpisodeRecordHeaderSize = sizeof(double) + 2 * sizeof(uint32);
+static const int32 SLEpisodeTrailerSize = sizeof(uint64) + 2 * sizeof(uint32);
+static const int32 SLEpisodeWriteChunkSize = 1 << 20;
+
+// Append the raw bytes of the value to the buffer
+template<typename T>
+static void SLAppendValue(TArray<uint8>& Buffer, const T& Value)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+}
+
+// Read the raw bytes of the value from the data (false if out of bounds)
+template<typename T>
+static bool SLReadValue(const uint8* Data, int64 Size, int64& InOutOffset, T& OutValue)
+{
+	if (InOutOffset < 0 || InOutOffset + (int64)sizeof(T) > Size)
+	{
+		return false;
+	}
+	FMemory::Memcpy(&OutValue, Data + InOutOffset, sizeof(T));
+	InOutOffset += sizeof(T);
+	return true;
+}
+
+/* File sink */
+// Ctor
+FSLWorldStateFileSink::FSLWorldStateFileSink()
+{
+	FileHandle = nullptr;
+	bWriteFailed = false;
+	PoseEncoding = ESLWorldStatePoseEncoding::PackedFloat;
+	NumWrittenBytes = 0;
+	NumKeyframes = 0;
+}
+
+// Dtor
+FSLWorldStateFileSink::~FSLWorldStateFileSink()
+{
+	if (FileHandle)
+	{
+		Close();
+	}
+}
+
+// Create the episode file
+bool FSLWorldStateFileSink::Init(const FSLWorldStateLoggerParams& InLoggerParameters, const FSLLoggerLocationParams& InLocationParameters)
+{
+	FilePath = GetEpisodeFilePath(InLocationParameters.TaskId, InLocationParameters.EpisodeId);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.FileExists(*FilePath) && !InLocationParameters.bOverwrite)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d World state episode file %s already exists and should not be overwritten.."),
+			*FString(__func__), __LINE__, *FilePath);
+		return false;
+	}
+
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+	FileHandle = PlatformFile.OpenWrite(*FilePath);
+	if (FileHandle == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not open %s for writing.."),
+			*FString(__func__), __LINE__, *FilePath);
+		return false;
+	}
+
+	// The file always stores packed poses
+	PoseEncoding = InLoggerParameters.PoseEncoding == ESLWorldStatePoseEncoding::PackedQuantized
+		? ESLWorldStatePoseEncoding::PackedQuantized : ESLWorldStatePoseEncoding::PackedFloat;
+	bWriteFailed = false;
+	NumWrittenBytes = 0;
+	NumKeyframes = 0;
+	FrameIndex.Empty();
+	WriteBuffer.Empty(SLEpisodeWriteChunkSize);
+	return true;
+}
+
+// Default episode file path of the task and episode
+FString FSLWorldStateFileSink::GetEpisodeFilePath(const FString& TaskId, const FString& EpisodeId)
+{
+	return FPaths::ProjectDir() + TEXT("/SL/Tasks/") + TaskId + TEXT("/") + EpisodeId + TEXT(".slws");
+}
+
+// Write the header and the layout
+bool FSLWorldStateFileSink::Open(const FSLWorldStateLayout& InLayout)
+{
+	if (FileHandle == nullptr)
+	{
+		return false;
+	}
+	Layout = InLayout;
+
+	// Layout
+	TArray<uint8> LayoutData;
+	SLAppendValue(LayoutData, (uint32)Layout.Num());
+	for (int32 Idx = 0; Idx < Layout.Num(); ++Idx)
+	{
+		const char* Id = Layout.Ids.Get(Idx);
+		const uint16 Len = (uint16)FCStringAnsi::Strlen(Id);
+		SLAppendValue(LayoutData, Len);
+		LayoutData.Append(reinterpret_cast<const uint8*>(Id), Len);
+	}
+	for (int32 Idx = 0; Idx < Layout.Num(); ++Idx)
+	{
+		SLAppendValue(LayoutData, (uint8)(Layout.ListedMask[Idx] ? 1 : 0));
+	}
+	SLAppendValue(LayoutData, (uint32)Layout.SkeletalLayouts.Num());
+	for (const auto& SkelLayout : Layout.SkeletalLayouts)
+	{
+		SLAppendValue(LayoutData, SkelLayout.PoseIdx);
+		SLAppendValue(LayoutData, SkelLayout.BlockBegin);
+		SLAppendValue(LayoutData, SkelLayout.BlockEnd);
+		SLAppendValue(LayoutData, (int32)SkelLayout.BonePoseIdxs.Num());
+		for (int32 BoneEntryIdx = 0; BoneEntryIdx < SkelLayout.BonePoseIdxs.Num(); ++BoneEntryIdx)
+		{
+			SLAppendValue(LayoutData, SkelLayout.BoneIndexes[BoneEntryIdx]);
+			SLAppendValue(LayoutData, SkelLayout.BonePoseIdxs[BoneEntryIdx]);
+		}
+	}
+
+	// Header
+	SLAppendValue(WriteBuffer, SLEpisodeFileMagic);
+	SLAppendValue(WriteBuffer, SLEpisodeFileVersion);
+	SLAppendValue(WriteBuffer, (uint32)PoseEncoding);
+	SLAppendValue(WriteBuffer, (uint32)LayoutData.Num());
+	WriteBuffer.Append(LayoutData);
+	return WriteOut();
+}
+
+// Append the frame record
+int32 FSLWorldStateFileSink::WriteFrame(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs)
+{
+	// Nothing is buffered once the file is closed (e.g. after a failed write)
+	if (FileHandle == nullptr)
+	{
+		return 0;
+	}
+
+	Layout.GetWrittenIdxs(MovedIdxs, PackedIdxs);
+	if (PackedIdxs.Num() == 0)
+	{
+		return 0;
+	}
+	FSLWorldStatePoseCodec::Encode(Frame, PackedIdxs, PoseEncoding, PackedData);
+
+	FSLWorldStateFileIndexEntry Entry;
+	Entry.Timestamp = Frame.Timestamp;
+	Entry.Offset = NumWrittenBytes + WriteBuffer.Num();
+	Entry.bKeyframe = MovedIdxs == nullptr ? 1 : 0;
+	FrameIndex.Add(Entry);
+	NumKeyframes += Entry.bKeyframe;
+
+	SLAppendValue(WriteBuffer, Entry.Timestamp);
+	SLAppendValue(WriteBuffer, Entry.bKeyframe);
+	SLAppendValue(WriteBuffer, (uint32)PackedData.Num());
+	WriteBuffer.Append(PackedData);
+	return PackedIdxs.Num();
+}
+
+// Write out the buffer in large chunks
+void FSLWorldStateFileSink::Flush(bool bForce)
+{
+	if (bForce || WriteBuffer.Num() >= SLEpisodeWriteChunkSize)
+	{
+		WriteOut();
+	}
+}
+
+// Write the index footer and close the file
+void FSLWorldStateFileSink::Close()
+{
+	if (bWriteFailed)
+	{
+		// The file was already closed by the failed write, it has no index footer
+		UE_LOG(LogTemp, Error, TEXT("%s::%d World state episode file %s is incomplete, writing failed after %.2f kb (frames=%d); the index can be rebuilt by scanning the records.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath, NumWrittenBytes / 1024.0, FrameIndex.Num());
+		bWriteFailed = false;
+		return;
+	}
+
+	if (FileHandle == nullptr)
+	{
+		return;
+	}
+
+	// Index footer
+	const uint64 IndexOffset = NumWrittenBytes + WriteBuffer.Num();
+	WriteBuffer.Append(reinterpret_cast<const uint8*>(FrameIndex.GetData()), FrameIndex.Num() * sizeof(FSLWorldStateFileIndexEntry));
+	SLAppendValue(WriteBuffer, IndexOffset);
+	SLAppendValue(WriteBuffer, (uint32)FrameIndex.Num());
+	SLAppendValue(WriteBuffer, SLEpisodeIndexMagic);
+	if (!WriteOut())
+	{
+		// The failed write closed the file
+		Close();
+		return;
+	}
+
+	delete FileHandle;
+	FileHandle = nullptr;
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d World state episode file %s: frames=%d (keyframes=%d); kb=%.2f;"),
+		*FString(__FUNCTION__), __LINE__, *FilePath, FrameIndex.Num(), NumKeyframes, NumWrittenBytes / 1024.0);
+}
+
+// Write the buffered bytes to disk
+bool FSLWorldStateFileSink::WriteOut()
+{
+	if (FileHandle == nullptr || WriteBuffer.Num() == 0)
+	{
+		return FileHandle != nullptr;
+	}
+
+	if (!FileHandle->Write(WriteBuffer.GetData(), WriteBuffer.Num()))
+	{
+		// A partial write would invalidate the frame offsets, stop writing and close the file
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write %d bytes to %s, the file is closed.."),
+			*FString(__func__), __LINE__, WriteBuffer.Num(), *FilePath);
+		bWriteFailed = true;
+		delete FileHandle;
+		FileHandle = nullptr;
+		WriteBuffer.Empty();
+		return false;
+	}
+	NumWrittenBytes += WriteBuffer.Num();
+	WriteBuffer.Reset();
+	return true;
+}
+
+
+/* Episode file reader */
+// Ctor
+FSLWorldStateEpisodeFileReader::FSLWorldStateEpisodeFileReader()
+{
+	MappedHandle = nullptr;
+	MappedRegion = nullptr;
+	Data = nullptr;
+	Size = 0;
+}
+
+// Dtor
+FSLWorldStateEpisodeFileReader::~FSLWorldStateEpisodeFileReader()
+{
+	Close();
+}
+
+// Map the file and read its layout and frame index
+bool FSLWorldStateEpisodeFileReader::Open(const FString& InFilePath)
+{
+	Close();
+
+	MappedHandle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*InFilePath);
+	if (MappedHandle)
+	{
+		MappedRegion = MappedHandle->MapRegion();
+	}
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(FallbackData, *InFilePath))
+	{
+		// Mapping is not supported on every platform
+		Data = FallbackData.GetData();
+		Size = FallbackData.Num();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not read %s.."), *FString(__func__), __LINE__, *InFilePath);
+		Close();
+		return false;
+	}
+
+	int64 FramesOffset = 0;
+	if (!ReadLayout(FramesOffset) || !ReadFrameIndex(FramesOffset))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d %s is not a valid world state episode file.."), *FString(__func__), __LINE__, *InFilePath);
+		Close();
+		return false;
+	}
+	return true;
+}
+
+// Unmap the file
+void FSLWorldStateEpisodeFileReader::Close()
+{
+	if (MappedRegion)
+	{
+		delete MappedRegion;
+		MappedRegion = nullptr;
+	}
+	if (MappedHandle)
+	{
+		delete MappedHandle;
+		MappedHandle = nullptr;
+	}
+	FallbackData.Empty();
+	Data = nullptr;
+	Size = 0;
+	Layout = FSLWorldStateLayout();
+	FrameIndex.Empty();
+}
+
+// Decode the poses of the frame (false if the record is invalid)
+bool FSLWorldStateEpisodeFileReader::GetFrame(int32 FrameIdx, TArray<int32>& OutIdxs, TArray<FTransform>& OutPoses) const
+{
+	if (!FrameIndex.IsValidIndex(FrameIdx))
+	{
+		return false;
+	}
+
+	int64 Offset = FrameIndex[FrameIdx].Offset + sizeof(double) + sizeof(uint32);
+	uint32 BlobSize;
+	if (!SLReadValue(Data, Size, Offset, BlobSize) || Offset + BlobSize > Size)
+	{
+		return false;
+	}
+	return FSLWorldStatePoseCodec::Decode(Data + Offset, BlobSize, OutIdxs, OutPoses);
+}
+
+// Write the episode file as a world state collection (bulk inserts)
+bool FSLWorldStateEpisodeFileReader::ImportToMongo(const FString& InFilePath,
+	const FSLWorldStateLoggerParams& InLoggerParameters,
+	const FSLLoggerLocationParams& InLocationParameters,
+	const FSLLoggerDBServerParams& InDBServerParameters)
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	FSLWorldStateEpisodeFileReader Reader;
+	if (!Reader.Open(InFilePath))
+	{
+		return false;
+	}
+
+	// There is no game thread to keep responsive, always write in bulks
+	FSLWorldStateLoggerParams ImportParams = InLoggerParameters;
+	ImportParams.bUseBulkWrites = true;
+
+	FSLWorldStateMongoSink Sink;
+	if (!Sink.Init(nullptr, ImportParams, InLocationParameters, InDBServerParameters) || !Sink.Open(Reader.GetLayout()))
+	{
+		return false;
+	}
+
+	// Sparse records only hold the moved poses, keep the current state of every pose
+	FSLWorldStateFrame State;
+	State.SetNum(Reader.GetLayout().Num());
+	for (int32 Idx = 0; Idx < State.Num(); ++Idx)
+	{
+		State.SetPose(Idx, FTransform::Identity);
+	}
+
+	TArray<int32> Idxs;
+	TArray<FTransform> Poses;
+	for (int32 FrameIdx = 0; FrameIdx < Reader.NumFrames(); ++FrameIdx)
+	{
+		Idxs.Reset();
+		Poses.Reset();
+		if (!Reader.GetFrame(FrameIdx, Idxs, Poses))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Frame %d of %s is invalid, skipping.."),
+				*FString(__func__), __LINE__, FrameIdx, *InFilePath);
+			continue;
+		}
+
+		for (int32 Slot = 0; Slot < Idxs.Num(); ++Slot)
+		{
+			State.SetPose(Idxs[Slot], Poses[Slot]);
+		}
+		State.Timestamp = (float)Reader.GetFrameIndex()[FrameIdx].Timestamp;
+		Sink.WriteFrame(State, Reader.GetFrameIndex()[FrameIdx].bKeyframe ? nullptr : &Idxs);
+		Sink.Flush(false);
+	}
+	Sink.Close();
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Imported %d frames from %s into %s.%s in %f seconds.."),
+		*FString(__FUNCTION__), __LINE__, Reader.NumFrames(), *InFilePath,
+		*InLocationParameters.TaskId, *InLocationParameters.EpisodeId, FPlatformTime::Seconds() - ExecBegin);
+	return true;
+}
+
+// Read the layout from the header
+bool FSLWorldStateEpisodeFileReader::ReadLayout(int64& OutFramesOffset)
+{
+	int64 Offset = 0;
+	uint32 Magic, Version, Encoding, LayoutSize;
+	if (!SLReadValue(Data, Size, Offset, Magic) || Magic != SLEpisodeFileMagic
+		|| !SLReadValue(Data, Size, Offset, Version) || Version != SLEpisodeFileVersion
+		|| !SLReadValue(Data, Size, Offset, Encoding)
+		|| !SLReadValue(Data, Size, Offset, LayoutSize))
+	{
+		return false;
+	}
+	OutFramesOffset = Offset + LayoutSize;
+
+	// Ids
+	uint32 NumIds;
+	if (!SLReadValue(Data, Size, Offset, NumIds))
+	{
+		return false;
+	}
+	for (uint32 Idx = 0; Idx < NumIds; ++Idx)
+	{
+		uint16 Len;
+		if (!SLReadValue(Data, Size, Offset, Len) || Offset + Len > Size)
+		{
+			return false;
+		}
+		FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Data + Offset), Len);
+		Layout.Ids.Add(FString(Converter.Length(), Converter.Get()));
+		Offset += Len;
+	}
+	Layout.ListedMask.Init(false, NumIds);
+	for (uint32 Idx = 0; Idx < NumIds; ++Idx)
+	{
+		uint8 bListed;
+		if (!SLReadValue(Data, Size, Offset, bListed))
+		{
+			return false;
+		}
+		Layout.ListedMask[Idx] = bListed != 0;
+	}
+
+	// Skeletal layouts
+	uint32 NumSkel;
+	if (!SLReadValue(Data, Size, Offset, NumSkel))
+	{
+		return false;
+	}
+	for (uint32 SkelIdx = 0; SkelIdx < NumSkel; ++SkelIdx)
+	{
+		FSLWorldStateSkeletalLayout SkelLayout;
+		int32 NumBones;
+		if (!SLReadValue(Data, Size, Offset, SkelLayout.PoseIdx)
+			|| !SLReadValue(Data, Size, Offset, SkelLayout.BlockBegin)
+			|| !SLReadValue(Data, Size, Offset, SkelLayout.BlockEnd)
+			|| !SLReadValue(Data, Size, Offset, NumBones))
+		{
+			return false;
+		}
+		for (int32 BoneEntryIdx = 0; BoneEntryIdx < NumBones; ++BoneEntryIdx)
+		{
+			int32 BoneIndex, BonePoseIdx;
+			if (!SLReadValue(Data, Size, Offset, BoneIndex) || !SLReadValue(Data, Size, Offset, BonePoseIdx))
+			{
+				return false;
+			}
+			SkelLayout.BoneIndexes.Add(BoneIndex);
+			SkelLayout.BonePoseIdxs.Add(BonePoseIdx);
+		}
+		Layout.SkeletalLayouts.Emplace(SkelLayout);
+	}
+	return Offset == OutFramesOffset;
+}
+
+// Read the index footer, or rebuild it by scanning the records
+bool FSLWorldStateEpisodeFileReader::ReadFrameIndex(int64 FramesOffset)
+{
+	// Footer written on close
+	int64 Offset = Size - SLEpisodeTrailerSize;
+	uint64 IndexOffset;
+	uint32 NumFrames, Magic;
+	if (SLReadValue(Data, Size, Offset, IndexOffset)
+		&& SLReadValue(Data, Size, Offset, NumFrames)
+		&& SLReadValue(Data, Size, Offset, Magic)
+		&& Magic == SLEpisodeIndexMagic
+		&& IndexOffset + (uint64)NumFrames * sizeof(FSLWorldStateFileIndexEntry) + SLEpisodeTrailerSize == (uint64)Size)
+	{
+		FrameIndex.SetNumUninitialized(NumFrames);
+		FMemory::Memcpy(FrameIndex.GetData(), Data + IndexOffset, NumFrames * sizeof(FSLWorldStateFileIndexEntry));
+		return true;
+	}
+
+	// The episode was not closed properly, index the complete records
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode file has no frame index, rebuilding it.."), *FString(__func__), __LINE__);
+	Offset = FramesOffset;
+	while (Offset + SLEpisodeRecordHeaderSize <= Size)
+	{
+		FSLWorldStateFileIndexEntry Entry;
+		uint32 BlobSize;
+		Entry.Offset = Offset;
+		SLReadValue(Data, Size, Offset, Entry.Timestamp);
+		SLReadValue(Data, Size, Offset, Entry.bKeyframe);
+		SLReadValue(Data, Size, Offset, BlobSize);
+		if (Offset + BlobSize > Size)
+		{
+			break;
+		}
+		Offset += BlobSize;
+		FrameIndex.Add(Entry);
+	}
+	return true;
+}
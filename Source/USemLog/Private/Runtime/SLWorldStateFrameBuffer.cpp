@@ -0,0 +1,141 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLWorldStateFrameBuffer.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeLock.h"
+
+// Ctor
+FSLWorldStateFrameBuffer::FSLWorldStateFrameBuffer()
+{
+	Head = 0;
+	Tail = 0;
+	Count = 0;
+	Policy = ESLWorldStateBackpressurePolicy::DropOldest;
+	bIsReleased = false;
+	DataAvailableEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	SpaceAvailableEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+// Dtor
+FSLWorldStateFrameBuffer::~FSLWorldStateFrameBuffer()
+{
+	FPlatformProcess::ReturnSynchEventToPool(DataAvailableEvent);
+	DataAvailableEvent = nullptr;
+	FPlatformProcess::ReturnSynchEventToPool(SpaceAvailableEvent);
+	SpaceAvailableEvent = nullptr;
+}
+
+// Allocate the slots and set the full buffer policy
+void FSLWorldStateFrameBuffer::Init(int32 InCapacity, ESLWorldStateBackpressurePolicy InPolicy)
+{
+	FScopeLock ScopeLock(&SlotsLock);
+	Slots.Empty();
+	Slots.SetNum(FMath::Max(InCapacity, 1));
+	Head = 0;
+	Tail = 0;
+	Count = 0;
+	Policy = InPolicy;
+	bIsReleased = false;
+}
+
+// Swap the frame into the buffer, InOutFrame receives the recycled slot data (false if a pending frame was dropped)
+bool FSLWorldStateFrameBuffer::Enqueue(FSLWorldStateFrame& InOutFrame)
+{
+	Counters.Captured.Increment();
+	bool bNoDrop = true;
+
+	SlotsLock.Lock();
+	if (Count == Slots.Num())
+	{
+		if (Policy == ESLWorldStateBackpressurePolicy::Block && !bIsReleased)
+		{
+			// Wait for the writer to free up a slot
+			Counters.Blocked.Increment();
+			while (Count == Slots.Num() && !bIsReleased)
+			{
+				SlotsLock.Unlock();
+				SpaceAvailableEvent->Wait(5);
+				SlotsLock.Lock();
+			}
+		}
+
+		if (Count == Slots.Num())
+		{
+			if (Policy == ESLWorldStateBackpressurePolicy::Coalesce)
+			{
+				// Replace the newest pending frame, the writer compares against the last written poses so no movement is lost
+				const int32 NewestIdx = (Head - 1 + Slots.Num()) % Slots.Num();
+				Swap(Slots[NewestIdx], InOutFrame);
+				Counters.Coalesced.Increment();
+				Counters.Dropped.Increment();
+				SlotsLock.Unlock();
+				DataAvailableEvent->Trigger();
+				return false;
+			}
+			else
+			{
+				// Drop the oldest pending frame (also the fallback of a released blocking buffer)
+				Tail = (Tail + 1) % Slots.Num();
+				Count--;
+				Counters.Dropped.Increment();
+				bNoDrop = false;
+			}
+		}
+	}
+
+	Swap(Slots[Head], InOutFrame);
+	Head = (Head + 1) % Slots.Num();
+	Count++;
+	SlotsLock.Unlock();
+
+	DataAvailableEvent->Trigger();
+	return bNoDrop;
+}
+
+// Swap the oldest pending frame out of the buffer (false if empty)
+bool FSLWorldStateFrameBuffer::Dequeue(FSLWorldStateFrame& OutFrame)
+{
+	{
+		FScopeLock ScopeLock(&SlotsLock);
+		if (Count == 0)
+		{
+			return false;
+		}
+		Swap(Slots[Tail], OutFrame);
+		Tail = (Tail + 1) % Slots.Num();
+		Count--;
+	}
+	SpaceAvailableEvent->Trigger();
+	return true;
+}
+
+// Wait until new frames are available or the timeout expires (true if triggered)
+bool FSLWorldStateFrameBuffer::WaitForData(uint32 WaitTimeMs)
+{
+	return DataAvailableEvent->Wait(WaitTimeMs);
+}
+
+// Unblock any waiting producer or consumer, blocking enqueues will drop frames from now on
+void FSLWorldStateFrameBuffer::Release()
+{
+	bIsReleased = true;
+	DataAvailableEvent->Trigger();
+	SpaceAvailableEvent->Trigger();
+}
+
+// Number of pending frames
+int32 FSLWorldStateFrameBuffer::Num() const
+{
+	FScopeLock ScopeLock(&SlotsLock);
+	return Count;
+}
+
+// Get the statistics as string
+FString FSLWorldStateFrameBuffer::GetCountersString() const
+{
+	return FString::Printf(TEXT("captured=%d; written=%d; dropped=%d (coalesced=%d); blocked=%d;"),
+		Counters.Captured.GetValue(), Counters.Written.GetValue(), Counters.Dropped.GetValue(),
+		Counters.Coalesced.GetValue(), Counters.Blocked.GetValue());
+}
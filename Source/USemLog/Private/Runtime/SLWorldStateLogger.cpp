@@ -3,6 +3,11 @@
 
 #include "Runtime/SLWorldStateLogger.h"
 #include "Individuals/SLIndividualManager.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+#include "Individuals/Type/SLBoneIndividual.h"
+#include "Individuals/Type/SLVirtualBoneIndividual.h"
+#include "Individuals/Type/SLBoneConstraintIndividual.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "Utils/SLUuid.h"
 #include "EngineUtils.h"
 #include "TimerManager.h"
@@ -191,6 +196,7 @@ void ASLWorldStateLogger::InitImpl()
 			*FString(__FUNCTION__), __LINE__, *GetName());
 		return;
 	}
+	SetCaptureSources();
 
 	bIsInit = true;
 	UE_LOG(LogTemp, Warning, TEXT("%s::%d World state logger (%s) succesfully initialized at %.2f.."),
@@ -337,14 +343,82 @@ bool ASLWorldStateLogger::SetIndividualManager()
 	return true;
 }
 
+// Resolve the components the individual poses are read from
+void ASLWorldStateLogger::SetCaptureSources()
+{
+	CaptureIndividuals = DBHandler->GetCaptureIndividuals();
+	CaptureComponents.Empty(CaptureIndividuals.Num());
+	CaptureBoneIndexes.Empty(CaptureIndividuals.Num());
+
+	for (const auto& Individual : CaptureIndividuals)
+	{
+		USceneComponent* Component = nullptr;
+		int32 BoneIndex = INDEX_NONE;
+		if (Individual->IsInit())
+		{
+			if (auto AsBI = Cast<USLBoneIndividual>(Individual))
+			{
+				Component = AsBI->GetSkeletalMeshComponent();
+				BoneIndex = AsBI->GetBoneIndex();
+			}
+			else if (auto AsVBI = Cast<USLVirtualBoneIndividual>(Individual))
+			{
+				Component = AsVBI->GetSkeletalMeshComponent();
+				BoneIndex = AsVBI->GetBoneIndex();
+			}
+			else if (!Individual->IsA(USLBoneConstraintIndividual::StaticClass()))
+			{
+				// Same as AActor::GetTransform(), constraints are left to compute their own pose
+				if (AActor* ParentActor = Individual->GetParentActor())
+				{
+					Component = ParentActor->GetRootComponent();
+				}
+			}
+		}
+		CaptureComponents.Add(Component);
+		CaptureBoneIndexes.Add(BoneIndex);
+	}
+	CurrFrame.SetNum(CaptureIndividuals.Num());
+}
+
+// Read the current poses of the individuals into the frame
+void ASLWorldStateLogger::CaptureFrame()
+{
+	CurrFrame.Timestamp = GetWorld()->GetTimeSeconds();
+	CurrFrame.SetNum(CaptureComponents.Num());
+	for (int32 Idx = 0; Idx < CaptureComponents.Num(); ++Idx)
+	{
+		if (USceneComponent* Component = CaptureComponents[Idx])
+		{
+			const int32 BoneIndex = CaptureBoneIndexes[Idx];
+			if (BoneIndex == INDEX_NONE)
+			{
+				CurrFrame.SetPose(Idx, Component->GetComponentTransform());
+			}
+			else
+			{
+				CurrFrame.SetPose(Idx, static_cast<USkinnedMeshComponent*>(Component)->GetBoneTransform(BoneIndex));
+			}
+		}
+		else
+		{
+			FTransform Pose;
+			CaptureIndividuals[Idx]->UpdateCachedPose(0.f, &Pose);
+			CurrFrame.SetPose(Idx, Pose);
+		}
+	}
+}
+
 // First update call (log all individuals)
 void ASLWorldStateLogger::FirstUpdate()
 {
-	DBHandler->FirstWrite(GetWorld()->GetTimeSeconds());	
+	CaptureFrame();
+	DBHandler->FirstWrite(CurrFrame);
 }
 
 // Log individuals which changed state
 void ASLWorldStateLogger::Update()
 {
-	DBHandler->Write(GetWorld()->GetTimeSeconds());
+	CaptureFrame();
+	DBHandler->Write(CurrFrame);
 }
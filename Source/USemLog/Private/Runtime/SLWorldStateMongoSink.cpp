@@ -0,0 +1,835 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLWorldStateMongoSink.h"
+#include "Runtime/SLWorldStatePoseCodec.h"
+#include "Runtime/SLWorldStatePoseDiff.h"
+#include "Individuals/SLIndividualManager.h"
+#include "Individuals/Type/SLBaseIndividual.h"
+
+// UUtils
+#if SL_WITH_ROS_CONVERSIONS
+#include "Conversions.h"
+#endif // SL_WITH_ROS_CONVERSIONS
+
+// Ctor
+FSLWorldStateMongoSink::FSLWorldStateMongoSink()
+{
+	bIsInit = false;
+	PoseEncoding = ESLWorldStatePoseEncoding::Document;
+	bUseBulkWrites = false;
+	BulkMaxFrames = 1;
+	BulkMaxDelay = 0.f;
+	BulkNumDocs = 0;
+	BulkNumBytes = 0;
+	BulkStartTime = 0.0;
+#if SL_WITH_LIBMONGO_C
+	uri = nullptr;
+	client = nullptr;
+	database = nullptr;
+	collection = nullptr;
+	mongo_bulk = nullptr;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Dtor
+FSLWorldStateMongoSink::~FSLWorldStateMongoSink()
+{
+	if (bIsInit)
+	{
+		Close();
+	}
+}
+
+// Connect to the database and write the metadata (skipped if the individual manager is null)
+bool FSLWorldStateMongoSink::Init(ASLIndividualManager* IndividualManager,
+	const FSLWorldStateLoggerParams& InLoggerParameters,
+	const FSLLoggerLocationParams& InLocationParameters,
+	const FSLLoggerDBServerParams& InDBServerParameters)
+{
+#if SL_WITH_LIBMONGO_C
+	// Connect to the database
+	if (!Connect(InLocationParameters.TaskId, InLocationParameters.EpisodeId,
+		InDBServerParameters.Ip, InDBServerParameters.Port,
+		InLocationParameters.bOverwrite))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d World state mongo sink could not connect to the database.."), *FString(__FUNCTION__), __LINE__);
+		Disconnect();
+		return false;
+	}
+
+	// Write metadata if needed
+	if (IndividualManager && InLoggerParameters.bIncludeMetadata)
+	{
+		WriteMetadata(IndividualManager, InLocationParameters.TaskId + ".meta", InLoggerParameters.bOverwriteMetadata);
+	}
+
+	PoseEncoding = InLoggerParameters.PoseEncoding;
+	bUseBulkWrites = InLoggerParameters.bUseBulkWrites;
+	BulkMaxFrames = FMath::Max(InLoggerParameters.BulkMaxFrames, 1);
+	BulkMaxDelay = InLoggerParameters.BulkMaxDelay;
+	bIsInit = true;
+	return true;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d SL_WITH_LIBMONGO_C flag is 0, aborting.."),
+		*FString(__func__), __LINE__);
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Prepare the output for frames with the given layout
+bool FSLWorldStateMongoSink::Open(const FSLWorldStateLayout& InLayout)
+{
+	if (!bIsInit)
+	{
+		return false;
+	}
+	Layout = InLayout;
+
+	// Packed documents only reference the individuals by their index
+	if (PoseEncoding != ESLWorldStatePoseEncoding::Document && !WritePoseTable())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d World state pose table could not be written, the packed poses cannot be decoded.."),
+			*FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+	return true;
+}
+
+// Write the frame, all poses if MovedIdxs is null (keyframe) otherwise only the (sorted) moved ones
+int32 FSLWorldStateMongoSink::WriteFrame(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs)
+{
+	// Count the number of entries written to the document (if 0, skip upload)
+	int32 Num = 0;
+
+#if SL_WITH_LIBMONGO_C
+	bson_t* ws_doc;
+	ws_doc = bson_new();
+
+	AddTimestamp(Frame.Timestamp, ws_doc);
+	if (MovedIdxs == nullptr)
+	{
+		BSON_APPEND_BOOL(ws_doc, "keyframe", true);
+	}
+
+	if (PoseEncoding == ESLWorldStatePoseEncoding::Document)
+	{
+		Num += MovedIdxs ? AddIndividualsThatMoved(Frame, *MovedIdxs, ws_doc) : AddAllIndividuals(Frame, ws_doc);
+		Num += AddSkeletalIndividals(Frame, MovedIdxs, ws_doc);
+	}
+	else
+	{
+		Num += AddPackedPoses(Frame, MovedIdxs, ws_doc);
+	}
+
+	// Write only if there are any entries in the document
+	if (Num > 0)
+	{
+		UploadDoc(ws_doc);
+	}
+
+	// Clean up
+	bson_destroy(ws_doc);
+#endif //SL_WITH_LIBMONGO_C
+
+	return Num;
+}
+
+// Write the bulk if it is full or its oldest document waited for too long
+void FSLWorldStateMongoSink::Flush(bool bForce)
+{
+#if SL_WITH_LIBMONGO_C
+	if (mongo_bulk == nullptr)
+	{
+		return;
+	}
+
+	if (bForce || BulkNumDocs >= BulkMaxFrames
+		|| FPlatformTime::Seconds() - BulkStartTime >= BulkMaxDelay)
+	{
+		ExecuteBulk();
+	}
+#endif //SL_WITH_LIBMONGO_C	
+}
+
+// Wake up often enough to respect the bulk max delay even if no new frames arrive
+uint32 FSLWorldStateMongoSink::GetFlushWaitTimeMs() const
+{
+	return bUseBulkWrites ? FMath::Clamp<uint32>((uint32)(BulkMaxDelay * 1000.f), 1, 100) : 100;
+}
+
+// Write the remaining data and close the output
+void FSLWorldStateMongoSink::Close()
+{
+	if (!bIsInit)
+	{
+		return;
+	}
+
+	Flush(true);
+	if (bUseBulkWrites)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d World state bulk writes: %s"),
+			*FString(__FUNCTION__), __LINE__, *BulkStats.ToString());
+	}
+
+	// Finish up
+	CreateIndexes();
+	Disconnect();
+	bIsInit = false;
+}
+
+#if SL_WITH_LIBMONGO_C
+// Add timestamp to the bson doc
+void FSLWorldStateMongoSink::AddTimestamp(float Timestamp, bson_t* doc)
+{
+	BSON_APPEND_DOUBLE(doc, "timestamp", Timestamp);
+}
+
+// Add all individuals (return the number of individuals added)
+int32 FSLWorldStateMongoSink::AddAllIndividuals(const FSLWorldStateFrame& Frame, bson_t* doc)
+{
+	int32 Num = 0;
+	bson_t arr_obj;
+	uint32_t arr_idx = 0;
+
+	BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &arr_obj);
+	for (TConstSetBitIterator<> It(Layout.ListedMask); It; ++It)
+	{
+		const int32 Idx = It.GetIndex();
+		bson_t individual_obj;
+		char idx_str[16];
+		const char* idx_key;
+
+		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
+			// Id
+			BSON_APPEND_UTF8(&individual_obj, "id", Layout.Ids.Get(Idx));
+			// Pose
+			AddPose(Frame.GetPose(Idx), &individual_obj);
+		bson_append_document_end(&arr_obj, &individual_obj);
+
+		arr_idx++;
+		Num++;
+	}
+	bson_append_array_end(doc, &arr_obj);
+	return Num;
+}
+
+// Add only the individuals that moved since the last written frame (return the number of individuals added)
+int32 FSLWorldStateMongoSink::AddIndividualsThatMoved(const FSLWorldStateFrame& Frame, const TArray<int32>& MovedIdxs, bson_t* doc)
+{
+	int32 Num = 0;
+
+	bson_t individuals_arr;
+	uint32_t arr_idx = 0;
+
+	BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &individuals_arr);
+	for (const int32 Idx : MovedIdxs)
+	{
+		if (Layout.ListedMask[Idx])
+		{
+			bson_t individual_obj;
+			char idx_str[16];
+			const char* idx_key;
+
+			bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&individuals_arr, idx_key, &individual_obj);
+				// Id
+				BSON_APPEND_UTF8(&individual_obj, "id", Layout.Ids.Get(Idx));
+				// Pose
+				AddPose(Frame.GetPose(Idx), &individual_obj);
+			bson_append_document_end(&individuals_arr, &individual_obj);
+
+			arr_idx++;
+			Num++;
+		}
+	}
+	bson_append_array_end(doc, &individuals_arr);
+	return Num;
+}
+
+// Add skeletal individuals, if MovedIdxs is set only the ones with a moved block entry (return the number of individuals added)
+int32 FSLWorldStateMongoSink::AddSkeletalIndividals(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs, bson_t* doc)
+{
+	int32 Num = 0;
+	bson_t arr_obj;
+	uint32_t arr_idx = 0;
+
+	BSON_APPEND_ARRAY_BEGIN(doc, "skel_individuals", &arr_obj);
+	for (const auto& SkelLayout : Layout.SkeletalLayouts)
+	{
+		if (MovedIdxs && !FSLWorldStatePoseDiff::AnyMovedInRange(*MovedIdxs, SkelLayout.BlockBegin, SkelLayout.BlockEnd))
+		{
+			continue;
+		}
+
+		bson_t individual_obj;
+		char idx_str[16];
+		const char* idx_key;
+
+		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
+			// Id
+			BSON_APPEND_UTF8(&individual_obj, "id", Layout.Ids.Get(SkelLayout.PoseIdx));
+			// Pose
+			AddPose(Frame.GetPose(SkelLayout.PoseIdx), &individual_obj);
+			// Bones
+			AddSkeletalBoneIndividuals(Frame, SkelLayout, &individual_obj);
+		bson_append_document_end(&arr_obj, &individual_obj);
+
+		arr_idx++;
+		Num++;
+	}
+	bson_append_array_end(doc, &arr_obj);
+	return Num;
+}
+
+// Add skeletal bones to the document
+void FSLWorldStateMongoSink::AddSkeletalBoneIndividuals(const FSLWorldStateFrame& Frame,
+	const FSLWorldStateSkeletalLayout& SkelLayout, bson_t* doc)
+{
+	bson_t bones_arr;
+	bson_t arr_obj;
+	char idx_str[16];
+	const char* idx_key;
+	uint32_t arr_idx = 0;
+
+	BSON_APPEND_ARRAY_BEGIN(doc, "bones", &bones_arr);
+	for (int32 BoneEntryIdx = 0; BoneEntryIdx < SkelLayout.BonePoseIdxs.Num(); ++BoneEntryIdx)
+	{
+		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, idx_key, &arr_obj);
+			// Bone index
+			BSON_APPEND_INT32(&arr_obj, "idx", SkelLayout.BoneIndexes[BoneEntryIdx]);
+			// Bone world pose
+			AddPose(Frame.GetPose(SkelLayout.BonePoseIdxs[BoneEntryIdx]), &arr_obj);
+		bson_append_document_end(&bones_arr, &arr_obj);
+		arr_idx++;
+	}
+	bson_append_array_end(doc, &bones_arr);
+}
+
+// Add pose document
+void FSLWorldStateMongoSink::AddPose(FTransform Pose, bson_t* doc)
+{
+#if SL_WITH_ROS_CONVERSIONS
+	FConversions::UToROS(Pose);
+#endif // SL_WITH_ROS_CONVERSIONS
+
+	bson_t child_obj_loc;
+	bson_t child_obj_rot;
+
+	BSON_APPEND_DOCUMENT_BEGIN(doc, "loc", &child_obj_loc);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "x", Pose.GetLocation().X);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "y", Pose.GetLocation().Y);
+	BSON_APPEND_DOUBLE(&child_obj_loc, "z", Pose.GetLocation().Z);
+	bson_append_document_end(doc, &child_obj_loc);
+
+	BSON_APPEND_DOCUMENT_BEGIN(doc, "quat", &child_obj_rot);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "x", Pose.GetRotation().X);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "y", Pose.GetRotation().Y);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "z", Pose.GetRotation().Z);
+	BSON_APPEND_DOUBLE(&child_obj_rot, "w", Pose.GetRotation().W);
+	bson_append_document_end(doc, &child_obj_rot);
+
+	bson_t child_pose;
+	char buf[16];
+	const char* key;
+	size_t keylen;
+
+	// Write pose as array of [x y z qx qy qz qw]
+	BSON_APPEND_ARRAY_BEGIN(doc, "pose", &child_pose);
+		// x
+		keylen = bson_uint32_to_string(0, &key, buf, sizeof buf);
+		bson_append_double(&child_pose, key, (int)keylen, Pose.GetLocation().X);
+		// y
+		keylen = bson_uint32_to_string(1, &key, buf, sizeof buf);
+		bson_append_double(&child_pose, key, (int)keylen, Pose.GetLocation().Y);
+		// z
+		keylen = bson_uint32_to_string(2, &key, buf, sizeof buf);
+		bson_append_double(&child_pose, key, (int)keylen, Pose.GetLocation().Z);
+		// qx
+		keylen = bson_uint32_to_string(3, &key, buf, sizeof buf);
+		bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().X);
+		// qy
+		keylen = bson_uint32_to_string(4, &key, buf, sizeof buf);
+		bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().Y);
+		// qz
+		keylen = bson_uint32_to_string(5, &key, buf, sizeof buf);
+		bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().Z);
+		// qw
+		keylen = bson_uint32_to_string(6, &key, buf, sizeof buf);
+		bson_append_double(&child_pose, key, (int)keylen, Pose.GetRotation().W);
+	bson_append_array_end(doc, &child_pose);
+}
+
+// Add all or only the moved poses as one binary blob, moved skeletal blocks are added whole (return the number of poses added)
+int32 FSLWorldStateMongoSink::AddPackedPoses(const FSLWorldStateFrame& Frame, const TArray<int32>* MovedIdxs, bson_t* doc)
+{
+	Layout.GetWrittenIdxs(MovedIdxs, PackedIdxs);
+	if (PackedIdxs.Num() > 0)
+	{
+		FSLWorldStatePoseCodec::Encode(Frame, PackedIdxs, PoseEncoding, PackedData);
+		BSON_APPEND_BINARY(doc, "poses", BSON_SUBTYPE_BINARY, PackedData.GetData(), PackedData.Num());
+	}
+	return PackedIdxs.Num();
+}
+
+// Write the bson doc to the collection (or add it to the current bulk insert)
+bool FSLWorldStateMongoSink::UploadDoc(bson_t* doc)
+{
+	if (bUseBulkWrites)
+	{
+		if (mongo_bulk == nullptr)
+		{
+			// Unordered, the server can apply the inserts in parallel and continue after an error
+			bson_t bulk_opts;
+			bson_init(&bulk_opts);
+			BSON_APPEND_BOOL(&bulk_opts, "ordered", false);
+			mongo_bulk = mongoc_collection_create_bulk_operation_with_opts(collection, &bulk_opts);
+			bson_destroy(&bulk_opts);
+			BulkNumDocs = 0;
+			BulkNumBytes = 0;
+			BulkStartTime = FPlatformTime::Seconds();
+		}
+
+		// The document is copied into the bulk command, the caller can destroy it
+		mongoc_bulk_operation_insert(mongo_bulk, doc);
+		BulkNumDocs++;
+		BulkNumBytes += doc->len;
+		return true;
+	}
+
+	bson_error_t error;
+	if (!mongoc_collection_insert_one(collection, doc, NULL, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		return false;
+	}
+	return true;
+}
+
+// Write the accumulated documents with one unordered bulk insert
+bool FSLWorldStateMongoSink::ExecuteBulk()
+{
+	if (mongo_bulk == nullptr)
+	{
+		return true;
+	}
+
+	bson_t reply;
+	bson_error_t error;
+	const double ExecBegin = FPlatformTime::Seconds();
+	const bool bSuccess = mongoc_bulk_operation_execute(mongo_bulk, &reply, &error) != 0;
+	const double Latency = FPlatformTime::Seconds() - ExecBegin;
+
+	if (bSuccess)
+	{
+		BulkStats.AddBatch(BulkNumDocs, BulkNumBytes, Latency);
+	}
+	else
+	{
+		BulkStats.NumErrors++;
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Bulk insert of %d docs failed, err.: %s"),
+			*FString(__func__), __LINE__, BulkNumDocs, *FString(error.message));
+	}
+
+	// Clean up
+	bson_destroy(&reply);
+	mongoc_bulk_operation_destroy(mongo_bulk);
+	mongo_bulk = nullptr;
+	BulkNumDocs = 0;
+	BulkNumBytes = 0;
+	return bSuccess;
+}
+#endif //SL_WITH_LIBMONGO_C
+
+// Write the ids and the skeletal layout needed to decode the packed poses
+bool FSLWorldStateMongoSink::WritePoseTable()
+{
+#if SL_WITH_LIBMONGO_C
+	bson_t* table_doc = bson_new();
+	bson_t table_obj;
+	bson_t arr_obj;
+	bson_t arr_elem;
+	char idx_str[16];
+	const char* idx_key;
+
+	// The document has no timestamp, the frame queries skip it
+	BSON_APPEND_DOCUMENT_BEGIN(table_doc, "pose_table", &table_obj);
+		BSON_APPEND_INT32(&table_obj, "encoding", (int32)PoseEncoding);
+
+		// Ids in pose index order, and if they are part of the individuals array
+		BSON_APPEND_ARRAY_BEGIN(&table_obj, "ids", &arr_obj);
+		for (int32 Idx = 0; Idx < Layout.Ids.Num(); ++Idx)
+		{
+			bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_UTF8(&arr_obj, idx_key, Layout.Ids.Get(Idx));
+		}
+		bson_append_array_end(&table_obj, &arr_obj);
+
+		BSON_APPEND_ARRAY_BEGIN(&table_obj, "listed", &arr_obj);
+		for (int32 Idx = 0; Idx < Layout.ListedMask.Num(); ++Idx)
+		{
+			bson_uint32_to_string(Idx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_BOOL(&arr_obj, idx_key, Layout.ListedMask[Idx]);
+		}
+		bson_append_array_end(&table_obj, &arr_obj);
+
+		// Skeletal individuals with the skeleton bone index of their bone entries
+		BSON_APPEND_ARRAY_BEGIN(&table_obj, "skel", &arr_obj);
+		for (int32 LayoutIdx = 0; LayoutIdx < Layout.SkeletalLayouts.Num(); ++LayoutIdx)
+		{
+			const FSLWorldStateSkeletalLayout& SkelLayout = Layout.SkeletalLayouts[LayoutIdx];
+			bson_t bones_arr;
+			bson_t bone_obj;
+			char bone_idx_str[16];
+			const char* bone_idx_key;
+
+			bson_uint32_to_string(LayoutIdx, &idx_key, idx_str, sizeof idx_str);
+			BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &arr_elem);
+				BSON_APPEND_INT32(&arr_elem, "pose_idx", SkelLayout.PoseIdx);
+				BSON_APPEND_ARRAY_BEGIN(&arr_elem, "bones", &bones_arr);
+				for (int32 BoneEntryIdx = 0; BoneEntryIdx < SkelLayout.BonePoseIdxs.Num(); ++BoneEntryIdx)
+				{
+					bson_uint32_to_string(BoneEntryIdx, &bone_idx_key, bone_idx_str, sizeof bone_idx_str);
+					BSON_APPEND_DOCUMENT_BEGIN(&bones_arr, bone_idx_key, &bone_obj);
+						BSON_APPEND_INT32(&bone_obj, "idx", SkelLayout.BoneIndexes[BoneEntryIdx]);
+						BSON_APPEND_INT32(&bone_obj, "pose_idx", SkelLayout.BonePoseIdxs[BoneEntryIdx]);
+					bson_append_document_end(&bones_arr, &bone_obj);
+				}
+				bson_append_array_end(&arr_elem, &bones_arr);
+			bson_append_document_end(&arr_obj, &arr_elem);
+		}
+		bson_append_array_end(&table_obj, &arr_obj);
+	bson_append_document_end(table_doc, &table_obj);
+
+	bson_error_t error;
+	const bool bSuccess = mongoc_collection_insert_one(collection, table_doc, NULL, NULL, &error);
+	if (!bSuccess)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	bson_destroy(table_doc);
+	return bSuccess;
+#else
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Connect to the db
+bool FSLWorldStateMongoSink::Connect(const FString& DBName, const FString& CollName, const FString& ServerIp,
+		uint16 ServerPort, bool bOverwrite)
+{
+#if SL_WITH_LIBMONGO_C
+	// Required to initialize libmongoc's internals	
+	mongoc_init();
+
+	// Stores any error that might appear during the connection
+	bson_error_t error;
+
+	// Safely create a MongoDB URI object from the given string
+	FString Uri = TEXT("mongodb://") + ServerIp + TEXT(":") + FString::FromInt(ServerPort);
+	uri = mongoc_uri_new_with_error(TCHAR_TO_UTF8(*Uri), &error);
+	if (!uri)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.:%s; [Uri=%s]"),
+			*FString(__func__), __LINE__, *FString(error.message), *Uri);
+		return false;
+	}
+
+	// Create a new client instance
+	client = mongoc_client_new_from_uri(uri);
+	if (!client)
+	{
+		return false;
+	}
+
+	// Register the application name so we can track it in the profile logs on the server
+	mongoc_client_set_appname(client, TCHAR_TO_UTF8(*("SL_WorldStateWriter_" + CollName)));
+
+	// Get a handle on the database "db_name" and meta_coll "coll_name"
+	database = mongoc_client_get_database(client, TCHAR_TO_UTF8(*DBName));
+
+	// Check if the meta_coll already exists
+	if (mongoc_database_has_collection(database, TCHAR_TO_UTF8(*CollName), &error))
+	{
+		if (bOverwrite)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d World state collection %s already exists, will be removed and overwritten.."),
+				*FString(__func__), __LINE__, *CollName);
+			if (!mongoc_collection_drop(mongoc_database_get_collection(database, TCHAR_TO_UTF8(*CollName)), &error))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not drop collection, err.:%s;"),
+					*FString(__func__), __LINE__, *FString(error.message));
+				return false;
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d World state collection %s already exists and should not be overwritten, skipping metadata logging.."),
+				*FString(__func__), __LINE__, *CollName);
+			return false;
+		}
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Creating collection %s.%s .."),
+			*FString(__func__), __LINE__, *DBName, *CollName);
+	}
+
+	collection = mongoc_client_get_collection(client, TCHAR_TO_UTF8(*DBName), TCHAR_TO_UTF8(*CollName));
+
+	// Check server. Ping the "admin" database
+	bson_t* server_ping_cmd;
+	server_ping_cmd = BCON_NEW("ping", BCON_INT32(1));
+	if (!mongoc_client_command_simple(client, "admin", server_ping_cmd, NULL, NULL, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Check server err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bson_destroy(server_ping_cmd);
+		return false;
+	}
+
+	bson_destroy(server_ping_cmd);
+	return true;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d SL_WITH_LIBMONGO_C flag is 0, aborting.."),
+		*FString(__func__), __LINE__);
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Write metadata (collname + .meta)
+bool FSLWorldStateMongoSink::WriteMetadata(ASLIndividualManager* IndividualManager, const FString& MetaCollName, bool bOverwrite)
+{
+#if SL_WITH_LIBMONGO_C
+	bson_error_t error;
+	mongoc_collection_t* meta_coll;
+	meta_coll = mongoc_database_get_collection(database, TCHAR_TO_UTF8(*MetaCollName));
+	bson_t* query;
+
+	// Query for any previous individuals metadata
+	query = bson_new();
+	BSON_APPEND_UTF8(query, "type_id", "individuals");
+
+	// Check if there is any previous metadata logged
+	int64_t count = mongoc_collection_count_documents(meta_coll, query, NULL, NULL, NULL, &error);
+	if (count < 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+	}
+	else if (count > 0)
+	{
+		// Remove any previously written document with the type_id:individuals
+		if (bOverwrite)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Individuals metadata is already logged, removing previous data.."),
+				*FString(__FUNCTION__), __LINE__);
+			if (!mongoc_collection_delete_many(meta_coll, query, NULL, NULL, &error))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+					*FString(__func__), __LINE__, *FString(error.message));
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Individuals metadata is already logged, skipping.."),
+				*FString(__FUNCTION__), __LINE__);
+			return true;
+		}
+	}
+
+
+	// No previous metadata found, writing new one
+	bson_t* meta_doc;
+	meta_doc = bson_new();
+
+	// Add type
+	BSON_APPEND_UTF8(meta_doc, "type_id", "individuals");
+
+	// Add individuals data
+	int32 Num = AddIndividualsMetadata(IndividualManager, meta_doc);
+
+	bool RetVal = true;
+	if(Num > 0)
+	{
+		
+		if (!mongoc_collection_insert_one(meta_coll, meta_doc, NULL, NULL, &error))
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s::%d Err.: %s"),
+				*FString(__func__), __LINE__, *FString(error.message));
+			RetVal = false;
+		}
+	}
+	else
+	{
+		RetVal = false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Wrote %d number of individuals to the meta collection %s.."),
+		*FString(__FUNCTION__), __LINE__, Num, *MetaCollName);
+
+	// Clean up
+	bson_destroy(meta_doc);
+	mongoc_collection_destroy(meta_coll);
+	return RetVal;
+#else
+	UE_LOG(LogTemp, Error, TEXT("%s::%d SL_WITH_LIBMONGO_C flag is 0, aborting.."),
+		*FString(__func__), __LINE__);
+	return false;
+#endif //SL_WITH_LIBMONGO_C
+}
+
+#if SL_WITH_LIBMONGO_C
+int32 FSLWorldStateMongoSink::AddIndividualsMetadata(ASLIndividualManager* IndividualManager, bson_t* doc)
+{
+	int32 Num = 0;
+	bson_t arr_obj;
+	uint32_t arr_idx = 0;
+
+	BSON_APPEND_ARRAY_BEGIN(doc, "individuals", &arr_obj);
+	for (const auto& Individual : IndividualManager->GetIndividuals())
+	{
+		bson_t individual_obj;
+		char idx_str[16];
+		const char* idx_key;
+
+		bson_uint32_to_string(arr_idx, &idx_key, idx_str, sizeof idx_str);
+		BSON_APPEND_DOCUMENT_BEGIN(&arr_obj, idx_key, &individual_obj);
+
+			// Id
+			BSON_APPEND_UTF8(&individual_obj, "id", TCHAR_TO_UTF8(*Individual->GetIdValue()));
+			// Class
+			BSON_APPEND_UTF8(&individual_obj, "class", TCHAR_TO_UTF8(*Individual->GetClassValue()));
+		
+		bson_append_document_end(&arr_obj, &individual_obj);
+
+		arr_idx++;
+		Num++;
+	}
+	bson_append_array_end(doc, &arr_obj);
+	return Num;
+}
+#endif //SL_WITH_LIBMONGO_C	
+	
+void FSLWorldStateMongoSink::Disconnect()
+{
+#if SL_WITH_LIBMONGO_C
+	// Release handles and clean up mongoc
+	if (mongo_bulk)
+	{
+		mongoc_bulk_operation_destroy(mongo_bulk);
+		mongo_bulk = nullptr;
+	}
+	if (collection)
+	{
+		mongoc_collection_destroy(collection);
+		collection = nullptr;
+	}
+	if (database)
+	{
+		mongoc_database_destroy(database);
+		database = nullptr;
+	}
+	if (client)
+	{
+		mongoc_client_destroy(client);
+		client = nullptr;
+	}
+	if (uri)
+	{
+		mongoc_uri_destroy(uri);
+		uri = nullptr;
+	}
+	mongoc_cleanup();
+#endif //SL_WITH_LIBMONGO_C
+}
+
+// Create indexes on the inserted data
+bool FSLWorldStateMongoSink::CreateIndexes() const
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d Not connected to the db, could not create indexes.."), *FString(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+#if SL_WITH_LIBMONGO_C
+	bson_t* index_command;
+	bson_error_t error;
+	
+	bson_t idx_ts;
+	bson_init(&idx_ts);
+	BSON_APPEND_INT32(&idx_ts, "timestamp", 1);
+	char* idx_ts_chr = mongoc_collection_keys_to_index_string(&idx_ts);
+
+	bson_t idx_individuals_id;
+	bson_init(&idx_individuals_id);
+	BSON_APPEND_INT32(&idx_individuals_id, "individuals.id", 1);
+	char* idx_individuals_id_chr = mongoc_collection_keys_to_index_string(&idx_individuals_id);
+
+	bson_t idx_keyframe;
+	bson_init(&idx_keyframe);
+	BSON_APPEND_INT32(&idx_keyframe, "keyframe", 1);
+	BSON_APPEND_INT32(&idx_keyframe, "timestamp", 1);
+	char* idx_keyframe_chr = mongoc_collection_keys_to_index_string(&idx_keyframe);
+
+	bson_t idx_skel_individuals_id;
+	bson_init(&idx_skel_individuals_id);
+	BSON_APPEND_INT32(&idx_skel_individuals_id, "skel_individuals.id", 1);
+	char* idx_skel_individuals_id_chr = mongoc_collection_keys_to_index_string(&idx_skel_individuals_id);
+
+	index_command = BCON_NEW("createIndexes",
+			BCON_UTF8(mongoc_collection_get_name(collection)),
+			"indexes",
+			"[",
+				"{",
+					"key", BCON_DOCUMENT(&idx_ts),
+					"name", BCON_UTF8(idx_ts_chr),
+					"unique", BCON_BOOL(true),
+				"}",
+				"{",
+					"key", BCON_DOCUMENT(&idx_individuals_id),
+					"name",	BCON_UTF8(idx_individuals_id_chr),
+					//"unique", //BCON_BOOL(false),
+				"}",
+				"{",
+					"key", BCON_DOCUMENT(&idx_keyframe),
+					"name", BCON_UTF8(idx_keyframe_chr),
+					"partialFilterExpression", "{", "keyframe", BCON_BOOL(true), "}",	// only the keyframes are indexed
+				"}",
+				"{",
+					"key", BCON_DOCUMENT(&idx_skel_individuals_id),
+					"name", BCON_UTF8(idx_skel_individuals_id_chr),
+					//"unique", //BCON_BOOL(false),
+				"}",
+			"]");
+
+	bool bRetVal = true;
+	if (!mongoc_collection_write_command_with_opts(collection, index_command, NULL/*opts*/, NULL/*reply*/, &error))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Create indexes err.: %s"),
+			*FString(__func__), __LINE__, *FString(error.message));
+		bRetVal = false;
+	}
+
+	// Clean up
+	bson_destroy(index_command);
+	bson_free(idx_ts_chr);
+	bson_free(idx_individuals_id_chr);
+	bson_free(idx_keyframe_chr);
+	bson_free(idx_skel_individuals_id_chr);
+	bson_destroy(&idx_ts);
+	bson_destroy(&idx_individuals_id);
+	bson_destroy(&idx_keyframe);
+	bson_destroy(&idx_skel_individuals_id);
+	return bRetVal;
+#endif //SL_WITH_LIBMONGO_C
+
+	return false;
+}
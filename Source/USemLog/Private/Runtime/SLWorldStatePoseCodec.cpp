@@ -0,0 +1,202 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLWorldStatePoseCodec.h"
+#include "Runtime/SLWorldStateFrameBuffer.h"
+
+// Pack the (sorted) frame entries, returns the blob size in bytes
+int32 FSLWorldStatePoseCodec::Encode(const FSLWorldStateFrame& Frame, const TArray<int32>& SortedIdxs,
+	ESLWorldStatePoseEncoding Encoding, TArray<uint8>& OutData)
+{
+	const int32 Num = SortedIdxs.Num();
+	const int32 IdxSize = (Num == 0 || SortedIdxs.Last() <= MAX_uint16) ? sizeof(uint16) : sizeof(uint32);
+	const int32 PoseSize = GetPoseSize(Encoding);
+	OutData.SetNumUninitialized(HeaderSize + Num * (IdxSize + PoseSize), false);
+
+	// Header
+	uint8* Ptr = OutData.GetData();
+	const uint32 NumEntries = Num;
+	Ptr[0] = (uint8)Encoding;
+	Ptr[1] = (uint8)IdxSize;
+	Ptr[2] = 0;
+	Ptr[3] = 0;
+	FMemory::Memcpy(Ptr + 4, &NumEntries, sizeof(uint32));
+
+	uint8* IdxPtr = Ptr + HeaderSize;
+	uint8* PosePtr = IdxPtr + Num * IdxSize;
+	for (const int32 Idx : SortedIdxs)
+	{
+		// Index
+		if (IdxSize == sizeof(uint16))
+		{
+			const uint16 ShortIdx = (uint16)Idx;
+			FMemory::Memcpy(IdxPtr, &ShortIdx, sizeof(uint16));
+		}
+		else
+		{
+			const uint32 LongIdx = (uint32)Idx;
+			FMemory::Memcpy(IdxPtr, &LongIdx, sizeof(uint32));
+		}
+		IdxPtr += IdxSize;
+
+		// Pose
+		const float* Loc = Frame.Locations.GetData() + Idx * 3;
+		const float* Quat = Frame.Quats.GetData() + Idx * 4;
+		if (Encoding == ESLWorldStatePoseEncoding::PackedQuantized)
+		{
+			int32 QLoc[3];
+			int16 QQuat[4];
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				QLoc[Axis] = FMath::RoundToInt(Loc[Axis] * LocQuantization);
+			}
+			for (int32 Axis = 0; Axis < 4; ++Axis)
+			{
+				QQuat[Axis] = (int16)FMath::Clamp(FMath::RoundToInt(Quat[Axis] * QuatQuantization), -MAX_int16, (int32)MAX_int16);
+			}
+			FMemory::Memcpy(PosePtr, QLoc, sizeof(QLoc));
+			FMemory::Memcpy(PosePtr + sizeof(QLoc), QQuat, sizeof(QQuat));
+		}
+		else
+		{
+			FMemory::Memcpy(PosePtr, Loc, 3 * sizeof(float));
+			FMemory::Memcpy(PosePtr + 3 * sizeof(float), Quat, 4 * sizeof(float));
+		}
+		PosePtr += PoseSize;
+	}
+	return OutData.Num();
+}
+
+// Unpack all entries of the blob (false if the blob is invalid)
+bool FSLWorldStatePoseCodec::Decode(const uint8* Data, uint32 Len, TArray<int32>& OutIdxs, TArray<FTransform>& OutPoses)
+{
+	ESLWorldStatePoseEncoding Encoding;
+	int32 Num;
+	int32 IdxSize;
+	if (!ReadHeader(Data, Len, Encoding, Num, IdxSize))
+	{
+		return false;
+	}
+
+	const uint8* IdxData = Data + HeaderSize;
+	const uint8* PoseData = IdxData + Num * IdxSize;
+	OutIdxs.Reserve(OutIdxs.Num() + Num);
+	OutPoses.Reserve(OutPoses.Num() + Num);
+	for (int32 Slot = 0; Slot < Num; ++Slot)
+	{
+		OutIdxs.Add(ReadIdx(IdxData, IdxSize, Slot));
+		OutPoses.Add(ReadPose(PoseData, Encoding, Slot));
+	}
+	return true;
+}
+
+// Unpack the pose of the given entry (false if it is not in the blob)
+bool FSLWorldStatePoseCodec::FindPose(const uint8* Data, uint32 Len, int32 PoseIdx, FTransform& OutPose)
+{
+	ESLWorldStatePoseEncoding Encoding;
+	int32 Num;
+	int32 IdxSize;
+	if (!ReadHeader(Data, Len, Encoding, Num, IdxSize))
+	{
+		return false;
+	}
+
+	// The indexes are sorted, binary search the slot
+	const uint8* IdxData = Data + HeaderSize;
+	int32 Low = 0;
+	int32 High = Num - 1;
+	while (Low <= High)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		const int32 MidIdx = ReadIdx(IdxData, IdxSize, Mid);
+		if (MidIdx == PoseIdx)
+		{
+			OutPose = ReadPose(IdxData + Num * IdxSize, Encoding, Mid);
+			return true;
+		}
+		else if (MidIdx < PoseIdx)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid - 1;
+		}
+	}
+	return false;
+}
+
+// Size of a packed pose in bytes
+int32 FSLWorldStatePoseCodec::GetPoseSize(ESLWorldStatePoseEncoding Encoding)
+{
+	return Encoding == ESLWorldStatePoseEncoding::PackedQuantized
+		? 3 * sizeof(int32) + 4 * sizeof(int16)
+		: 7 * sizeof(float);
+}
+
+// Read and validate the blob header
+bool FSLWorldStatePoseCodec::ReadHeader(const uint8* Data, uint32 Len, ESLWorldStatePoseEncoding& OutEncoding, int32& OutNum, int32& OutIdxSize)
+{
+	if (Data == nullptr || Len < (uint32)HeaderSize)
+	{
+		return false;
+	}
+
+	OutEncoding = (ESLWorldStatePoseEncoding)Data[0];
+	OutIdxSize = Data[1];
+	if ((OutEncoding != ESLWorldStatePoseEncoding::PackedFloat && OutEncoding != ESLWorldStatePoseEncoding::PackedQuantized)
+		|| (OutIdxSize != sizeof(uint16) && OutIdxSize != sizeof(uint32)))
+	{
+		return false;
+	}
+
+	uint32 NumEntries;
+	FMemory::Memcpy(&NumEntries, Data + 4, sizeof(uint32));
+	const uint64 ExpectedLen = HeaderSize + (uint64)NumEntries * (OutIdxSize + GetPoseSize(OutEncoding));
+	if (ExpectedLen != Len)
+	{
+		return false;
+	}
+	OutNum = (int32)NumEntries;
+	return true;
+}
+
+// Read the pose index stored in the given slot
+int32 FSLWorldStatePoseCodec::ReadIdx(const uint8* IdxData, int32 IdxSize, int32 Slot)
+{
+	if (IdxSize == sizeof(uint16))
+	{
+		uint16 ShortIdx;
+		FMemory::Memcpy(&ShortIdx, IdxData + Slot * sizeof(uint16), sizeof(uint16));
+		return ShortIdx;
+	}
+	uint32 LongIdx;
+	FMemory::Memcpy(&LongIdx, IdxData + Slot * sizeof(uint32), sizeof(uint32));
+	return (int32)LongIdx;
+}
+
+// Read the pose stored in the given slot
+FTransform FSLWorldStatePoseCodec::ReadPose(const uint8* PoseData, ESLWorldStatePoseEncoding Encoding, int32 Slot)
+{
+	const uint8* Ptr = PoseData + Slot * GetPoseSize(Encoding);
+	FVector Loc;
+	FQuat Quat;
+	if (Encoding == ESLWorldStatePoseEncoding::PackedQuantized)
+	{
+		int32 QLoc[3];
+		int16 QQuat[4];
+		FMemory::Memcpy(QLoc, Ptr, sizeof(QLoc));
+		FMemory::Memcpy(QQuat, Ptr + sizeof(QLoc), sizeof(QQuat));
+		Loc = FVector(QLoc[0], QLoc[1], QLoc[2]) / LocQuantization;
+		Quat = FQuat(QQuat[0], QQuat[1], QQuat[2], QQuat[3]) * (1.f / QuatQuantization);
+	}
+	else
+	{
+		float Values[7];
+		FMemory::Memcpy(Values, Ptr, sizeof(Values));
+		Loc = FVector(Values[0], Values[1], Values[2]);
+		Quat = FQuat(Values[3], Values[4], Values[5], Values[6]);
+	}
+	Quat.Normalize();
+	return FTransform(Quat, Loc);
+}
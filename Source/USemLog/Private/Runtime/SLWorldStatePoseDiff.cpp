@@ -0,0 +1,128 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Runtime/SLWorldStatePoseDiff.h"
+#include "Math/VectorRegister.h"
+#include "Algo/BinarySearch.h"
+
+// Number of entries compared per iteration (one per vector lane)
+static const int32 SLPoseDiffBatchSize = 4;
+
+// Scalar movement check of a single entry (used for the tail of the batches), true if moved,
+// bOutChanged is set if the pose differs at all
+static FORCEINLINE bool SLIsEntryMoved(const float* RefLoc, const float* RefQuat, const float* CurrLoc, const float* CurrQuat,
+	float LinTolSq, float CosHalfAngTol, bool& bOutChanged)
+{
+	const float Dx = CurrLoc[0] - RefLoc[0];
+	const float Dy = CurrLoc[1] - RefLoc[1];
+	const float Dz = CurrLoc[2] - RefLoc[2];
+	const float QuatDot = FMath::Abs(CurrQuat[0] * RefQuat[0] + CurrQuat[1] * RefQuat[1] + CurrQuat[2] * RefQuat[2] + CurrQuat[3] * RefQuat[3]);
+	bOutChanged = Dx != 0.f || Dy != 0.f || Dz != 0.f || CurrQuat[0] != RefQuat[0] || CurrQuat[1] != RefQuat[1]
+		|| CurrQuat[2] != RefQuat[2] || CurrQuat[3] != RefQuat[3];
+	return (Dx * Dx + Dy * Dy + Dz * Dz) > LinTolSq || CosHalfAngTol > QuatDot;
+}
+
+// Transpose four consecutive [x y z w] quaternions into per component registers
+static FORCEINLINE void SLLoadQuatsSoA(const float* Quats, VectorRegister& OutX, VectorRegister& OutY, VectorRegister& OutZ, VectorRegister& OutW)
+{
+	const VectorRegister Q0 = VectorLoad(Quats);
+	const VectorRegister Q1 = VectorLoad(Quats + 4);
+	const VectorRegister Q2 = VectorLoad(Quats + 8);
+	const VectorRegister Q3 = VectorLoad(Quats + 12);
+	const VectorRegister XY01 = VectorShuffle(Q0, Q1, 0, 1, 0, 1);
+	const VectorRegister XY23 = VectorShuffle(Q2, Q3, 0, 1, 0, 1);
+	const VectorRegister ZW01 = VectorShuffle(Q0, Q1, 2, 3, 2, 3);
+	const VectorRegister ZW23 = VectorShuffle(Q2, Q3, 2, 3, 2, 3);
+	OutX = VectorShuffle(XY01, XY23, 0, 2, 0, 2);
+	OutY = VectorShuffle(XY01, XY23, 1, 3, 1, 3);
+	OutZ = VectorShuffle(ZW01, ZW23, 0, 2, 0, 2);
+	OutW = VectorShuffle(ZW01, ZW23, 1, 3, 1, 3);
+}
+
+// Gather the components of four consecutive [x y z] locations into per component registers
+static FORCEINLINE void SLLoadLocsSoA(const float* Locs, VectorRegister& OutX, VectorRegister& OutY, VectorRegister& OutZ)
+{
+	OutX = MakeVectorRegister(Locs[0], Locs[3], Locs[6], Locs[9]);
+	OutY = MakeVectorRegister(Locs[1], Locs[4], Locs[7], Locs[10]);
+	OutZ = MakeVectorRegister(Locs[2], Locs[5], Locs[8], Locs[11]);
+}
+
+// Append the indexes from [Begin, End) whose location or rotation difference is larger than their tolerance,
+// OutNumSuppressed counts the changed poses that stayed within the tolerance, returns the number of appended indexes
+int32 FSLWorldStatePoseDiff::FindMoved(const float* RefLocs, const float* RefQuats,
+	const float* CurrLocs, const float* CurrQuats,
+	const FSLWorldStatePoseTolerances& Tolerances, int32 Begin, int32 End,
+	TArray<int32>& OutMovedIdxs, int32& OutNumSuppressed)
+{
+	const int32 PrevNum = OutMovedIdxs.Num();
+	const float* LinTolSqs = Tolerances.LinearSq.GetData();
+	const float* CosHalfAngTols = Tolerances.CosHalfAngular.GetData();
+
+	// Batches of four entries, every lane holds the same component of a different entry
+	int32 Idx = Begin;
+	for (; Idx + SLPoseDiffBatchSize <= End; Idx += SLPoseDiffBatchSize)
+	{
+		VectorRegister CurrLx, CurrLy, CurrLz, RefLx, RefLy, RefLz;
+		SLLoadLocsSoA(CurrLocs + Idx * 3, CurrLx, CurrLy, CurrLz);
+		SLLoadLocsSoA(RefLocs + Idx * 3, RefLx, RefLy, RefLz);
+		VectorRegister CurrQx, CurrQy, CurrQz, CurrQw, RefQx, RefQy, RefQz, RefQw;
+		SLLoadQuatsSoA(CurrQuats + Idx * 4, CurrQx, CurrQy, CurrQz, CurrQw);
+		SLLoadQuatsSoA(RefQuats + Idx * 4, RefQx, RefQy, RefQz, RefQw);
+
+		// Moved if the squared distance is larger than the squared tolerance, or
+		// if |q1.q2| (cosine of the half angle between the rotations) is smaller than the half tolerance cosine
+		const VectorRegister Dx = VectorSubtract(CurrLx, RefLx);
+		const VectorRegister Dy = VectorSubtract(CurrLy, RefLy);
+		const VectorRegister Dz = VectorSubtract(CurrLz, RefLz);
+		const VectorRegister DistSq = VectorMultiplyAdd(Dz, Dz, VectorMultiplyAdd(Dy, Dy, VectorMultiply(Dx, Dx)));
+		const VectorRegister QuatDot = VectorAbs(VectorMultiplyAdd(CurrQw, RefQw, VectorMultiplyAdd(CurrQz, RefQz,
+			VectorMultiplyAdd(CurrQy, RefQy, VectorMultiply(CurrQx, RefQx)))));
+		const int32 MovedBits = VectorMaskBits(VectorBitwiseOr(
+			VectorCompareGT(DistSq, VectorLoad(LinTolSqs + Idx)),
+			VectorCompareGT(VectorLoad(CosHalfAngTols + Idx), QuatDot)));
+
+		// Any component differs
+		const VectorRegister LocChanged = VectorBitwiseOr(VectorCompareNE(CurrLx, RefLx),
+			VectorBitwiseOr(VectorCompareNE(CurrLy, RefLy), VectorCompareNE(CurrLz, RefLz)));
+		const VectorRegister QuatChanged = VectorBitwiseOr(
+			VectorBitwiseOr(VectorCompareNE(CurrQx, RefQx), VectorCompareNE(CurrQy, RefQy)),
+			VectorBitwiseOr(VectorCompareNE(CurrQz, RefQz), VectorCompareNE(CurrQw, RefQw)));
+		const int32 ChangedBits = VectorMaskBits(VectorBitwiseOr(LocChanged, QuatChanged));
+
+		// Lanes in entry order
+		for (int32 Lane = 0; Lane < SLPoseDiffBatchSize; ++Lane)
+		{
+			if (MovedBits & (1 << Lane))
+			{
+				OutMovedIdxs.Add(Idx + Lane);
+			}
+			else if (ChangedBits & (1 << Lane))
+			{
+				OutNumSuppressed++;
+			}
+		}
+	}
+
+	// Remaining entries
+	for (; Idx < End; ++Idx)
+	{
+		bool bChanged = false;
+		if (SLIsEntryMoved(RefLocs + Idx * 3, RefQuats + Idx * 4, CurrLocs + Idx * 3, CurrQuats + Idx * 4,
+			LinTolSqs[Idx], CosHalfAngTols[Idx], bChanged))
+		{
+			OutMovedIdxs.Add(Idx);
+		}
+		else if (bChanged)
+		{
+			OutNumSuppressed++;
+		}
+	}
+	return OutMovedIdxs.Num() - PrevNum;
+}
+
+// True if any (sorted) moved index is inside [Begin, End)
+bool FSLWorldStatePoseDiff::AnyMovedInRange(const TArray<int32>& SortedMovedIdxs, int32 Begin, int32 End)
+{
+	const int32 FirstIdx = Algo::LowerBound(SortedMovedIdxs, Begin);
+	return SortedMovedIdxs.IsValidIndex(FirstIdx) && SortedMovedIdxs[FirstIdx] < End;
+}
@@ -48,26 +48,10 @@ void USLVizPrimitiveMarker::UpdateSize(float Size)
 	}
 }
 
-// Virtual add instance function
-void USLVizPrimitiveMarker::AddInstanceChecked(const FTransform& Pose)
+// Virtual instance transform of the pose (with the marker scale)
+FTransform USLVizPrimitiveMarker::GetInstanceTransform(const FTransform& Pose) const
 {
-	ISMC->AddInstance(FTransform(Pose.GetRotation(), Pose.GetLocation(), MarkerScale));
-}
-
-// Virtual update instance transform
-bool USLVizPrimitiveMarker::UpdateInstanceTransform(int32 Index, const FTransform& Pose)
-{
-	return ISMC->UpdateInstanceTransform(Index, FTransform(Pose.GetRotation(), Pose.GetLocation(), MarkerScale), true, true, true);
-}
-
-// Virtual add instances function
-void USLVizPrimitiveMarker::AddInstancesChecked(const TArray<FTransform>& Poses)
-{
-	for (auto P : Poses)
-	{
-		P.SetScale3D(MarkerScale);
-		ISMC->AddInstance(P);
-	}
+	return FTransform(Pose.GetRotation(), Pose.GetLocation(), MarkerScale);
 }
 
 // Get the static mesh of the primitive type
@@ -3,6 +3,7 @@
 
 #include "Viz/Markers/SLVizSkeletalMeshMarker.h"
 #include "Viz/SLVizAssets.h"
+#include "Viz/SLVizEpisodeUtils.h"
 #include "Components/PoseableMeshComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
@@ -14,6 +15,9 @@ USLVizSkeletalMeshMarker::USLVizSkeletalMeshMarker()
 	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	PMCRef = nullptr;
+	TimelineFirstSlot = 0;
+	NextEvictSlot = 0;
+	MaxNumInstances = DefaultMaxNumInstances;
 }
 
 // Called every frame, used for timeline visualizations, activated and deactivated on request
@@ -33,15 +37,8 @@ void USLVizSkeletalMeshMarker::TickComponent(float DeltaTime, ELevelTick TickTyp
 		return;
 	}
 
-	// Draw all instances, or use a limit
-	if (TimelineMaxNumInstances <= 0)
-	{
-		UpdateTimeline(NumInstancesToDraw);
-	}
-	else
-	{
-		UpdateTimelineWithMaxNumInstances(NumInstancesToDraw);
-	}
+	// Draw the new instances (reuses the oldest ones if the number is limited)
+	UpdateTimeline(NumInstancesToDraw);
 
 	// Reset the elapsed time
 	TimelineDeltaTime = 0;
@@ -107,19 +104,21 @@ void USLVizSkeletalMeshMarker::AddInstance(const TPair<FTransform, TMap<int32, F
 		return;
 	}
 
-	UPoseableMeshComponent* PMC = CreateNewPoseableMeshInstance();
-	PMC->SetWorldTransform(SkeletalPose.Key);
-
-	for (int32 Idx = 0; Idx < 5; ++Idx)
+	// Overwrite the oldest instance slot if the cap is reached (the slots keep their indexes)
+	if (PMCInstances.Num() >= MaxNumInstances)
 	{
-		for (const auto& BonePosePair : SkeletalPose.Value)
-		{
-			const FName BoneName = PMC->GetBoneName(BonePosePair.Key);
-			PMC->SetBoneTransformByName(BoneName, BonePosePair.Value, EBoneSpaces::WorldSpace);
-		}
+		UPoseableMeshComponent* OldestPMC = PMCInstances[NextEvictSlot];
+		SetInstancePose(OldestPMC, SkeletalPose);
+		OldestPMC->SetVisibility(true);
+		InstancePoseIndexes[NextEvictSlot] = INDEX_NONE;
+		NextEvictSlot = (NextEvictSlot + 1) % MaxNumInstances;
+		return;
 	}
 
+	UPoseableMeshComponent* PMC = AcquirePoseableMeshInstance();
+	SetInstancePose(PMC, SkeletalPose);
 	PMCInstances.Add(PMC);
+	InstancePoseIndexes.Add(INDEX_NONE);
 }
 
 //// Add instances with the poses
@@ -163,21 +162,11 @@ void USLVizSkeletalMeshMarker::AddInstances(const TArray<TPair<FTransform, TMap<
 		return;
 	}
 
-	for (const auto& SkelPosePair : SkeletalPoses)
+	// Skip poses with a time stride if there are more poses than instances (the last pose is always shown)
+	const int32 Stride = FMath::Max(FMath::DivideAndRoundUp(SkeletalPoses.Num(), MaxNumInstances), 1);
+	for (int32 PoseIdx = 0; PoseIdx < SkeletalPoses.Num(); PoseIdx += Stride)
 	{
-		UPoseableMeshComponent* PMC = CreateNewPoseableMeshInstance();
-		PMC->SetWorldTransform(SkelPosePair.Key);
-
-		for (int32 Idx = 0; Idx < 5; ++Idx)
-		{
-			for (const auto& BonePosePair : SkelPosePair.Value)
-			{
-				const FName BoneName = PMC->GetBoneName(BonePosePair.Key);
-				PMC->SetBoneTransformByName(BoneName, BonePosePair.Value, EBoneSpaces::WorldSpace);
-			}
-		}
-
-		PMCInstances.Add(PMC);
+		AddInstance(PoseIdx + Stride >= SkeletalPoses.Num() ? SkeletalPoses.Last() : SkeletalPoses[PoseIdx]);
 	}
 }
 
@@ -203,12 +192,28 @@ void USLVizSkeletalMeshMarker::AddInstances(const TArray<TPair<FTransform, TMap<
 		return;
 	}
 
-	// Set the timeline data
-	TimelinePoses = SkeletalPoses;
+	// The existing instances count toward the max number of instances, the timeline only uses the free slots
+	const int32 NumFreeSlots = MaxNumInstances - PMCInstances.Num();
+	if (NumFreeSlots <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d The max number of instances (%d) is reached, reset first.."),
+			*FString(__FUNCTION__), __LINE__, MaxNumInstances);
+		return;
+	}
+
+	// Set the timeline data, skip poses with a time stride if there are more poses than free slots
+	const int32 Stride = TimelineParams.MaxNumInstances > 0 ? 1
+		: FMath::Max(FMath::DivideAndRoundUp(SkeletalPoses.Num(), NumFreeSlots), 1);
+	TimelinePoses.Empty(SkeletalPoses.Num() / Stride + 1);
+	for (int32 PoseIdx = 0; PoseIdx < SkeletalPoses.Num(); PoseIdx += Stride)
+	{
+		TimelinePoses.Add(PoseIdx + Stride >= SkeletalPoses.Num() ? SkeletalPoses.Last() : SkeletalPoses[PoseIdx]);
+	}
 	TimelineDuration = TimelineParams.Duration;
-	TimelineMaxNumInstances = TimelineParams.MaxNumInstances;
+	TimelineMaxNumInstances = TimelineParams.MaxNumInstances > 0 ? FMath::Min(TimelineParams.MaxNumInstances, NumFreeSlots) : INDEX_NONE;
 	bLoopTimeline = TimelineParams.bLoop;
 	TimelineIndex = 0;
+	TimelineFirstSlot = PMCInstances.Num();
 
 	// Start timeline
 	if (TimelineParams.UpdateRate > 0.f)
@@ -228,6 +233,7 @@ void USLVizSkeletalMeshMarker::DestroyComponent(bool bPromoteChildren)
 			PMCInst->DestroyComponent();
 		}
 	}
+	DestroyPooledInstances();
 
 	if (PMCRef && PMCRef->IsValidLowLevel() && !PMCRef->IsPendingKillOrUnreachable())
 	{
@@ -257,17 +263,21 @@ void USLVizSkeletalMeshMarker::ResetVisuals()
 	PMCRef->EmptyOverrideMaterials();
 }
 
-// Reset instances (poses of the visuals)
+// Reset instances (poses of the visuals), the instances are hidden and kept for reuse
 void USLVizSkeletalMeshMarker::ResetPoses()
 {
 	for (const auto& PMC : PMCInstances)
 	{
 		if (!PMC->IsPendingKillOrUnreachable())
 		{
-			PMC->DestroyComponent();
+			PMC->SetVisibility(false);
+			PMCPool.Add(PMC);
 		}
 	}
 	PMCInstances.Empty();
+	InstancePoseIndexes.Empty();
+	TimelineFirstSlot = 0;
+	NextEvictSlot = 0;
 }
 
 //// Update intial timeline iteration (create the instances)
@@ -382,38 +392,24 @@ void USLVizSkeletalMeshMarker::ClearAndStopTimeline()
 	TimelinePoses.Empty();
 }
 
-// Update timeline with the given number of new instances
+// Update timeline with the given number of new instances (with a max number of instances the slots are reused as a ring)
 void USLVizSkeletalMeshMarker::UpdateTimeline(int32 NumNewInstances)
 {
-	// Check if the instances have already been created (number of timeline poses equals the number of intances)
-	bool bInstancesAlreadyCreated = TimelinePoses.Num() == PMCInstances.Num();
-
-	// Check if it is safe to draw all new instances
-	if (TimelineIndex + NumNewInstances < TimelinePoses.Num())
+	// Draw the new instances, up to the end of the poses array
+	const int32 EndIndex = FMath::Min(TimelineIndex + NumNewInstances, TimelinePoses.Num());
+	for (; TimelineIndex < EndIndex; ++TimelineIndex)
 	{
-		// Safe to draw all instances
-		while (NumNewInstances > 0)
-		{
-			bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
-			TimelineIndex++;
-			NumNewInstances--;
-		}
+		ShowTimelineInstance(TimelineIndex);
 	}
-	else
-	{
-		// Reached end of the poses array, add only remaining values
-		while (TimelinePoses.IsValidIndex(TimelineIndex))
-		{
-			bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
-			TimelineIndex++;
-		}
 
+	// Check if the end of the poses array was reached
+	if (TimelineIndex >= TimelinePoses.Num())
+	{
 		// Hide existing instances if timeline should be looped
 		if (bLoopTimeline)
 		{
-			// Avoid destroying the instances
+			// Avoid destroying the instances, they are re-shown in the next iteration
 			HideInstances();
-			// TimelinePoses.Empty(); commented out since it is used to detect if the instances were created, or create explicit flag
 			TimelineIndex = 0;
 		}
 		else
@@ -423,68 +419,32 @@ void USLVizSkeletalMeshMarker::UpdateTimeline(int32 NumNewInstances)
 	}
 }
 
-// Update timeline with max number of instances
-void USLVizSkeletalMeshMarker::UpdateTimelineWithMaxNumInstances(int32 NumNewInstances)
+// Show the timeline pose in its instance slot
+void USLVizSkeletalMeshMarker::ShowTimelineInstance(int32 PoseIndex)
 {
-	// Check if the instances have already been created (number of timeline poses equals the number of intances)
-	bool bInstancesAlreadyCreated = TimelinePoses.Num() == PMCInstances.Num();
-
-	// Check if it is safe to draw all new instances
-	if (TimelineIndex + NumNewInstances < TimelinePoses.Num())
+	const int32 Slot = TimelineFirstSlot + (TimelineMaxNumInstances > 0 ? PoseIndex % TimelineMaxNumInstances : PoseIndex);
+	if (!PMCInstances.IsValidIndex(Slot))
 	{
-		// Safe to draw all instances
-		while (NumNewInstances > 0)
-		{
-			if (TimelineIndex < TimelineMaxNumInstances)
-			{
-				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
-			}
-			else
-			{
-				PMCInstances[TimelineIndex-TimelineMaxNumInstances]->SetVisibility(false);
-				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
-			}
-			TimelineIndex++;
-			NumNewInstances--;
-		}
+		PMCInstances.Add(AcquirePoseableMeshInstance());
+		InstancePoseIndexes.Add(INDEX_NONE);
 	}
-	else
-	{
-		// Reached end of the poses array, add only remaining values
-		while (TimelinePoses.IsValidIndex(TimelineIndex))
-		{
-			if (TimelineIndex < TimelineMaxNumInstances)
-			{
-				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
-			}
-			else
-			{
-				PMCInstances[TimelineIndex - TimelineMaxNumInstances]->SetVisibility(false);
-				bInstancesAlreadyCreated ? PMCInstances[TimelineIndex]->SetVisibility(true) : AddInstance(TimelinePoses[TimelineIndex]);
-			}
-			TimelineIndex++;
-		}
 
-		// Hide existing instances if timeline should be looped
-		if (bLoopTimeline)
-		{
-			// Avoid destroying the instances
-			HideInstances();
-			// TimelinePoses.Empty(); commented out since it is used to detect if the instances were created, or create explicit flag
-			TimelineIndex = 0;
-		}
-		else
-		{
-			ClearAndStopTimeline();
-		}
+	// Only repose the instance if it shows a different pose (instances are reused in the loops and as a ring)
+	UPoseableMeshComponent* PMC = PMCInstances[Slot];
+	if (InstancePoseIndexes[Slot] != PoseIndex)
+	{
+		SetInstancePose(PMC, TimelinePoses[PoseIndex]);
+		InstancePoseIndexes[Slot] = PoseIndex;
 	}
+	PMC->SetVisibility(true);
 }
 
 //   Set visual without the materials (avoid boilerplate code)
 void USLVizSkeletalMeshMarker::SetPoseableMeshComponentVisual(USkeletalMesh* SkelMesh)
 {
-	// Clear any previous data
+	// Clear any previous data, the pooled instances are clones of the previous visual
 	Reset();
+	DestroyPooledInstances();
 	
 	if (!PMCRef || !PMCRef->IsValidLowLevel() || PMCRef->IsPendingKillOrUnreachable())
 	{
@@ -511,4 +471,49 @@ UPoseableMeshComponent* USLVizSkeletalMeshMarker::CreateNewPoseableMeshInstance(
 	NewPMC->RegisterComponent();
 	return NewPMC;
 }
+
+// Get a visible poseable mesh instance from the pool, or create a new one
+UPoseableMeshComponent* USLVizSkeletalMeshMarker::AcquirePoseableMeshInstance()
+{
+	while (PMCPool.Num() > 0)
+	{
+		UPoseableMeshComponent* PMC = PMCPool.Pop(false);
+		if (PMC && PMC->IsValidLowLevel() && !PMC->IsPendingKillOrUnreachable())
+		{
+			PMC->SetVisibility(true);
+			return PMC;
+		}
+	}
+	return CreateNewPoseableMeshInstance();
+}
+
+// Set the world pose and bone poses of the instance
+void USLVizSkeletalMeshMarker::SetInstancePose(UPoseableMeshComponent* PMC, const TPair<FTransform, TMap<int32, FTransform>>& SkeletalPose)
+{
+	PMC->SetWorldTransform(SkeletalPose.Key);
+
+	// Sorted bone indexes for the single pass update
+	SkeletalPose.Value.GenerateKeyArray(BoneIndexesBuffer);
+	BoneIndexesBuffer.Sort();
+	BonePosesBuffer.Reset(BoneIndexesBuffer.Num());
+	for (const int32 BoneIndex : BoneIndexesBuffer)
+	{
+		BonePosesBuffer.Add(SkeletalPose.Value[BoneIndex]);
+	}
+	FSLVizEpisodeUtils::SetBoneWorldPoses(PMC, BoneIndexesBuffer.GetData(), BonePosesBuffer.GetData(), BoneIndexesBuffer.Num(),
+		ComponentSpaceBuffer);
+}
+
+// Destroy the pooled instances
+void USLVizSkeletalMeshMarker::DestroyPooledInstances()
+{
+	for (const auto& PMC : PMCPool)
+	{
+		if (PMC && PMC->IsValidLowLevel() && !PMC->IsPendingKillOrUnreachable())
+		{
+			PMC->DestroyComponent();
+		}
+	}
+	PMCPool.Empty();
+}
 /* End VizMarker interface */
@@ -34,15 +34,8 @@ void USLVizStaticMeshMarker::TickComponent(float DeltaTime, ELevelTick TickType,
 		return;
 	}	
 
-	// Draw all instances, or use a limit
-	if (TimelineMaxNumInstances <= 0)
-	{
-		UpdateTimeline(NumInstancesToDraw);
-	}
-	else
-	{
-		UpdateTimelineWithMaxNumInstances(NumInstancesToDraw);
-	}
+	// Draw the new instances, the render state is updated once per tick
+	UpdateTimeline(NumInstancesToDraw);
 
 	// Reset the elapsed time
 	TimelineDeltaTime = 0;
@@ -168,7 +161,12 @@ void USLVizStaticMeshMarker::AddInstances(const TArray<FTransform>& Poses,
 	bLoopTimeline = TimelineParams.bLoop;
 
 	TimelineIndex = 0;
-	
+
+	// Reserve the instance buffers for the whole timeline (or the max number of instances)
+	const int32 NumReserved = TimelineMaxNumInstances > 0 ? FMath::Min(TimelineMaxNumInstances, Poses.Num()) : Poses.Num();
+	ISMC->PreAllocateInstancesMemory(NumReserved);
+	InstanceTransformsBuffer.Reserve(NumReserved);
+
 	// Start timeline
 	if (TimelineParams.UpdateRate > 0.f)
 	{
@@ -224,21 +222,56 @@ void USLVizStaticMeshMarker::ResetPoses()
 // Virtual add instance function
 void USLVizStaticMeshMarker::AddInstanceChecked(const FTransform& Pose)
 {
-	ISMC->AddInstance(Pose);
+	ISMC->AddInstance(GetInstanceTransform(Pose));
 }
 
-// Virtual update instance transform
-bool USLVizStaticMeshMarker::UpdateInstanceTransform(int32 Index, const FTransform& Pose)
+// Virtual add instances function
+void USLVizStaticMeshMarker::AddInstancesChecked(const TArray<FTransform>& Poses)
 {
-	return ISMC->UpdateInstanceTransform(Index, Pose, true, true, true);
+	AddInstancesChecked(Poses, 0, Poses.Num());
 }
 
-// Virtual add instances function
-void USLVizStaticMeshMarker::AddInstancesChecked(const TArray<FTransform>& Poses)
+// Virtual instance transform of the pose
+FTransform USLVizStaticMeshMarker::GetInstanceTransform(const FTransform& Pose) const
 {
-	for (const auto& P : Poses)
+	return Pose;
+}
+
+// Add the poses from the [First, First + Num) range as new instances with a single render state update
+void USLVizStaticMeshMarker::AddInstancesChecked(const TArray<FTransform>& Poses, int32 First, int32 Num)
+{
+	if (Num <= 0)
+	{
+		return;
+	}
+
+	InstanceTransformsBuffer.Reset(Num);
+	for (int32 PoseIdx = First; PoseIdx < First + Num; ++PoseIdx)
 	{
-		ISMC->AddInstance(P);
+		InstanceTransformsBuffer.Add(GetInstanceTransform(Poses[PoseIdx]));
+	}
+	ISMC->AddInstances(InstanceTransformsBuffer, false);
+}
+
+// Overwrite the timeline ring slots with the poses from the [First, First + Num) range (does not dirty the render state)
+void USLVizStaticMeshMarker::UpdateInstancesChecked(const TArray<FTransform>& Poses, int32 First, int32 Num)
+{
+	// Only the last poses that fit in the ring are visible
+	const int32 End = First + Num;
+	int32 PoseIdx = FMath::Max(First, End - TimelineMaxNumInstances);
+
+	// Every contiguous slot run is updated as one batch (at most two runs if the ring wraps around)
+	while (PoseIdx < End)
+	{
+		const int32 Slot = PoseIdx % TimelineMaxNumInstances;
+		const int32 RunNum = FMath::Min(End - PoseIdx, TimelineMaxNumInstances - Slot);
+		InstanceTransformsBuffer.Reset(RunNum);
+		for (int32 RunIdx = 0; RunIdx < RunNum; ++RunIdx)
+		{
+			InstanceTransformsBuffer.Add(GetInstanceTransform(Poses[PoseIdx + RunIdx]));
+		}
+		ISMC->BatchUpdateInstancesTransforms(Slot, InstanceTransformsBuffer, true, false, true);
+		PoseIdx += RunNum;
 	}
 }
 
@@ -255,82 +288,32 @@ void USLVizStaticMeshMarker::ClearAndStopTimeline()
 	TimelinePoses.Empty();
 }
 
-// Update timeline with the given number of new instances
+// Update timeline with the given number of new instances (with a max number of instances the oldest ones are overwritten)
 void USLVizStaticMeshMarker::UpdateTimeline(int32 NumNewInstances)
 {
-	// Check if it is safe to draw all new instances
-	if (TimelineIndex + NumNewInstances < TimelinePoses.Num())
+	const int32 End = FMath::Min(TimelineIndex + NumNewInstances, TimelinePoses.Num());
+	if (TimelineMaxNumInstances <= 0)
 	{
-		// Safe to draw all new instances
-		while (NumNewInstances > 0)
-		{
-			AddInstanceChecked(TimelinePoses[TimelineIndex]);
-			TimelineIndex++;
-			NumNewInstances--;
-		}
+		AddInstancesChecked(TimelinePoses, TimelineIndex, End - TimelineIndex);
 	}
 	else
 	{
-		// Reached end of the poses array, add only remaining values
-		while (TimelinePoses.IsValidIndex(TimelineIndex))
-		{
-			AddInstanceChecked(TimelinePoses[TimelineIndex]);
-			TimelineIndex++;
-		}
+		// Fill the free slots first, then overwrite the oldest ones
+		const int32 AddEnd = FMath::Min(End, TimelineMaxNumInstances);
+		AddInstancesChecked(TimelinePoses, TimelineIndex, AddEnd - TimelineIndex);
 
-		// Check if the timeline should be repeated or stopped
-		if (bLoopTimeline)
-		{
-			ISMC->ClearInstances();
-			TimelineIndex = 0;
-		}
-		else
+		const int32 UpdateFirst = FMath::Max(TimelineIndex, AddEnd);
+		if (UpdateFirst < End)
 		{
-			ClearAndStopTimeline();
+			UpdateInstancesChecked(TimelinePoses, UpdateFirst, End - UpdateFirst);
+			ISMC->MarkRenderStateDirty();
 		}
 	}
-}
+	TimelineIndex = End;
 
-// Update timeline with max number of instances
-void USLVizStaticMeshMarker::UpdateTimelineWithMaxNumInstances(int32 NumNewInstances)
-{
-	// Check if it is safe to draw all new instances
-	if (TimelineIndex + NumNewInstances < TimelinePoses.Num())
-	{
-		// Safe to draw all new instances
-		while (NumNewInstances > 0)
-		{
-			if (TimelineIndex < TimelineMaxNumInstances)
-			{
-				AddInstanceChecked(TimelinePoses[TimelineIndex]);
-			}
-			else
-			{
-				int32 UpdateIndex = TimelineIndex % TimelineMaxNumInstances;
-				UpdateInstanceTransform(UpdateIndex, TimelinePoses[TimelineIndex]);
-			}
-			TimelineIndex++;
-			NumNewInstances--;
-		}
-	}
-	else
+	// Check if the timeline reached its end and should be repeated or stopped
+	if (TimelineIndex >= TimelinePoses.Num())
 	{
-		// Reached end of the poses array, add only remaining values
-		while (TimelinePoses.IsValidIndex(TimelineIndex))
-		{
-			if (TimelineIndex < TimelineMaxNumInstances)
-			{
-				AddInstanceChecked(TimelinePoses[TimelineIndex]);
-			}
-			else
-			{
-				int32 UpdateIndex = TimelineIndex % TimelineMaxNumInstances;
-				UpdateInstanceTransform(UpdateIndex, TimelinePoses[TimelineIndex]);
-			}
-			TimelineIndex++;
-		}
-
-		// Check if the timeline should be repeated or stopped
 		if (bLoopTimeline)
 		{
 			ISMC->ClearInstances();
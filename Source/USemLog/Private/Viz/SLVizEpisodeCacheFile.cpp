@@ -0,0 +1,388 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Viz/SLVizEpisodeCacheFile.h"
+#include "Viz/SLVizEpisodeManager.h"
+#include "Viz/SLVizEpisodeUtils.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+#include "Async/MappedFileHandle.h"
+
+// Cache file constants
+static const uint32 SLVizCacheFileMagic = 0x43564C53;		// "SLVC"
+static const uint32 SLVizCacheFileVersion = 2;
+static const int64 SLVizCacheArrayAlignment = 16;
+
+/**
+ * Fixed size header of the cache file
+ */
+struct FSLVizEpisodeCacheHeader
+{
+	uint32 Magic = SLVizCacheFileMagic;
+	uint32 Version = SLVizCacheFileVersion;
+	uint32 ContentHash = 0;
+	uint32 TransformSize = sizeof(FTransform);
+	int32 KeyframeInterval = 0;
+	int32 NumFrames = 0;
+	int32 NumActors = 0;
+	int32 NumStaticActors = 0;
+	int32 NumComponents = 0;
+	int32 NumBones = 0;
+	int32 NumKeyframes = 0;
+	int32 NumDeltaActors = 0;
+	int32 NumDeltaBones = 0;
+};
+
+// Append the raw bytes of the value to the buffer
+template<typename T>
+static void SLAppendCacheValue(TArray<uint8>& Buffer, const T& Value)
+{
+	Buffer.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+}
+
+// Append the raw bytes of the array to the buffer, aligned to the array alignment of the file
+template<typename T>
+static void SLAppendCacheArray(TArray<uint8>& Buffer, const TArray<T>& Array)
+{
+	Buffer.AddZeroed(Align(Buffer.Num(), SLVizCacheArrayAlignment) - Buffer.Num());
+	Buffer.Append(reinterpret_cast<const uint8*>(Array.GetData()), Array.Num() * sizeof(T));
+}
+
+// Append the string as utf8 with its length
+static void SLAppendCacheString(TArray<uint8>& Buffer, const FString& Str)
+{
+	FTCHARToUTF8 Utf8Str(*Str);
+	SLAppendCacheValue(Buffer, (uint32)Utf8Str.Length());
+	Buffer.Append(reinterpret_cast<const uint8*>(Utf8Str.Get()), Utf8Str.Length());
+}
+
+// Read the raw bytes of the value from the data (false if out of bounds)
+template<typename T>
+static bool SLReadCacheValue(const uint8* Data, int64 Size, int64& InOutOffset, T& OutValue)
+{
+	if (InOutOffset < 0 || InOutOffset + (int64)sizeof(T) > Size)
+	{
+		return false;
+	}
+	FMemory::Memcpy(&OutValue, Data + InOutOffset, sizeof(T));
+	InOutOffset += sizeof(T);
+	return true;
+}
+
+// Copy the aligned raw array out of the data (false if the count is invalid or out of bounds)
+template<typename T>
+static bool SLReadCacheArray(const uint8* Data, int64 Size, int64& InOutOffset, int64 Num, TArray<T>& OutArray)
+{
+	InOutOffset = Align(InOutOffset, SLVizCacheArrayAlignment);
+	if (Num < 0 || Num > MAX_int32 || InOutOffset > Size || Num > (Size - InOutOffset) / (int64)sizeof(T))
+	{
+		return false;
+	}
+	const int64 NumBytes = Num * sizeof(T);
+	OutArray.SetNumUninitialized(Num);
+	FMemory::Memcpy(OutArray.GetData(), Data + InOutOffset, NumBytes);
+	InOutOffset += NumBytes;
+	return true;
+}
+
+// Read the utf8 string with its length (false if out of bounds)
+static bool SLReadCacheString(const uint8* Data, int64 Size, int64& InOutOffset, FString& OutStr)
+{
+	uint32 Len;
+	if (!SLReadCacheValue(Data, Size, InOutOffset, Len) || InOutOffset + Len > Size)
+	{
+		return false;
+	}
+	FUTF8ToTCHAR TCHARStr(reinterpret_cast<const ANSICHAR*>(Data + InOutOffset), Len);
+	OutStr = FString(TCHARStr.Length(), TCHARStr.Get());
+	InOutOffset += Len;
+	return true;
+}
+
+
+// Cache file path of the task and episode
+FString FSLVizEpisodeCacheFile::GetFilePath(const FString& TaskId, const FString& EpisodeId)
+{
+	return FPaths::ProjectDir() + TEXT("/SL/VizCache/") + TaskId + TEXT("/") + EpisodeId + TEXT(".slvc");
+}
+
+// Write the compiled episode to its cache file
+bool FSLVizEpisodeCacheFile::Save(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature,
+	const FSLVizEpisodeData& InEpisodeData)
+{
+	if (ContentSignature.IsEmpty() || !InEpisodeData.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s::%s has no content signature or is not valid, it will not be written to the cache.."),
+			*FString(__FUNCTION__), __LINE__, *TaskId, *EpisodeId);
+		return false;
+	}
+	const double ExecBegin = FPlatformTime::Seconds();
+	const FSLVizEpisodeBindings& Bindings = InEpisodeData.Bindings;
+
+	FSLVizEpisodeCacheHeader Header;
+	Header.ContentHash = FCrc::StrCrc32(*ContentSignature);
+	Header.KeyframeInterval = InEpisodeData.KeyframeInterval;
+	Header.NumFrames = InEpisodeData.NumFrames();
+	Header.NumActors = Bindings.NumActors();
+	Header.NumStaticActors = Bindings.NumStaticActors();
+	Header.NumComponents = Bindings.SkeletalComponents.Num();
+	Header.NumBones = Bindings.NumBones();
+	Header.NumKeyframes = InEpisodeData.NumKeyframes();
+	Header.NumDeltaActors = InEpisodeData.DeltaActorSlots.Num();
+	Header.NumDeltaBones = InEpisodeData.DeltaBoneSlots.Num();
+
+	TArray<uint8> Buffer;
+	Buffer.Reserve(sizeof(FSLVizEpisodeCacheHeader) + InEpisodeData.GetAllocatedSize());
+	SLAppendCacheValue(Buffer, Header);
+	for (const FString& Id : Bindings.ActorIds)
+	{
+		SLAppendCacheString(Buffer, Id);
+	}
+	for (const FString& Id : Bindings.BoneIds)
+	{
+		SLAppendCacheString(Buffer, Id);
+	}
+	for (const FString& Id : Bindings.StaticActorIds)
+	{
+		SLAppendCacheString(Buffer, Id);
+	}
+	SLAppendCacheArray(Buffer, InEpisodeData.Timestamps);
+	SLAppendCacheArray(Buffer, InEpisodeData.StaticActorPoses);
+	SLAppendCacheArray(Buffer, Bindings.ComponentBoneOffsets);
+	SLAppendCacheArray(Buffer, Bindings.BoneIndexes);
+	SLAppendCacheArray(Buffer, InEpisodeData.KeyframeActorPoses);
+	SLAppendCacheArray(Buffer, InEpisodeData.KeyframeBonePoses);
+	SLAppendCacheArray(Buffer, InEpisodeData.DeltaActorOffsets);
+	SLAppendCacheArray(Buffer, InEpisodeData.DeltaActorSlots);
+	SLAppendCacheArray(Buffer, InEpisodeData.DeltaActorPoses);
+	SLAppendCacheArray(Buffer, InEpisodeData.DeltaBoneOffsets);
+	SLAppendCacheArray(Buffer, InEpisodeData.DeltaBoneSlots);
+	SLAppendCacheArray(Buffer, InEpisodeData.DeltaBonePoses);
+
+	// Write next to the final file and replace it, a half written file is never loaded
+	const FString FilePath = GetFilePath(TaskId, EpisodeId);
+	const FString TempFilePath = FilePath + TEXT(".tmp");
+	FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*FPaths::GetPath(FilePath));
+	if (!FFileHelper::SaveArrayToFile(Buffer, *TempFilePath) || !IFileManager::Get().Move(*FilePath, *TempFilePath, true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s::%d Could not write the episode cache file %s.."), *FString(__FUNCTION__), __LINE__, *FilePath);
+		IFileManager::Get().Delete(*TempFilePath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Wrote episode cache file %s (%.2f MB) in [%f] seconds.."),
+		*FString(__FUNCTION__), __LINE__, *FilePath, Buffer.Num() / (1024.0 * 1024.0), FPlatformTime::Seconds() - ExecBegin);
+	return true;
+}
+
+// Load the compiled episode from its cache file (false if missing, outdated, or not matching the world individuals)
+bool FSLVizEpisodeCacheFile::Load(ASLIndividualManager* IndividualManager, const FString& TaskId, const FString& EpisodeId,
+	const FString& ContentSignature, FSLVizEpisodeData& OutEpisodeData)
+{
+	const FString FilePath = GetFilePath(TaskId, EpisodeId);
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (ContentSignature.IsEmpty() || !PlatformFile.FileExists(*FilePath))
+	{
+		return false;
+	}
+	const double ExecBegin = FPlatformTime::Seconds();
+
+	// Map the file, fall back to reading it if mapping is not supported
+	IMappedFileHandle* MappedHandle = PlatformFile.OpenMapped(*FilePath);
+	IMappedFileRegion* MappedRegion = MappedHandle ? MappedHandle->MapRegion() : nullptr;
+	TArray<uint8> FallbackData;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(FallbackData, *FilePath))
+	{
+		Data = FallbackData.GetData();
+		Size = FallbackData.Num();
+	}
+
+	const bool bLoaded = Data != nullptr
+		&& Read(IndividualManager, Data, Size, FCrc::StrCrc32(*ContentSignature), OutEpisodeData);
+
+	if (MappedRegion)
+	{
+		delete MappedRegion;
+	}
+	if (MappedHandle)
+	{
+		delete MappedHandle;
+	}
+
+	if (!bLoaded)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode cache file %s is outdated or does not match the world, it will be rebuilt.."),
+			*FString(__FUNCTION__), __LINE__, *FilePath);
+		OutEpisodeData.Clear();
+		return false;
+	}
+
+	OutEpisodeData.Id = EpisodeId;
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Loaded episode cache file %s (frames=%d; %s) in [%f] seconds.."),
+		*FString(__FUNCTION__), __LINE__, *FilePath, OutEpisodeData.NumFrames(), *OutEpisodeData.GetDynamicsInfo(),
+		FPlatformTime::Seconds() - ExecBegin);
+	return true;
+}
+
+// Read the data and rebind its slots to the world (false if not valid)
+bool FSLVizEpisodeCacheFile::Read(ASLIndividualManager* IndividualManager, const uint8* Data, int64 Size, uint32 ContentHash,
+	FSLVizEpisodeData& OutEpisodeData)
+{
+	int64 Offset = 0;
+	FSLVizEpisodeCacheHeader Header;
+	if (!SLReadCacheValue(Data, Size, Offset, Header)
+		|| Header.Magic != SLVizCacheFileMagic
+		|| Header.Version != SLVizCacheFileVersion
+		|| Header.TransformSize != sizeof(FTransform)
+		|| Header.ContentHash != ContentHash
+		|| Header.KeyframeInterval < 1)
+	{
+		return false;
+	}
+
+	// The counts size the arrays before they are read, every id needs at least its length in the file
+	if (Header.NumFrames < 0 || Header.NumActors < 0 || Header.NumStaticActors < 0 || Header.NumComponents < 0
+		|| Header.NumBones < 0 || Header.NumKeyframes < 0 || Header.NumDeltaActors < 0 || Header.NumDeltaBones < 0
+		|| ((int64)Header.NumActors + Header.NumBones + Header.NumStaticActors) * (int64)sizeof(uint32) > Size - Offset)
+	{
+		return false;
+	}
+
+	OutEpisodeData.Clear();
+	OutEpisodeData.KeyframeInterval = Header.KeyframeInterval;
+	FSLVizEpisodeBindings& Bindings = OutEpisodeData.Bindings;
+
+	Bindings.ActorIds.SetNum(Header.NumActors);
+	for (FString& Id : Bindings.ActorIds)
+	{
+		if (!SLReadCacheString(Data, Size, Offset, Id))
+		{
+			return false;
+		}
+	}
+	Bindings.BoneIds.SetNum(Header.NumBones);
+	for (FString& Id : Bindings.BoneIds)
+	{
+		if (!SLReadCacheString(Data, Size, Offset, Id))
+		{
+			return false;
+		}
+	}
+	Bindings.StaticActorIds.SetNum(Header.NumStaticActors);
+	for (FString& Id : Bindings.StaticActorIds)
+	{
+		if (!SLReadCacheString(Data, Size, Offset, Id))
+		{
+			return false;
+		}
+	}
+
+	if (!SLReadCacheArray(Data, Size, Offset, Header.NumFrames, OutEpisodeData.Timestamps)
+		|| !SLReadCacheArray(Data, Size, Offset, Header.NumStaticActors, OutEpisodeData.StaticActorPoses)
+		|| !SLReadCacheArray(Data, Size, Offset, (int64)Header.NumComponents + 1, Bindings.ComponentBoneOffsets)
+		|| !SLReadCacheArray(Data, Size, Offset, Header.NumBones, Bindings.BoneIndexes)
+		|| !SLReadCacheArray(Data, Size, Offset, (int64)Header.NumKeyframes * Header.NumActors, OutEpisodeData.KeyframeActorPoses)
+		|| !SLReadCacheArray(Data, Size, Offset, (int64)Header.NumKeyframes * Header.NumBones, OutEpisodeData.KeyframeBonePoses)
+		|| !SLReadCacheArray(Data, Size, Offset, (int64)Header.NumFrames + 1, OutEpisodeData.DeltaActorOffsets)
+		|| !SLReadCacheArray(Data, Size, Offset, Header.NumDeltaActors, OutEpisodeData.DeltaActorSlots)
+		|| !SLReadCacheArray(Data, Size, Offset, Header.NumDeltaActors, OutEpisodeData.DeltaActorPoses)
+		|| !SLReadCacheArray(Data, Size, Offset, (int64)Header.NumFrames + 1, OutEpisodeData.DeltaBoneOffsets)
+		|| !SLReadCacheArray(Data, Size, Offset, Header.NumDeltaBones, OutEpisodeData.DeltaBoneSlots)
+		|| !SLReadCacheArray(Data, Size, Offset, Header.NumDeltaBones, OutEpisodeData.DeltaBonePoses))
+	{
+		return false;
+	}
+	if (Bindings.ComponentBoneOffsets[0] != 0 || Bindings.ComponentBoneOffsets.Last() != Header.NumBones)
+	{
+		return false;
+	}
+
+	// Rebind the actor slots and the static actors to the world (the static mobility ones are never part of the replay)
+	AActor* Actor = nullptr;
+	UPoseableMeshComponent* PMC = nullptr;
+	int32 BoneIndex = INDEX_NONE;
+	Bindings.Actors.Reserve(Header.NumActors);
+	for (const FString& Id : Bindings.ActorIds)
+	{
+		if (!FSLVizEpisodeUtils::ResolveIndividual(IndividualManager, Id, Actor, PMC, BoneIndex) || Actor == nullptr
+			|| FSLVizEpisodeUtils::IsStaticMobilityActor(Actor))
+		{
+			return false;
+		}
+		Bindings.Actors.Add(Actor);
+	}
+	Bindings.StaticActors.Reserve(Header.NumStaticActors);
+	for (const FString& Id : Bindings.StaticActorIds)
+	{
+		if (!FSLVizEpisodeUtils::ResolveIndividual(IndividualManager, Id, Actor, PMC, BoneIndex) || Actor == nullptr
+			|| FSLVizEpisodeUtils::IsStaticMobilityActor(Actor))
+		{
+			return false;
+		}
+		Bindings.StaticActors.Add(Actor);
+	}
+
+	// Rebind the bone slots, every component range needs to resolve to the same component and the same bone indexes
+	Bindings.BoneComponents.Reserve(Header.NumBones);
+	for (int32 CompIdx = 0; CompIdx < Header.NumComponents; ++CompIdx)
+	{
+		UPoseableMeshComponent* ComponentPMC = nullptr;
+		for (int32 BoneSlot = Bindings.ComponentBoneOffsets[CompIdx]; BoneSlot < Bindings.ComponentBoneOffsets[CompIdx + 1]; ++BoneSlot)
+		{
+			if (!FSLVizEpisodeUtils::ResolveIndividual(IndividualManager, Bindings.BoneIds[BoneSlot], Actor, PMC, BoneIndex)
+				|| PMC == nullptr
+				|| BoneIndex != Bindings.BoneIndexes[BoneSlot]
+				|| (ComponentPMC != nullptr && PMC != ComponentPMC))
+			{
+				return false;
+			}
+			ComponentPMC = PMC;
+			Bindings.BoneComponents.Add(CompIdx);
+		}
+		if (ComponentPMC == nullptr || Bindings.SkeletalComponents.Contains(ComponentPMC))
+		{
+			return false;
+		}
+		Bindings.SkeletalComponents.Add(ComponentPMC);
+	}
+
+	// The offsets and the slots of the changes need to be in range
+	for (int32 FrameIdx = 0; FrameIdx < Header.NumFrames; ++FrameIdx)
+	{
+		if (OutEpisodeData.DeltaActorOffsets[FrameIdx] > OutEpisodeData.DeltaActorOffsets[FrameIdx + 1]
+			|| OutEpisodeData.DeltaBoneOffsets[FrameIdx] > OutEpisodeData.DeltaBoneOffsets[FrameIdx + 1])
+		{
+			return false;
+		}
+	}
+	if (OutEpisodeData.DeltaActorOffsets[0] != 0 || OutEpisodeData.DeltaActorOffsets.Last() != Header.NumDeltaActors
+		|| OutEpisodeData.DeltaBoneOffsets[0] != 0 || OutEpisodeData.DeltaBoneOffsets.Last() != Header.NumDeltaBones)
+	{
+		return false;
+	}
+	for (const int32 Slot : OutEpisodeData.DeltaActorSlots)
+	{
+		if (Slot < 0 || Slot >= Header.NumActors)
+		{
+			return false;
+		}
+	}
+	for (const int32 Slot : OutEpisodeData.DeltaBoneSlots)
+	{
+		if (Slot < 0 || Slot >= Header.NumBones)
+		{
+			return false;
+		}
+	}
+	return OutEpisodeData.IsValid();
+}
@@ -0,0 +1,265 @@
+// Copyright 2017-2020, Institute for Artificial Intelligence - University of Bremen
+// Author: Andrei Haidu (http://haidu.eu)
+
+#include "Viz/SLVizEpisodeCompiler.h"
+#include "Viz/SLVizEpisodeUtils.h"
+#include "Components/PoseableMeshComponent.h"
+#include "Async/Async.h"
+
+// Ctor
+FSLVizEpisodeCompiler::FSLVizEpisodeCompiler(const FString& InTaskId, const FString& InEpisodeId, const FString& InContentSignature)
+	: TaskId(InTaskId), EpisodeId(InEpisodeId), ContentSignature(InContentSignature)
+{
+	NumTotalFrames = 0;
+	bPrepared = false;
+	bStarted = false;
+}
+
+// Dtor, cancels and waits for any running compilation
+FSLVizEpisodeCompiler::~FSLVizEpisodeCompiler()
+{
+	if (Future.IsValid())
+	{
+		Cancel();
+		Future.Wait();
+	}
+}
+
+// Resolve the ids of the frames to the world individuals and read their initial poses (game thread only)
+bool FSLVizEpisodeCompiler::Prepare(ASLIndividualManager* IndividualManager, FSLMongoEpisodeFrames&& InFrames)
+{
+	check(IsInGameThread());
+	if (bPrepared || bStarted)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s is already prepared.."), *FString(__FUNCTION__), __LINE__, *EpisodeId);
+		return false;
+	}
+	if (InFrames.NumFrames() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s has no frames.."), *FString(__FUNCTION__), __LINE__, *EpisodeId);
+		return false;
+	}
+
+	const double ExecBegin = FPlatformTime::Seconds();
+	Frames = MoveTemp(InFrames);
+	NumTotalFrames = Frames.NumFrames();
+	EpisodeData = MakeShared<FSLVizEpisodeData, ESPMode::ThreadSafe>(Frames.NumFrames());
+	EpisodeData->Id = EpisodeId;
+
+	// Resolve every individual id once, to its actor or (component, bone index) slot
+	if (!FSLVizEpisodeUtils::BuildEpisodeBindings(IndividualManager, Frames.Ids, EpisodeData->Bindings, IdxToActorSlot, IdxToBoneSlot))
+	{
+		EpisodeData.Reset();
+		Frames.Empty();
+		return false;
+	}
+	const FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+
+	// The slots which are not recorded in the first frame keep their current pose
+	InitialFrame.ActorPoses.Reserve(Bindings.NumActors());
+	for (AActor* Actor : Bindings.Actors)
+	{
+		InitialFrame.ActorPoses.Add(Actor->GetActorTransform());
+	}
+	InitialFrame.BonePoses.Reserve(Bindings.NumBones());
+	for (int32 BoneSlot = 0; BoneSlot < Bindings.NumBones(); ++BoneSlot)
+	{
+		UPoseableMeshComponent* PMC = Bindings.SkeletalComponents[Bindings.BoneComponents[BoneSlot]];
+		InitialFrame.BonePoses.Add(PMC->GetBoneTransform(Bindings.BoneIndexes[BoneSlot]));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s bindings(ids=%d, actors=%d, bones=%d) duration=[%f] seconds..;"),
+		*FString(__func__), __LINE__, *EpisodeId, Frames.Ids.Num(), Bindings.NumActors(), Bindings.NumBones(),
+		FPlatformTime::Seconds() - ExecBegin);
+	bPrepared = true;
+	return true;
+}
+
+// Compile the frames on the calling thread (returns false if it failed or was cancelled)
+bool FSLVizEpisodeCompiler::Run()
+{
+	if (!bPrepared || bStarted)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s is not prepared or is already compiling.."), *FString(__FUNCTION__), __LINE__, *EpisodeId);
+		return false;
+	}
+	bStarted = true;
+	return CompileFrames();
+}
+
+// Compile the frames on the thread pool
+bool FSLVizEpisodeCompiler::StartAsync()
+{
+	if (!bPrepared || bStarted)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s is not prepared or is already compiling.."), *FString(__FUNCTION__), __LINE__, *EpisodeId);
+		return false;
+	}
+	bStarted = true;
+	Future = Async(EAsyncExecution::ThreadPool, [this]() { return CompileFrames(); });
+	return true;
+}
+
+// Progress of the compilation [0, 1]
+float FSLVizEpisodeCompiler::GetProgress() const
+{
+	return NumTotalFrames > 0 ? (float)NumCompiledFrames.GetValue() / NumTotalFrames : 0.f;
+}
+
+// Wait for the compilation and get the episode data (invalid if it failed or was cancelled)
+FSLVizEpisodeDataPtr FSLVizEpisodeCompiler::GetResult()
+{
+	if (!bStarted)
+	{
+		return nullptr;
+	}
+	const bool bSuccess = Future.IsValid() ? Future.Get() : EpisodeData.IsValid();
+	if (!bSuccess || bCancelRequested)
+	{
+		return nullptr;
+	}
+	return EpisodeData;
+}
+
+// Build the keyframes and deltas from the frames and the resolved slots
+bool FSLVizEpisodeCompiler::CompileFrames()
+{
+	const double ExecBegin = FPlatformTime::Seconds();
+	FSLVizEpisodeData& OutData = *EpisodeData;
+	const FSLVizEpisodeBindings& Bindings = OutData.Bindings;
+
+	// The actors which never move are excluded from the keyframes and the deltas
+	PruneStaticActors();
+	FSLVizEpisodeFrameData& FullFrameData = InitialFrame;
+
+	// Skeletal components with changed bones in the current frame
+	TArray<bool> ComponentChanged;
+	ComponentChanged.SetNumZeroed(Bindings.SkeletalComponents.Num());
+
+	// Update full frame with the new transform values
+	// Store the changes from the previous frame, and a full copy only every keyframe interval
+	for (int32 FrameIndex = 0; FrameIndex < Frames.NumFrames(); ++FrameIndex)
+	{
+		if (bCancelRequested)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s compilation cancelled at frame %d / %d .."),
+				*FString(__func__), __LINE__, *EpisodeId, FrameIndex, Frames.NumFrames());
+			OutData.Clear();
+			Frames.Empty();
+			return false;
+		}
+
+		OutData.AddFrame(Frames.Timestamps[FrameIndex]);
+		for (int32 EntryIdx = Frames.FrameOffsets[FrameIndex]; EntryIdx < Frames.FrameOffsets[FrameIndex + 1]; ++EntryIdx)
+		{
+			const int32 Idx = Frames.EntryIdxs[EntryIdx];
+			const FTransform& Pose = Frames.EntryPoses[EntryIdx];
+			if (IdxToActorSlot[Idx] != INDEX_NONE)
+			{
+				FullFrameData.ActorPoses[IdxToActorSlot[Idx]] = Pose;
+				OutData.AddActorChange(IdxToActorSlot[Idx], Pose);
+			}
+			else if (IdxToBoneSlot[Idx] != INDEX_NONE)
+			{
+				FullFrameData.BonePoses[IdxToBoneSlot[Idx]] = Pose;
+				ComponentChanged[Bindings.BoneComponents[IdxToBoneSlot[Idx]]] = true;
+			}
+		}
+
+		// The bones are set in world space, the moved skeletons get all their bones re-applied
+		// otherwise the unchanged children would be offseted by their moved parents
+		for (int32 CompIdx = 0; CompIdx < ComponentChanged.Num(); ++CompIdx)
+		{
+			if (ComponentChanged[CompIdx])
+			{
+				for (int32 BoneSlot = Bindings.ComponentBoneOffsets[CompIdx]; BoneSlot < Bindings.ComponentBoneOffsets[CompIdx + 1]; ++BoneSlot)
+				{
+					OutData.AddBoneChange(BoneSlot, FullFrameData.BonePoses[BoneSlot]);
+				}
+				ComponentChanged[CompIdx] = false;
+			}
+		}
+
+		if (OutData.IsKeyframe(FrameIndex))
+		{
+			OutData.AddKeyframe(FullFrameData);
+		}
+		NumCompiledFrames.Set(FrameIndex + 1);
+	}
+	OutData.Shrink();
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s frames(num=%d, keyframes=%d) %s duration=[%f] seconds..;"),
+		*FString(__func__), __LINE__, *EpisodeId, OutData.NumFrames(), OutData.NumKeyframes(), *OutData.GetDynamicsInfo(),
+		FPlatformTime::Seconds() - ExecBegin);
+
+	// The input is no longer needed
+	Frames.Empty();
+	IdxToActorSlot.Empty();
+	IdxToBoneSlot.Empty();
+	InitialFrame.ActorPoses.Empty();
+	InitialFrame.BonePoses.Empty();
+	return true;
+}
+
+// Move the actors which keep their pose during the whole episode from the slots to the static actors
+void FSLVizEpisodeCompiler::PruneStaticActors()
+{
+	FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+	const int32 NumActors = Bindings.NumActors();
+
+	// The pose of the first frame is the reference, the slots not recorded in it keep their current world pose
+	TArray<FTransform> ReferencePoses = InitialFrame.ActorPoses;
+	for (int32 EntryIdx = Frames.FrameOffsets[0]; EntryIdx < Frames.FrameOffsets[1]; ++EntryIdx)
+	{
+		const int32 ActorSlot = IdxToActorSlot[Frames.EntryIdxs[EntryIdx]];
+		if (ActorSlot != INDEX_NONE)
+		{
+			ReferencePoses[ActorSlot] = Frames.EntryPoses[EntryIdx];
+		}
+	}
+
+	// An actor moves if any of its following poses differs from the reference
+	TBitArray<> ActorMoves(false, NumActors);
+	for (int32 EntryIdx = Frames.FrameOffsets[1]; EntryIdx < Frames.EntryIdxs.Num(); ++EntryIdx)
+	{
+		const int32 ActorSlot = IdxToActorSlot[Frames.EntryIdxs[EntryIdx]];
+		if (ActorSlot != INDEX_NONE && !ActorMoves[ActorSlot] && !Frames.EntryPoses[EntryIdx].Equals(ReferencePoses[ActorSlot]))
+		{
+			ActorMoves[ActorSlot] = true;
+		}
+	}
+
+	// Compact the moving actors to the front, the others are stored with their reference pose
+	TArray<int32> OldToNewSlot;
+	OldToNewSlot.Init(INDEX_NONE, NumActors);
+	int32 NumDynamic = 0;
+	for (int32 ActorSlot = 0; ActorSlot < NumActors; ++ActorSlot)
+	{
+		if (ActorMoves[ActorSlot])
+		{
+			OldToNewSlot[ActorSlot] = NumDynamic;
+			Bindings.Actors[NumDynamic] = Bindings.Actors[ActorSlot];
+			Swap(Bindings.ActorIds[NumDynamic], Bindings.ActorIds[ActorSlot]);
+			InitialFrame.ActorPoses[NumDynamic] = InitialFrame.ActorPoses[ActorSlot];
+			NumDynamic++;
+		}
+		else
+		{
+			Bindings.StaticActors.Add(Bindings.Actors[ActorSlot]);
+			Bindings.StaticActorIds.Add(Bindings.ActorIds[ActorSlot]);
+			EpisodeData->StaticActorPoses.Add(ReferencePoses[ActorSlot]);
+		}
+	}
+	Bindings.Actors.SetNum(NumDynamic);
+	Bindings.ActorIds.SetNum(NumDynamic);
+	InitialFrame.ActorPoses.SetNum(NumDynamic);
+
+	// The entries of the static actors are skipped from now on
+	for (int32& ActorSlot : IdxToActorSlot)
+	{
+		if (ActorSlot != INDEX_NONE)
+		{
+			ActorSlot = OldToNewSlot[ActorSlot];
+		}
+	}
+}
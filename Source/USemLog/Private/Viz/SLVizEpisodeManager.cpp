@@ -16,8 +16,14 @@ ASLVizEpisodeManager::ASLVizEpisodeManager()
 	bEpisodeLoaded = false;
 	bLoopReplay = false;
 	bReplayRunning = false;
+	bRealtimeReplay = false;
+	bInterpolateReplay = false;
+	bStaticPosesApplied = false;
 
 	EpisodeDefaultUpdateRate = 0.f;
+	ReplaySpeedFactor = 1.f;
+	ReplayTime = 0.f;
+	LastReplayWallTime = 0.0;
 	ActiveFrameIndex = INDEX_NONE;
 	ReplayFirstFrameIndex = INDEX_NONE;
 	ReplayLastFrameIndex = INDEX_NONE;
@@ -34,12 +40,17 @@ void ASLVizEpisodeManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (!ApplyNextFrameChanges())
+	const bool bHasNextFrame = bRealtimeReplay ? UpdateRealtimeReplay() : ApplyNextFrameChanges();
+	if (!bHasNextFrame)
 	{
 		if (bLoopReplay)
 		{
 			ActiveFrameIndex = ReplayFirstFrameIndex;
 			GotoFrame(ActiveFrameIndex);
+			if (bRealtimeReplay)
+			{
+				ResetRealtimeReplay(ActiveFrameIndex);
+			}
 		}
 		else
 		{
@@ -69,10 +80,10 @@ void ASLVizEpisodeManager::ConvertWorld()
 }
 
 // Load episode data
-void ASLVizEpisodeManager::LoadEpisode(const FSLVizEpisodeData& InEpisodeData)
+void ASLVizEpisodeManager::LoadEpisode(const FSLVizEpisodeDataPtr& InEpisodeData)
 {
 	// Check if the data is valid
-	if (!InEpisodeData.IsValid())
+	if (!InEpisodeData.IsValid() || !InEpisodeData->IsValid())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode data is not valid to load.."), *FString(__FUNCTION__), __LINE__);
 		return;
@@ -88,8 +99,10 @@ void ASLVizEpisodeManager::LoadEpisode(const FSLVizEpisodeData& InEpisodeData)
 	// Clear any previous episode
 	ClearEpisode();
 
-	// Set the episode data
+	// Keep a reference to the (shared, immutable) episode data
 	EpisodeData = InEpisodeData;
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Loaded episode %s: %s;"), *FString(__FUNCTION__), __LINE__,
+		*EpisodeData->Id, *EpisodeData->GetDynamicsInfo());
 
 	// Calculate a default update rate  
 	CalcRealtimeAproxUpdateRateValue(256);
@@ -105,12 +118,15 @@ void ASLVizEpisodeManager::LoadEpisode(const FSLVizEpisodeData& InEpisodeData)
 void ASLVizEpisodeManager::ClearEpisode()
 {
 	StopReplay();
-	EpisodeData.Clear();
+	EpisodeData.Reset();
+	GotoFrameData.ActorPoses.Empty();
+	GotoFrameData.BonePoses.Empty();
 	ActiveFrameIndex = INDEX_NONE;
 	ReplayFirstFrameIndex = INDEX_NONE;
 	ReplayLastFrameIndex = INDEX_NONE;
 	bEpisodeLoaded = false;
 	bReplayRunning = false;
+	bStaticPosesApplied = false;
 	SetActorTickEnabled(false);
 }
 
@@ -129,14 +145,21 @@ bool ASLVizEpisodeManager::GotoFrame(int32 FrameIndex)
 		return false;
 	}
 
-	if(!EpisodeData.FullFrames.IsValidIndex(FrameIndex))
+	// Rebuild the frame from the nearest keyframe and the following changes
+	if(!EpisodeData->BuildFrame(FrameIndex, GotoFrameData))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d Frame index is not valid, this should not happen.."), *FString(__FUNCTION__), __LINE__);
 		return false;
 	}
 
+	// The actors which do not move are set only once per loaded episode
+	if (!bStaticPosesApplied)
+	{
+		ApplyStaticPoses();
+	}
+
 	ActiveFrameIndex = FrameIndex;
-	ApplyPoses(EpisodeData.FullFrames[FrameIndex]);
+	ApplyPoses(GotoFrameData);
 
 	//UE_LOG(LogTemp, Log, TEXT("%s::%d Applied poses from frame %d.."), *FString(__FUNCTION__), __LINE__, ActiveFrameIndex);
 	return true;
@@ -145,7 +168,7 @@ bool ASLVizEpisodeManager::GotoFrame(int32 FrameIndex)
 // Set visual world as in the given timestamp (binary search for nearest index)
 bool ASLVizEpisodeManager::GotoFrame(float Timestamp)
 {
-	return GotoFrame(FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData.Timestamps, Timestamp));
+	return GotoFrame(FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData->Timestamps, Timestamp));
 }
 
 // Play episode with the given parameters
@@ -168,19 +191,35 @@ bool ASLVizEpisodeManager::Play(const FSLVizEpisodePlayParams& PlayParams)
 
 	// Set first frame
 	ReplayFirstFrameIndex = PlayParams.StartTime < 0 ? 0 
-		: FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData.Timestamps, PlayParams.StartTime);
+		: FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData->Timestamps, PlayParams.StartTime);
 
 	// Set last frame
-	ReplayLastFrameIndex = PlayParams.EndTime < 0 ? EpisodeData.Timestamps.Num()
-		: PlayParams.EndTime < PlayParams.StartTime ? EpisodeData.Timestamps.Num() 
-			: FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData.Timestamps, PlayParams.EndTime);
+	ReplayLastFrameIndex = PlayParams.EndTime < 0 ? EpisodeData->Timestamps.Num()
+		: PlayParams.EndTime < PlayParams.StartTime ? EpisodeData->Timestamps.Num() 
+			: FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData->Timestamps, PlayParams.EndTime);
 
 	// Should the replay be looped
 	bLoopReplay = PlayParams.bLoop;
 
+	// Wall clock synchronized replay
+	bRealtimeReplay = PlayParams.bRealtime;
+	bInterpolateReplay = PlayParams.bInterpolate;
+	ReplaySpeedFactor = FMath::Max(PlayParams.SpeedFactor, 0.01f);
+
 	// Goto first frame
 	GotoFrame(ReplayFirstFrameIndex);
 
+	// The realtime replay updates every tick, the frame rate is given by the timestamps
+	if (bRealtimeReplay)
+	{
+		SetActorTickInterval(0.f);
+		ResetRealtimeReplay(ReplayFirstFrameIndex);
+	}
+	else
+	{
+		SetActorTickInterval(PlayParams.UpdateRate > 0.f ? PlayParams.UpdateRate : EpisodeDefaultUpdateRate);
+	}
+
 	// Start playing the frames
 	StartReplay();
 
@@ -204,7 +243,8 @@ bool ASLVizEpisodeManager::PlayEpisode()
 
 	// Set replay flags
 	ReplayFirstFrameIndex = 0;
-	ReplayLastFrameIndex = EpisodeData.Timestamps.Num();
+	ReplayLastFrameIndex = EpisodeData->Timestamps.Num();
+	bRealtimeReplay = false;
 
 	// Goto first frame
 	GotoFrame(ReplayFirstFrameIndex);
@@ -219,7 +259,7 @@ bool ASLVizEpisodeManager::PlayEpisode()
 // Play given frames
 bool ASLVizEpisodeManager::PlayFrames(int32 FirstFrame, int32 LastFrame)
 {
-	if (FirstFrame < 0 || LastFrame < 0 || FirstFrame > LastFrame || LastFrame > EpisodeData.Timestamps.Num())
+	if (FirstFrame < 0 || LastFrame < 0 || FirstFrame > LastFrame || LastFrame > EpisodeData->Timestamps.Num())
 	{
 		UE_LOG(LogTemp, Error, TEXT("%s::%d FirstFrame=%d and LastFrame=%d are not valid.."), *FString(__FUNCTION__), __LINE__, FirstFrame, LastFrame);
 		return false;
@@ -227,6 +267,7 @@ bool ASLVizEpisodeManager::PlayFrames(int32 FirstFrame, int32 LastFrame)
 	// Set replay flags
 	ReplayFirstFrameIndex = FirstFrame;
 	ReplayLastFrameIndex = LastFrame;
+	bRealtimeReplay = false;
 
 	// Goto first frame
 	GotoFrame(ReplayFirstFrameIndex);
@@ -246,8 +287,8 @@ bool ASLVizEpisodeManager::PlayTimeline(float StartTime, float EndTime)
 		UE_LOG(LogTemp, Error, TEXT("%s::%d StartTime=%f and EndTime=%f are not valid.."), *FString(__FUNCTION__), __LINE__, StartTime, EndTime);
 		return false;
 	}
-	int32 StartFrameIndex = FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData.Timestamps, StartTime);
-	int32 EndFrameIndex = FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData.Timestamps, EndTime);
+	int32 StartFrameIndex = FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData->Timestamps, StartTime);
+	int32 EndFrameIndex = FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData->Timestamps, EndTime);
 	return PlayFrames(StartFrameIndex, EndFrameIndex);
 }
 
@@ -265,6 +306,9 @@ void ASLVizEpisodeManager::SetPauseReplay(bool bPause)
 	{
 		SetActorTickEnabled(!bPause);
 		bReplayRunning = !bPause;
+
+		// Do not count the paused time
+		LastReplayWallTime = FPlatformTime::Seconds();
 	}
 }
 
@@ -477,19 +521,16 @@ bool ASLVizEpisodeManager::ApplyNextFrameChanges()
 	if (ActiveFrameIndex < ReplayLastFrameIndex)
 	{
 		ActiveFrameIndex++;
-		//if (EpisodeData.CompactFrames.IsValidIndex(ActiveFrameIndex))
-		if (EpisodeData.FullFrames.IsValidIndex(ActiveFrameIndex))
+		// The previous frame is already applied, only the changes are needed
+		if (EpisodeData->Timestamps.IsValidIndex(ActiveFrameIndex))
 		{
-			//ApplyPoses(EpisodeData.CompactFrames[ActiveFrameIndex]);
-			ApplyPoses(EpisodeData.FullFrames[ActiveFrameIndex]);
+			ApplyFrameChanges(ActiveFrameIndex);
 			return true;
 		}
 		else
 		{
-			//UE_LOG(LogTemp, Warning, TEXT("%s::%d ActiveFrameIndex=%d (Num=%d) is not valid, this should not happen.."),
-			//	*FString(__FUNCTION__), __LINE__, ActiveFrameIndex, EpisodeData.CompactFrames.Num());
 			UE_LOG(LogTemp, Warning, TEXT("%s::%d ActiveFrameIndex=%d (Num=%d) is not valid, this should not happen.."),
-				*FString(__FUNCTION__), __LINE__, ActiveFrameIndex, EpisodeData.FullFrames.Num());
+				*FString(__FUNCTION__), __LINE__, ActiveFrameIndex, EpisodeData->NumFrames());
 			ActiveFrameIndex--;
 		}
 	}
@@ -503,44 +544,230 @@ void ASLVizEpisodeManager::StartReplay()
 	SetActorTickEnabled(true);
 	bReplayRunning = true;}
 
-// Apply frame poses
+// Apply the poses of the actors which do not move during the episode
+void ASLVizEpisodeManager::ApplyStaticPoses()
+{
+	const FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+	for (int32 Idx = 0; Idx < Bindings.NumStaticActors(); ++Idx)
+	{
+		Bindings.StaticActors[Idx]->SetActorTransform(EpisodeData->StaticActorPoses[Idx]);
+	}
+	bStaticPosesApplied = true;
+}
+
+// Apply all the poses of the full frame
 void ASLVizEpisodeManager::ApplyPoses(const FSLVizEpisodeFrameData& Frame)
 {
-	for (const auto& ActorPosePair : Frame.ActorPoses)
+	const FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+	for (int32 ActorSlot = 0; ActorSlot < Bindings.NumActors(); ++ActorSlot)
+	{
+		Bindings.Actors[ActorSlot]->SetActorTransform(Frame.ActorPoses[ActorSlot]);
+	}
+
+	// Single parent-first pass for every skeletal component (the bone slots are sorted by bone index)
+	for (int32 CompIdx = 0; CompIdx < Bindings.SkeletalComponents.Num(); ++CompIdx)
+	{
+		const int32 FirstSlot = Bindings.ComponentBoneOffsets[CompIdx];
+		FSLVizEpisodeUtils::SetBoneWorldPoses(Bindings.SkeletalComponents[CompIdx], Bindings.BoneIndexes.GetData() + FirstSlot,
+			Frame.BonePoses.GetData() + FirstSlot, Bindings.ComponentBoneOffsets[CompIdx + 1] - FirstSlot, ComponentSpaceBuffer);
+	}
+}
+
+// Apply only the changes of the given frame (the previous frame needs to be already applied)
+void ASLVizEpisodeManager::ApplyFrameChanges(int32 FrameIndex)
+{
+	const FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+	for (int32 Idx = EpisodeData->DeltaActorOffsets[FrameIndex]; Idx < EpisodeData->DeltaActorOffsets[FrameIndex + 1]; ++Idx)
+	{
+		Bindings.Actors[EpisodeData->DeltaActorSlots[Idx]]->SetActorTransform(EpisodeData->DeltaActorPoses[Idx]);
+	}
+
+	// The changed bones are sorted and grouped by component, apply every group with a single pass
+	TArray<int32>& BoneIndexes = ComponentBoneIndexesBuffer;
+	int32 GroupBegin = EpisodeData->DeltaBoneOffsets[FrameIndex];
+	const int32 End = EpisodeData->DeltaBoneOffsets[FrameIndex + 1];
+	while (GroupBegin < End)
+	{
+		const int32 CompIdx = Bindings.BoneComponents[EpisodeData->DeltaBoneSlots[GroupBegin]];
+		BoneIndexes.Reset();
+		int32 GroupEnd = GroupBegin;
+		while (GroupEnd < End && Bindings.BoneComponents[EpisodeData->DeltaBoneSlots[GroupEnd]] == CompIdx)
+		{
+			BoneIndexes.Add(Bindings.BoneIndexes[EpisodeData->DeltaBoneSlots[GroupEnd]]);
+			GroupEnd++;
+		}
+		FSLVizEpisodeUtils::SetBoneWorldPoses(Bindings.SkeletalComponents[CompIdx], BoneIndexes.GetData(),
+			EpisodeData->DeltaBonePoses.GetData() + GroupBegin, BoneIndexes.Num(), ComponentSpaceBuffer);
+		GroupBegin = GroupEnd;
+	}
+}
+
+// Start the realtime replay from the given (already applied) frame
+void ASLVizEpisodeManager::ResetRealtimeReplay(int32 FrameIndex)
+{
+	EpisodeData->BuildFrame(FrameIndex, ReplayFrameData);
+	ReplayApplyFrameData = ReplayFrameData;
+	DirtyActorSlots.Init(false, EpisodeData->Bindings.NumActors());
+	DirtyComponents.Init(false, EpisodeData->Bindings.SkeletalComponents.Num());
+	ReplayTime = EpisodeData->Timestamps[FrameIndex];
+	LastReplayWallTime = FPlatformTime::Seconds();
+}
+
+// Advance the realtime replay with the passed wall clock time (return false if the replay end was reached)
+bool ASLVizEpisodeManager::UpdateRealtimeReplay()
+{
+	const double CurrWallTime = FPlatformTime::Seconds();
+	ReplayTime += (CurrWallTime - LastReplayWallTime) * ReplaySpeedFactor;
+	LastReplayWallTime = CurrWallTime;
+
+	// Map the episode time to the last recorded frame before it
+	const FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+	const int32 LastFrameIndex = FMath::Min(ReplayLastFrameIndex, EpisodeData->NumFrames() - 1);
+	const bool bReachedEnd = ReplayTime >= EpisodeData->Timestamps[LastFrameIndex];
+	const int32 TargetFrameIndex = bReachedEnd ? LastFrameIndex
+		: FMath::Clamp(FSLVizEpisodeUtils::BinarySearchLessEqual(EpisodeData->Timestamps, ReplayTime), ReplayFirstFrameIndex, LastFrameIndex);
+
+	// Skip to the target frame, rebuild it from its keyframe if it is far away
+	if (TargetFrameIndex < ActiveFrameIndex || TargetFrameIndex - ActiveFrameIndex >= EpisodeData->KeyframeInterval)
 	{
-		// todo, static components can be ignored (might make sense to remove them form the episode data)
-		if (ActorPosePair.Key->GetRootComponent()->Mobility != EComponentMobility::Static)
+		EpisodeData->BuildFrame(TargetFrameIndex, ReplayFrameData);
+		ReplayApplyFrameData = ReplayFrameData;
+		DirtyActorSlots.Init(true, Bindings.NumActors());
+		DirtyComponents.Init(true, Bindings.SkeletalComponents.Num());
+	}
+	else
+	{
+		for (int32 FrameIndex = ActiveFrameIndex + 1; FrameIndex <= TargetFrameIndex; ++FrameIndex)
 		{
-			ActorPosePair.Key->SetActorTransform(ActorPosePair.Value);
+			for (int32 Idx = EpisodeData->DeltaActorOffsets[FrameIndex]; Idx < EpisodeData->DeltaActorOffsets[FrameIndex + 1]; ++Idx)
+			{
+				const int32 Slot = EpisodeData->DeltaActorSlots[Idx];
+				ReplayFrameData.ActorPoses[Slot] = EpisodeData->DeltaActorPoses[Idx];
+				ReplayApplyFrameData.ActorPoses[Slot] = EpisodeData->DeltaActorPoses[Idx];
+				DirtyActorSlots[Slot] = true;
+			}
+			for (int32 Idx = EpisodeData->DeltaBoneOffsets[FrameIndex]; Idx < EpisodeData->DeltaBoneOffsets[FrameIndex + 1]; ++Idx)
+			{
+				const int32 Slot = EpisodeData->DeltaBoneSlots[Idx];
+				ReplayFrameData.BonePoses[Slot] = EpisodeData->DeltaBonePoses[Idx];
+				ReplayApplyFrameData.BonePoses[Slot] = EpisodeData->DeltaBonePoses[Idx];
+				DirtyComponents[Bindings.BoneComponents[Slot]] = true;
+			}
 		}
 	}
+	ActiveFrameIndex = TargetFrameIndex;
+
+	// Interpolate the slots changing in the next recorded frame, the previously 
+	// interpolated slots are part of the already applied changes of the newer frames
+	const int32 NextFrameIndex = TargetFrameIndex + 1;
+	if (bInterpolateReplay && !bReachedEnd && NextFrameIndex <= LastFrameIndex)
+	{
+		const float FrameDuration = EpisodeData->Timestamps[NextFrameIndex] - EpisodeData->Timestamps[TargetFrameIndex];
+		const float Alpha = FrameDuration > SMALL_NUMBER
+			? FMath::Clamp((ReplayTime - EpisodeData->Timestamps[TargetFrameIndex]) / FrameDuration, 0.f, 1.f) : 0.f;
+		for (int32 Idx = EpisodeData->DeltaActorOffsets[NextFrameIndex]; Idx < EpisodeData->DeltaActorOffsets[NextFrameIndex + 1]; ++Idx)
+		{
+			const int32 Slot = EpisodeData->DeltaActorSlots[Idx];
+			ReplayApplyFrameData.ActorPoses[Slot] = FSLVizEpisodeUtils::InterpolatePoses(
+				ReplayFrameData.ActorPoses[Slot], EpisodeData->DeltaActorPoses[Idx], Alpha);
+			DirtyActorSlots[Slot] = true;
+		}
+		for (int32 Idx = EpisodeData->DeltaBoneOffsets[NextFrameIndex]; Idx < EpisodeData->DeltaBoneOffsets[NextFrameIndex + 1]; ++Idx)
+		{
+			const int32 Slot = EpisodeData->DeltaBoneSlots[Idx];
+			ReplayApplyFrameData.BonePoses[Slot] = FSLVizEpisodeUtils::InterpolatePoses(
+				ReplayFrameData.BonePoses[Slot], EpisodeData->DeltaBonePoses[Idx], Alpha);
+			DirtyComponents[Bindings.BoneComponents[Slot]] = true;
+		}
+	}
+
+	ApplyDirtyPoses();
+	return !bReachedEnd;
+}
+
+// Apply the poses of the changed slots of the realtime replay
+void ASLVizEpisodeManager::ApplyDirtyPoses()
+{
+	const FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+	for (TConstSetBitIterator<> BitItr(DirtyActorSlots); BitItr; ++BitItr)
+	{
+		Bindings.Actors[BitItr.GetIndex()]->SetActorTransform(ReplayApplyFrameData.ActorPoses[BitItr.GetIndex()]);
+	}
+	for (TConstSetBitIterator<> BitItr(DirtyComponents); BitItr; ++BitItr)
+	{
+		const int32 CompIdx = BitItr.GetIndex();
+		const int32 FirstSlot = Bindings.ComponentBoneOffsets[CompIdx];
+		FSLVizEpisodeUtils::SetBoneWorldPoses(Bindings.SkeletalComponents[CompIdx], Bindings.BoneIndexes.GetData() + FirstSlot,
+			ReplayApplyFrameData.BonePoses.GetData() + FirstSlot, Bindings.ComponentBoneOffsets[CompIdx + 1] - FirstSlot, ComponentSpaceBuffer);
+	}
+	DirtyActorSlots.Init(false, DirtyActorSlots.Num());
+	DirtyComponents.Init(false, DirtyComponents.Num());
+}
+
+// Compare the single pass bone pose application with the previous by-name world space one on the current frame
+void ASLVizEpisodeManager::BenchmarkBonePoses(int32 NumIterations)
+{
+	if (!bEpisodeLoaded || !EpisodeData->BuildFrame(FMath::Max(ActiveFrameIndex, 0), GotoFrameData))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d No episode is loaded.."), *FString(__FUNCTION__), __LINE__);
+		return;
+	}
+	const FSLVizEpisodeBindings& Bindings = EpisodeData->Bindings;
+	NumIterations = FMath::Max(NumIterations, 1);
 
-	// todo, without this multiple iteration the bones are weirdly offseted
-	for (int32 Idx = 0; Idx < 5; Idx++)
+	// Previous approach, 5 world space by-name sets for every bone
+	double ExecBegin = FPlatformTime::Seconds();
+	for (int32 Iter = 0; Iter < NumIterations; ++Iter)
 	{
-		for (const auto& PMCBonePosesPair : Frame.BonePoses)
+		for (int32 Idx = 0; Idx < 5; Idx++)
 		{
-			UPoseableMeshComponent* PMC = PMCBonePosesPair.Key;
-			for (const auto& BoneIndexPosePair : PMCBonePosesPair.Value)
+			for (int32 BoneSlot = 0; BoneSlot < Bindings.NumBones(); ++BoneSlot)
 			{
-				const FName BoneName = PMC->GetBoneName(BoneIndexPosePair.Key);
-				PMC->SetBoneTransformByName(BoneName, BoneIndexPosePair.Value, EBoneSpaces::WorldSpace);
+				UPoseableMeshComponent* PMC = Bindings.SkeletalComponents[Bindings.BoneComponents[BoneSlot]];
+				PMC->SetBoneTransformByName(PMC->GetBoneName(Bindings.BoneIndexes[BoneSlot]), GotoFrameData.BonePoses[BoneSlot], EBoneSpaces::WorldSpace);
 			}
 		}
 	}
+	const double ByNameDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Single parent-first pass
+	ExecBegin = FPlatformTime::Seconds();
+	for (int32 Iter = 0; Iter < NumIterations; ++Iter)
+	{
+		ApplyPoses(GotoFrameData);
+	}
+	const double SinglePassDuration = FPlatformTime::Seconds() - ExecBegin;
+
+	// Max deviation of the resulting bone locations from the recorded ones
+	float MaxError = 0.f;
+	for (UPoseableMeshComponent* PMC : Bindings.SkeletalComponents)
+	{
+		PMC->RefreshBoneTransforms();
+	}
+	for (int32 BoneSlot = 0; BoneSlot < Bindings.NumBones(); ++BoneSlot)
+	{
+		UPoseableMeshComponent* PMC = Bindings.SkeletalComponents[Bindings.BoneComponents[BoneSlot]];
+		const FVector AppliedLoc = PMC->GetBoneTransform(Bindings.BoneIndexes[BoneSlot]).GetLocation();
+		MaxError = FMath::Max(MaxError, FVector::Dist(AppliedLoc, GotoFrameData.BonePoses[BoneSlot].GetLocation()));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("%s::%d Bone poses (components=%d, bones=%d, iterations=%d): by name x5=[%f], single pass=[%f] seconds (speedup=%.2fx); max location error=%f;"),
+		*FString(__FUNCTION__), __LINE__, Bindings.SkeletalComponents.Num(), Bindings.NumBones(), NumIterations,
+		ByNameDuration, SinglePassDuration, SinglePassDuration > 0.0 ? ByNameDuration / SinglePassDuration : 0.0, MaxError);
 }
 
 // Calculate an approximation of the update rate value to coincide with realtime
 void ASLVizEpisodeManager::CalcRealtimeAproxUpdateRateValue(int32 MaxNumSteps)
 {
-	if (!EpisodeData.IsValid())
+	if (!EpisodeData.IsValid() || !EpisodeData->IsValid())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode data is not valid, cannot aprox a default update rate"),
 			*FString(__FUNCTION__), __LINE__);
 		EpisodeDefaultUpdateRate = 0.f;
+		return;
 	}
 
-	const int32 NumFrames = EpisodeData.Timestamps.Num();
+	const int32 NumFrames = EpisodeData->Timestamps.Num();
 	if (MaxNumSteps > NumFrames / 2)
 	{
 		MaxNumSteps = NumFrames / 2;
@@ -558,7 +785,7 @@ void ASLVizEpisodeManager::CalcRealtimeAproxUpdateRateValue(int32 MaxNumSteps)
 	// Start from the first quarter, at the beginning one might have some outliers due to loading time spikes
 	for (int32 Idx = StartFrameIdx; Idx < EndFrameIdx - 1; ++Idx)
 	{
-		UpdateRate += (EpisodeData.Timestamps[Idx + 1] - EpisodeData.Timestamps[Idx]);
+		UpdateRate += (EpisodeData->Timestamps[Idx + 1] - EpisodeData->Timestamps[Idx]);
 	}
 
 	EpisodeDefaultUpdateRate = UpdateRate / ((float)(MaxNumSteps - 1));
@@ -11,6 +11,7 @@
 #include "Animation/SkeletalMeshActor.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/PoseableMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
 #include "EngineUtils.h"
 
 // IsA's
@@ -66,146 +67,90 @@ void FSLVizEpisodeUtils::AddPoseablMeshComponentsToSkeletalActors(UWorld* World)
 	}
 }
 
-// Build the full replay episode data from the mongo compact form
-bool FSLVizEpisodeUtils::BuildEpisodeData(ASLIndividualManager* IndividualManager,
-	const TArray<TPair<float, TMap<FString, FTransform>>>& InMongoEpisodeData,
-	FSLVizEpisodeData& OutVizEpisodeData)
+// Executes a binary search for element Item in array Array using the <= operator (from ProfilerCommon::FBinaryFindIndex)
+int32 FSLVizEpisodeUtils::BinarySearchLessEqual(const TArray<float>& Array, float Value)
 {
-	double ExecBegin = FPlatformTime::Seconds();
-	/* First frame (FullFrame -  contains all the data) */
-	// Process first frame (contains all individuals -- the rest of the frames contain only individuals that have moved)
-	FSLVizEpisodeFrameData FullFrameData;
+	int32 Length = Array.Num();
+	int32 Middle = Length;
+	int32 Offset = 0;
 
-	// Iterate individuals with their poses
-	for (const auto& IndividualPosePair : InMongoEpisodeData[0].Value)
+	while (Middle > 0)
 	{
-		const FString IndividualId = IndividualPosePair.Key;
-		const FTransform IndividualPose = IndividualPosePair.Value;
-
-		if (auto Individual = IndividualManager->GetIndividual(IndividualId))
-		{
-			if (Individual->IsA(USLRigidIndividual::StaticClass())
-			|| Individual->IsA(USLSkeletalIndividual::StaticClass())
-			|| Individual->IsA(USLVirtualViewIndividual::StaticClass()))
-			{
-				FullFrameData.ActorPoses.Emplace(Individual->GetParentActor(), IndividualPose);
-			}
-			else if (auto BI = Cast<USLBoneIndividual>(Individual))
-			{
-				FullFrameData.BonePoses.FindOrAdd(BI->GetPoseableMeshComponent()).Add(BI->GetBoneIndex(), IndividualPose);
-			}
-			else if (auto VBI = Cast<USLVirtualBoneIndividual>(Individual))
-			{
-				FullFrameData.BonePoses.FindOrAdd(VBI->GetPoseableMeshComponent()).Add(VBI->GetBoneIndex(), IndividualPose);
-			}
-		}
-		else
+		Middle = Length / 2;
+		if (Array[Offset + Middle] <= Value)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not find individual with id=%s, this should not happen, aborting.."),
-				*FString(__FUNCTION__), __LINE__, *IndividualPosePair.Key);
-			return false;
+			Offset += Middle;
 		}
+		Length -= Middle;
 	}
-	// Add the timestamp
-	//OutVizEpisodeData.Timestamps[0] = InMongoEpisodeData[0].Key;
-	OutVizEpisodeData.Timestamps.Emplace(InMongoEpisodeData[0].Key);
-
-	double FirstFrameDuration = FPlatformTime::Seconds() - ExecBegin;
+	return Offset;
+}
 
-	// Add the individuals poses
-	//OutVizEpisodeData.Frames[0] = FullFrameData;
-	OutVizEpisodeData.FullFrames.Emplace(FullFrameData);
-	OutVizEpisodeData.CompactFrames.Emplace(FullFrameData);
 
-	/* Process the following frames */
-	// Update full frame with the new transform values
-	// Create compact frame holding only the changes fromt he previous frame
-	for (int32 FrameIndex = 1; FrameIndex < InMongoEpisodeData.Num(); ++FrameIndex)
+// Set the world space bone poses with a single parent-first pass directly in the bone space transforms (bone indexes sorted ascending)
+void FSLVizEpisodeUtils::SetBoneWorldPoses(UPoseableMeshComponent* PMC, const int32* BoneIndexes, const FTransform* WorldPoses, int32 Num,
+	TArray<FTransform>& ComponentSpaceBuffer)
+{
+	if (Num == 0 || PMC->SkeletalMesh == nullptr)
 	{
-		if (FrameIndex % 250 == 0) { UE_LOG(LogTemp, Log, TEXT(" processing frame %d / %d .."),  FrameIndex, InMongoEpisodeData.Num()); }
+		return;
+	}
 
-		// TODO will emplace make a copy, or one needs to make one here ?
-		//FSLVizEpisodeFrameData PrevFrameCopy = FullFrameData;
-		FSLVizEpisodeFrameData CompactFrameData;
+	// The reference skeleton stores the parents before their children, the component space 
+	// poses are computed in the same sweep, only up to the last recorded bone
+	const FReferenceSkeleton& RefSkeleton = PMC->SkeletalMesh->RefSkeleton;
+	TArray<FTransform>& BoneSpaceTransforms = PMC->BoneSpaceTransforms;
+	const int32 LastBoneIndex = FMath::Min(BoneIndexes[Num - 1], BoneSpaceTransforms.Num() - 1);
+	const FTransform& ComponentToWorld = PMC->GetComponentTransform();
+	ComponentSpaceBuffer.SetNumUninitialized(LastBoneIndex + 1, false);
 
-		// Iterate individuals with their poses
-		for (const auto& IndividualPosePair : InMongoEpisodeData[FrameIndex].Value)
+	int32 PoseIdx = 0;
+	for (int32 BoneIndex = 0; BoneIndex <= LastBoneIndex; ++BoneIndex)
+	{
+		const int32 ParentIndex = RefSkeleton.GetParentIndex(BoneIndex);
+		if (PoseIdx < Num && BoneIndexes[PoseIdx] == BoneIndex)
 		{
-			const FString IndividualId = IndividualPosePair.Key;
-			const FTransform IndividualPose = IndividualPosePair.Value;
-			if (auto Individual = IndividualManager->GetIndividual(IndividualId))
-			{
-				if (Individual->IsA(USLRigidIndividual::StaticClass())
-					|| Individual->IsA(USLSkeletalIndividual::StaticClass())
-					|| Individual->IsA(USLVirtualViewIndividual::StaticClass()))
-				{
-					// Update the full frame with the new value
-					//if (auto FoundActorPose = FullFrameData.ActorPoses.Find(RI->GetParentActor())){(*FoundActorPose) = IndividualPose;}
-					FullFrameData.ActorPoses.FindChecked(Individual->GetParentActor()) = IndividualPose;
-					// Add as new data to the compact frame
-					CompactFrameData.ActorPoses.Emplace(Individual->GetParentActor(), IndividualPose);
-
-					if (IndividualId.Equals("6HI1inL7OUKmqNXGXI81YA"))
-					{
-						UE_LOG(LogTemp, Log, TEXT("%s::%d Pose=%s;"), *FString(__FUNCTION__), __LINE__, *IndividualPose.ToString());
-					}
-				}
-				else if (auto BI = Cast<USLBoneIndividual>(Individual))
-				{
-					FullFrameData.BonePoses.FindOrAdd(BI->GetPoseableMeshComponent()).Add(BI->GetBoneIndex(), IndividualPose);
-					CompactFrameData.BonePoses.FindOrAdd(BI->GetPoseableMeshComponent()).Add(BI->GetBoneIndex(), IndividualPose);
-				}
-				else if (auto VBI = Cast<USLVirtualBoneIndividual>(Individual))
-				{
-					FullFrameData.BonePoses.FindOrAdd(VBI->GetPoseableMeshComponent()).Add(VBI->GetBoneIndex(), IndividualPose);
-					CompactFrameData.BonePoses.FindOrAdd(VBI->GetPoseableMeshComponent()).Add(VBI->GetBoneIndex(), IndividualPose);
-				}
-			}
-			else
-			{
-				UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not find individual with id=%s, this should not happen, aborting.."),
-					*FString(__FUNCTION__), __LINE__, *IndividualId);
-				return false;
-			}
+			// Recorded bone, world -> component -> parent bone space
+			ComponentSpaceBuffer[BoneIndex] = WorldPoses[PoseIdx].GetRelativeTransform(ComponentToWorld);
+			BoneSpaceTransforms[BoneIndex] = ParentIndex == INDEX_NONE ? ComponentSpaceBuffer[BoneIndex]
+				: ComponentSpaceBuffer[BoneIndex].GetRelativeTransform(ComponentSpaceBuffer[ParentIndex]);
+			PoseIdx++;
+		}
+		else
+		{
+			// Not recorded, keeps its local pose and follows its parent
+			ComponentSpaceBuffer[BoneIndex] = ParentIndex == INDEX_NONE ? BoneSpaceTransforms[BoneIndex]
+				: BoneSpaceTransforms[BoneIndex] * ComponentSpaceBuffer[ParentIndex];
 		}
-
-		// Add the timestamp
-		//OutVizEpisodeData.Timestamps[FrameIndex] = InMongoEpisodeData[FrameIndex].Key;
-		OutVizEpisodeData.Timestamps.Emplace(InMongoEpisodeData[FrameIndex].Key);
-
-		// Add the individuals poses
-		//OutFullEpisodeData.Frames[FrameIndex] = FullFrameData;
-		OutVizEpisodeData.FullFrames.Emplace(FullFrameData);
-		OutVizEpisodeData.CompactFrames.Emplace(CompactFrameData);
 	}
-	
-	double FollowingFramesDuration = FPlatformTime::Seconds() - ExecBegin - FirstFrameDuration;
-	UE_LOG(LogTemp, Log, TEXT("%s::%d Durations: first frame=[%f], following frames(num=%d)=[%f], total=[%f] seconds..;"),
-		*FString(__func__), __LINE__, FirstFrameDuration, OutVizEpisodeData.Timestamps.Num(),
-		FollowingFramesDuration, FPlatformTime::Seconds() - ExecBegin);
-	return true;
+	PMC->MarkRefreshTransformDirty();
 }
 
-
-// Executes a binary search for element Item in array Array using the <= operator (from ProfilerCommon::FBinaryFindIndex)
-int32 FSLVizEpisodeUtils::BinarySearchLessEqual(const TArray<float>& Array, float Value)
+// Set the world space bone poses (bone index to pose) with a single parent-first pass
+void FSLVizEpisodeUtils::SetBoneWorldPoses(UPoseableMeshComponent* PMC, const TMap<int32, FTransform>& BonePoses)
 {
-	int32 Length = Array.Num();
-	int32 Middle = Length;
-	int32 Offset = 0;
+	TArray<int32> BoneIndexes;
+	BonePoses.GenerateKeyArray(BoneIndexes);
+	BoneIndexes.Sort();
 
-	while (Middle > 0)
+	TArray<FTransform> WorldPoses;
+	WorldPoses.Reserve(BoneIndexes.Num());
+	for (const int32 BoneIndex : BoneIndexes)
 	{
-		Middle = Length / 2;
-		if (Array[Offset + Middle] <= Value)
-		{
-			Offset += Middle;
-		}
-		Length -= Middle;
+		WorldPoses.Add(BonePoses[BoneIndex]);
 	}
-	return Offset;
+
+	TArray<FTransform> ComponentSpaceBuffer;
+	SetBoneWorldPoses(PMC, BoneIndexes.GetData(), WorldPoses.GetData(), BoneIndexes.Num(), ComponentSpaceBuffer);
 }
 
+// Interpolate between the two poses (lerp for location and scale, slerp for rotation)
+FTransform FSLVizEpisodeUtils::InterpolatePoses(const FTransform& A, const FTransform& B, float Alpha)
+{
+	return FTransform(FQuat::Slerp(A.GetRotation(), B.GetRotation(), Alpha),
+		FMath::Lerp(A.GetLocation(), B.GetLocation(), Alpha),
+		FMath::Lerp(A.GetScale3D(), B.GetScale3D(), Alpha));
+}
 
 // Check if actor requires any special attention when switching to visual only world (return true if the components should be left alone)
 bool FSLVizEpisodeUtils::IsSpecialCaseActor(AActor* Actor)
@@ -234,7 +179,125 @@ bool FSLVizEpisodeUtils::IsSpecialCaseActor(AActor* Actor)
 	return false;
 }
 
-/* Private helpers */
+// Create the actor and bone slots of the episode individuals (the bone slots are grouped by component)
+bool FSLVizEpisodeUtils::BuildEpisodeBindings(ASLIndividualManager* IndividualManager, const TArray<FString>& Ids,
+	FSLVizEpisodeBindings& OutBindings, TArray<int32>& OutIdxToActorSlot, TArray<int32>& OutIdxToBoneSlot)
+{
+	OutBindings.Empty();
+	OutIdxToActorSlot.Init(INDEX_NONE, Ids.Num());
+	OutIdxToBoneSlot.Init(INDEX_NONE, Ids.Num());
+	TMap<AActor*, int32> ActorToSlot;
+	TMap<UPoseableMeshComponent*, TArray<int32>> ComponentBoneIndexes;
+	TMap<int32, TPair<UPoseableMeshComponent*, int32>> IdxToBone;
+	int32 NumStaticMobilityActors = 0;
+
+	// The ids are in the order of their first appearance in the episode
+	for (int32 Idx = 0; Idx < Ids.Num(); ++Idx)
+	{
+		AActor* Actor = nullptr;
+		UPoseableMeshComponent* PMC = nullptr;
+		int32 BoneIndex = INDEX_NONE;
+		if (!ResolveIndividual(IndividualManager, Ids[Idx], Actor, PMC, BoneIndex))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d Could not find individual with id=%s, this should not happen, aborting.."),
+				*FString(__FUNCTION__), __LINE__, *Ids[Idx]);
+			return false;
+		}
+
+		if (Actor && IsStaticMobilityActor(Actor))
+		{
+			// Not moved by the replay, would break the static lighting
+			NumStaticMobilityActors++;
+		}
+		else if (Actor)
+		{
+			if (const int32* FoundSlot = ActorToSlot.Find(Actor))
+			{
+				OutIdxToActorSlot[Idx] = *FoundSlot;
+			}
+			else
+			{
+				OutIdxToActorSlot[Idx] = OutBindings.Actors.Add(Actor);
+				OutBindings.ActorIds.Add(Ids[Idx]);
+				ActorToSlot.Add(Actor, OutIdxToActorSlot[Idx]);
+			}
+		}
+		else if (PMC)
+		{
+			ComponentBoneIndexes.FindOrAdd(PMC).AddUnique(BoneIndex);
+			IdxToBone.Add(Idx, TPair<UPoseableMeshComponent*, int32>(PMC, BoneIndex));
+		}
+		// else individual types without a replayable pose
+	}
+
+	// Flatten the bones, every component gets a contiguous range of slots sorted by the bone index
+	TMap<UPoseableMeshComponent*, TMap<int32, int32>> ComponentBoneIndexToSlot;
+	OutBindings.ComponentBoneOffsets.Add(0);
+	for (auto& PMCBoneIndexesPair : ComponentBoneIndexes)
+	{
+		UPoseableMeshComponent* PMC = PMCBoneIndexesPair.Key;
+		const int32 CompIdx = OutBindings.SkeletalComponents.Add(PMC);
+		TMap<int32, int32>& BoneIndexToSlot = ComponentBoneIndexToSlot.Add(PMC);
+		PMCBoneIndexesPair.Value.Sort();
+		for (const int32 BoneIndex : PMCBoneIndexesPair.Value)
+		{
+			BoneIndexToSlot.Add(BoneIndex, OutBindings.BoneIndexes.Add(BoneIndex));
+			OutBindings.BoneComponents.Add(CompIdx);
+		}
+		OutBindings.ComponentBoneOffsets.Add(OutBindings.BoneIndexes.Num());
+	}
+	OutBindings.BoneIds.SetNum(OutBindings.NumBones());
+	for (const auto& IdxBonePair : IdxToBone)
+	{
+		const int32 BoneSlot = ComponentBoneIndexToSlot[IdxBonePair.Value.Key][IdxBonePair.Value.Value];
+		OutIdxToBoneSlot[IdxBonePair.Key] = BoneSlot;
+		OutBindings.BoneIds[BoneSlot] = Ids[IdxBonePair.Key];
+	}
+
+	if (NumStaticMobilityActors > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %d static mobility actors are not part of the replay.."),
+			*FString(__FUNCTION__), __LINE__, NumStaticMobilityActors);
+	}
+	return true;
+}
+
+// True if the actor has static mobility (its pose is never applied by the replay)
+bool FSLVizEpisodeUtils::IsStaticMobilityActor(AActor* Actor)
+{
+	return Actor->GetRootComponent() == nullptr || Actor->GetRootComponent()->Mobility == EComponentMobility::Static;
+}
+
+// Resolve the individual to the actor or the (poseable mesh, bone index) its poses are applied to (false if not found)
+bool FSLVizEpisodeUtils::ResolveIndividual(ASLIndividualManager* IndividualManager, const FString& Id,
+	AActor*& OutActor, UPoseableMeshComponent*& OutPMC, int32& OutBoneIndex)
+{
+	OutActor = nullptr;
+	OutPMC = nullptr;
+	OutBoneIndex = INDEX_NONE;
+	if (auto Individual = IndividualManager->GetIndividual(Id))
+	{
+		if (Individual->IsA(USLRigidIndividual::StaticClass())
+			|| Individual->IsA(USLSkeletalIndividual::StaticClass())
+			|| Individual->IsA(USLVirtualViewIndividual::StaticClass()))
+		{
+			OutActor = Individual->GetParentActor();
+		}
+		else if (auto BI = Cast<USLBoneIndividual>(Individual))
+		{
+			OutPMC = BI->GetPoseableMeshComponent();
+			OutBoneIndex = BI->GetBoneIndex();
+		}
+		else if (auto VBI = Cast<USLVirtualBoneIndividual>(Individual))
+		{
+			OutPMC = VBI->GetPoseableMeshComponent();
+			OutBoneIndex = VBI->GetBoneIndex();
+		}
+		return true;
+	}
+	return false;
+}
+
 // Remove actor components that are not required in the 'visual only' world (e.g. controllers)
 void FSLVizEpisodeUtils::RemoveUnnecessaryComponents(AActor* Actor)
 {
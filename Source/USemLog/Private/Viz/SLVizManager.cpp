@@ -7,6 +7,8 @@
 #include "Viz/SLVizHighlightManager.h"
 //#include "Viz/SLVizEpisodeManager.h"
 #include "Viz/SLVizEpisodeUtils.h"
+#include "Viz/SLVizEpisodeCacheFile.h"
+#include "Viz/SLVizEpisodeCompiler.h"
 #include "Viz/SLVizCameraDirector.h"
 #include "Individuals/SLIndividualManager.h"
 
@@ -29,7 +31,9 @@
 ASLVizManager::ASLVizManager()
 {
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.bTickEvenWhenPaused = true;
 	bIsInit = false;
 
 	IndividualManager = nullptr;
@@ -59,6 +63,13 @@ void ASLVizManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	Reset();
 }
 
+// Called every frame, only enabled while episodes are compiled in the background
+void ASLVizManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	CollectCompiledEpisodes();
+}
+
 // Load all the required managers
 void ASLVizManager::Init()
 {
@@ -121,6 +132,7 @@ void ASLVizManager::Reset()
 	MarkerManager = nullptr;
 	EpisodeManager = nullptr;
 	bIsInit = false;
+	CancelAllEpisodeCompilations();
 	CachedEpisodeData.Empty();
 }
 
@@ -765,6 +777,63 @@ bool ASLVizManager::CreateBoneMeshMarkerTimeline(const FString& MarkerId, const
 	return false;
 }
 
+/* Skeletal bones as primitive markers */
+// Create a lightweight marker of the skeletal poses, the bones are drawn as instanced primitives
+bool ASLVizManager::CreateSkeletalBonesMarker(const FString& MarkerId,
+	const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+	ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+	const FLinearColor& Color, ESLVizMaterialType MaterialType)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+
+	if (Markers.Contains(MarkerId))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s marker (Id=%s) already exists.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *MarkerId);
+		return false;
+	}
+
+	if (auto Marker = MarkerManager->CreateSkeletalBonesPrimitiveMarker(SkeletalPoses, PrimitiveType, Size, Color, MaterialType))
+	{
+		Markers.Add(MarkerId, Marker);
+		return true;
+	}
+	return false;
+}
+
+// Create a lightweight timeline marker of the skeletal poses, the bones are drawn as instanced primitives
+bool ASLVizManager::CreateSkeletalBonesMarkerTimeline(const FString& MarkerId,
+	const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+	ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+	const FLinearColor& Color, ESLVizMaterialType MaterialType,
+	const FSLVizTimelineParams& TimelineParams)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+
+	if (Markers.Contains(MarkerId))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s marker (Id=%s) already exists.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *MarkerId);
+		return false;
+	}
+
+	if (auto Marker = MarkerManager->CreateSkeletalBonesPrimitiveMarkerTimeline(SkeletalPoses, PrimitiveType, Size,
+		Color, MaterialType, TimelineParams))
+	{
+		Markers.Add(MarkerId, Marker);
+		return true;
+	}
+	return false;
+}
+
 
 // Remove marker with the given id
 bool ASLVizManager::RemoveMarker(const FString& Id)
@@ -880,12 +949,22 @@ bool ASLVizManager::CacheEpisodeData(const FString& Id, const TArray<TPair<float
 		return true;
 	}
 
-	// Create and reserve episode data with the array size
-	FSLVizEpisodeData VizEpisodeData(InMongoEpisodeData.Num());
-	VizEpisodeData.Id = Id;
-	if (FSLVizEpisodeUtils::BuildEpisodeData(IndividualManager, InMongoEpisodeData, VizEpisodeData))
+	// Compile the episode data on the game thread
+	FSLMongoEpisodeFrames MongoEpisodeFrames;
+	MongoEpisodeFrames.Append(InMongoEpisodeData);
+	FSLVizEpisodeCompiler Compiler(FString(), Id);
+	FSLVizEpisodeDataPtr VizEpisodeData;
+	if (Compiler.Prepare(IndividualManager, MoveTemp(MongoEpisodeFrames)) && Compiler.Run())
 	{
+		VizEpisodeData = Compiler.GetResult();
+	}
+	if (VizEpisodeData.IsValid())
+	{
+		const SIZE_T NumBytes = VizEpisodeData->GetAllocatedSize();
 		CachedEpisodeData.Add(Id, VizEpisodeData);
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %s cached episode %s: frames=%d; keyframes=%d; mb=%.2f (total=%.2f, episodes=%d);"),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *Id, VizEpisodeData->NumFrames(), VizEpisodeData->NumKeyframes(),
+			NumBytes / (1024.0 * 1024.0), GetCachedEpisodesAllocatedSize() / (1024.0 * 1024.0), CachedEpisodeData.Num());
 		return true;
 	}
 	else
@@ -895,6 +974,165 @@ bool ASLVizManager::CacheEpisodeData(const FString& Id, const TArray<TPair<float
 	}
 }
 
+// Compile the episode frames on the thread pool, the episode is cached (and written to its cache file) when done
+bool ASLVizManager::CacheEpisodeDataAsync(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature,
+	FSLMongoEpisodeFrames&& InMongoEpisodeFrames)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+	if (IsEpisodeCached(EpisodeId) || IsEpisodeCompiling(EpisodeId))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s the episode %s is already cached or compiling.."), *FString(__FUNCTION__), __LINE__, *GetName(), *EpisodeId);
+		return true;
+	}
+
+	// The ids are resolved to the world individuals here, the frames are compiled on the thread pool
+	TSharedPtr<FSLVizEpisodeCompiler> Compiler = MakeShareable(new FSLVizEpisodeCompiler(TaskId, EpisodeId, ContentSignature));
+	if (!Compiler->Prepare(IndividualManager, MoveTemp(InMongoEpisodeFrames)) || !Compiler->StartAsync())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s could not start compiling episode %s.."), *FString(__FUNCTION__), __LINE__, *GetName(), *EpisodeId);
+		return false;
+	}
+	EpisodeCompilers.Add(EpisodeId, Compiler);
+
+	// Check for the finished compilations
+	SetActorTickInterval(EpisodeCompileCheckInterval);
+	SetActorTickEnabled(true);
+	return true;
+}
+
+// Progress [0, 1] of the background episode compilation (false if the episode is not compiling)
+bool ASLVizManager::GetEpisodeCompileProgress(const FString& Id, float& OutProgress) const
+{
+	if (const TSharedPtr<FSLVizEpisodeCompiler>* Compiler = EpisodeCompilers.Find(Id))
+	{
+		OutProgress = (*Compiler)->GetProgress();
+		return true;
+	}
+	return false;
+}
+
+// Stop the background episode compilation (false if the episode is not compiling)
+bool ASLVizManager::CancelEpisodeCompilation(const FString& Id)
+{
+	TSharedPtr<FSLVizEpisodeCompiler> Compiler;
+	if (EpisodeCompilers.RemoveAndCopyValue(Id, Compiler))
+	{
+		// The compiler waits for its worker when released
+		Compiler->Cancel();
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %s cancelled compiling episode %s at %.1f%%.."),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *Id, Compiler->GetProgress() * 100.f);
+		if (EpisodeCompilers.Num() == 0)
+		{
+			SetActorTickEnabled(false);
+		}
+		return true;
+	}
+	return false;
+}
+
+// Cancel all background episode compilations
+void ASLVizManager::CancelAllEpisodeCompilations()
+{
+	for (auto& IdCompilerPair : EpisodeCompilers)
+	{
+		IdCompilerPair.Value->Cancel();
+	}
+	EpisodeCompilers.Empty();
+	SetActorTickEnabled(false);
+}
+
+// Move the finished background compilations to the cached episodes
+void ASLVizManager::CollectCompiledEpisodes()
+{
+	for (auto CompilerItr = EpisodeCompilers.CreateIterator(); CompilerItr; ++CompilerItr)
+	{
+		TSharedPtr<FSLVizEpisodeCompiler> Compiler = CompilerItr->Value;
+		if (!Compiler->IsDone())
+		{
+			continue;
+		}
+		CompilerItr.RemoveCurrent();
+
+		FSLVizEpisodeDataPtr VizEpisodeData = Compiler->GetResult();
+		if (!VizEpisodeData.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s::%d %s could not compile episode %s.."),
+				*FString(__FUNCTION__), __LINE__, *GetName(), *Compiler->GetEpisodeId());
+			continue;
+		}
+		CachedEpisodeData.Add(Compiler->GetEpisodeId(), VizEpisodeData);
+		UE_LOG(LogTemp, Log, TEXT("%s::%d %s cached episode %s: frames=%d; keyframes=%d; mb=%.2f (total=%.2f, episodes=%d);"),
+			*FString(__FUNCTION__), __LINE__, *GetName(), *Compiler->GetEpisodeId(), VizEpisodeData->NumFrames(), VizEpisodeData->NumKeyframes(),
+			VizEpisodeData->GetAllocatedSize() / (1024.0 * 1024.0), GetCachedEpisodesAllocatedSize() / (1024.0 * 1024.0), CachedEpisodeData.Num());
+
+		if (!Compiler->GetContentSignature().IsEmpty())
+		{
+			SaveEpisodeCacheFile(Compiler->GetTaskId(), Compiler->GetEpisodeId(), Compiler->GetContentSignature());
+		}
+	}
+
+	if (EpisodeCompilers.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+// Memory used by the cached episodes
+SIZE_T ASLVizManager::GetCachedEpisodesAllocatedSize() const
+{
+	SIZE_T NumBytes = CachedEpisodeData.GetAllocatedSize();
+	for (const auto& IdEpisodePair : CachedEpisodeData)
+	{
+		NumBytes += IdEpisodePair.Key.GetAllocatedSize() + IdEpisodePair.Value->GetAllocatedSize();
+	}
+	return NumBytes;
+}
+
+// Load the episode from its cache file into the cached episodes (false if missing, outdated or not matching the world)
+bool ASLVizManager::LoadEpisodeCacheFile(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return false;
+	}
+	if (!bUseEpisodeCacheFiles)
+	{
+		return false;
+	}
+	if (IsEpisodeCached(EpisodeId))
+	{
+		return true;
+	}
+
+	TSharedRef<FSLVizEpisodeData, ESPMode::ThreadSafe> VizEpisodeData = MakeShared<FSLVizEpisodeData, ESPMode::ThreadSafe>();
+	if (!FSLVizEpisodeCacheFile::Load(IndividualManager, TaskId, EpisodeId, ContentSignature, *VizEpisodeData))
+	{
+		return false;
+	}
+	CachedEpisodeData.Add(EpisodeId, VizEpisodeData);
+	return true;
+}
+
+// Write the cached episode to its cache file, loaded in the following sessions as long as the content signature matches
+bool ASLVizManager::SaveEpisodeCacheFile(const FString& TaskId, const FString& EpisodeId, const FString& ContentSignature) const
+{
+	if (!bUseEpisodeCacheFiles)
+	{
+		return false;
+	}
+	if (const FSLVizEpisodeDataPtr* VizEpisodeData = CachedEpisodeData.Find(EpisodeId))
+	{
+		return FSLVizEpisodeCacheFile::Save(TaskId, EpisodeId, ContentSignature, **VizEpisodeData);
+	}
+	UE_LOG(LogTemp, Warning, TEXT("%s::%d %s the episode (%s) data is not cached.."), *FString(__FUNCTION__), __LINE__, *GetName(), *EpisodeId);
+	return false;
+}
+
 // Load cached episode data
 bool ASLVizManager::LoadCachedEpisodeData(const FString& Id)
 {
@@ -981,10 +1219,12 @@ void ASLVizManager::LoadEpisodeData(const TArray<TPair<float, TMap<FString, FTra
 
 
 	// Create and reserve episode data with the array size
-	FSLVizEpisodeData VizEpisodeData(InMongoEpisodeData.Num());
-	if (FSLVizEpisodeUtils::BuildEpisodeData(IndividualManager, InMongoEpisodeData, VizEpisodeData))
+	FSLMongoEpisodeFrames MongoEpisodeFrames;
+	MongoEpisodeFrames.Append(InMongoEpisodeData);
+	FSLVizEpisodeCompiler Compiler(FString(), FString());
+	if (Compiler.Prepare(IndividualManager, MoveTemp(MongoEpisodeFrames)) && Compiler.Run())
 	{
-		EpisodeManager->LoadEpisode(VizEpisodeData);
+		EpisodeManager->LoadEpisode(Compiler.GetResult());
 	}
 }
 
@@ -1063,6 +1303,17 @@ void ASLVizManager::StopReplay()
 	EpisodeManager->StopReplay();
 }
 
+// Compare the single pass bone pose application with the previous by-name one on the current frame of the loaded episode
+void ASLVizManager::BenchmarkBonePoses(int32 NumIterations)
+{
+	if (!bIsInit)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d %s is not initialized, call init first.."), *FString(__FUNCTION__), __LINE__, *GetName());
+		return;
+	}
+	EpisodeManager->BenchmarkBonePoses(NumIterations);
+}
+
 // Move the view to a given position
 void ASLVizManager::SetCameraView(const FTransform& Pose)
 {
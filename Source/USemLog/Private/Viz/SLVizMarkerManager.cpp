@@ -243,3 +243,53 @@ USLVizSkeletalMeshMarker* ASLVizMarkerManager::CreateSkeletalBoneMarker(const TA
 	return nullptr;
 }
 
+// Create a lightweight skeletal marker, every bone pose is drawn as an instanced primitive
+USLVizPrimitiveMarker* ASLVizMarkerManager::CreateSkeletalBonesPrimitiveMarker(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+	ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+	const FLinearColor& InColor, ESLVizMaterialType MaterialType)
+{
+	TArray<FTransform> BonePoses;
+	GetSkeletalBonePoses(SkeletalPoses, BonePoses);
+	return CreatePrimitiveMarker(BonePoses, PrimitiveType, Size, InColor, MaterialType);
+}
+
+// Create a lightweight skeletal timeline marker, every bone pose is drawn as an instanced primitive
+USLVizPrimitiveMarker* ASLVizMarkerManager::CreateSkeletalBonesPrimitiveMarkerTimeline(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+	ESLVizPrimitiveMarkerType PrimitiveType, float Size,
+	const FLinearColor& InColor, ESLVizMaterialType MaterialType,
+	const FSLVizTimelineParams& TimelineParams)
+{
+	TArray<FTransform> BonePoses;
+	const int32 NumBonesPerPose = GetSkeletalBonePoses(SkeletalPoses, BonePoses);
+
+	// The max number of instances is given in skeletal poses
+	FSLVizTimelineParams BonesTimelineParams = TimelineParams;
+	if (BonesTimelineParams.MaxNumInstances > 0)
+	{
+		BonesTimelineParams.MaxNumInstances *= FMath::Max(NumBonesPerPose, 1);
+	}
+	return CreatePrimitiveMarkerTimeline(BonePoses, PrimitiveType, Size, InColor, MaterialType, BonesTimelineParams);
+}
+
+// Flatten the bone poses of the skeletal poses, returns the max number of bones of a pose
+int32 ASLVizMarkerManager::GetSkeletalBonePoses(const TArray<TPair<FTransform, TMap<int32, FTransform>>>& SkeletalPoses,
+	TArray<FTransform>& OutBonePoses)
+{
+	int32 NumBonesPerPose = 0;
+	int32 NumBonePoses = 0;
+	for (const auto& SkeletalPose : SkeletalPoses)
+	{
+		NumBonePoses += SkeletalPose.Value.Num();
+		NumBonesPerPose = FMath::Max(NumBonesPerPose, SkeletalPose.Value.Num());
+	}
+	OutBonePoses.Reserve(NumBonePoses);
+	for (const auto& SkeletalPose : SkeletalPoses)
+	{
+		for (const auto& BonePosePair : SkeletalPose.Value)
+		{
+			OutBonePoses.Add(BonePosePair.Value);
+		}
+	}
+	return NumBonesPerPose;
+}
+
@@ -6,6 +6,34 @@
 #include "Mongo/SLMongoQueryManager.h"
 #include "Viz/SLVizManager.h"
 
+#if WITH_EDITOR
+// Called when a property is changed in the editor
+void USLVizQCacheEpisodes::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Get the changed property name
+	FName PropertyName = (PropertyChangedEvent.Property != NULL) ?
+		PropertyChangedEvent.Property->GetFName() : NAME_None;
+
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(USLVizQCacheEpisodes, bProgressButton))
+	{
+		bProgressButton = false;
+		if (IsReadyForManualExecution())
+		{
+			LogCompileProgress(KnowrobManager.Get());
+		}
+	}
+	else if (PropertyName == GET_MEMBER_NAME_CHECKED(USLVizQCacheEpisodes, bCancelButton))
+	{
+		bCancelButton = false;
+		if (IsReadyForManualExecution())
+		{
+			CancelCompilation(KnowrobManager.Get());
+		}
+	}
+}
+#endif // WITH_EDITOR
 
 // Virtual implementation of the execute function
 void USLVizQCacheEpisodes::ExecuteImpl(ASLKnowrobManager* KRManager)
@@ -15,17 +43,69 @@ void USLVizQCacheEpisodes::ExecuteImpl(ASLKnowrobManager* KRManager)
 
 	for (const auto Episode : Episodes)
 	{
-		if (!VizManager->IsEpisodeCached(Episode))
+		if (!VizManager->IsEpisodeCached(Episode) && !VizManager->IsEpisodeCompiling(Episode))
 		{
+			// Load the compiled episode from disk if it was not re-written since
+			const FString Signature = MongoQueryManager->GetEpisodeSignature(Task, Episode);
+			if (VizManager->LoadEpisodeCacheFile(Task, Episode, Signature))
+			{
+				continue;
+			}
+
 			UE_LOG(LogTemp, Log, TEXT("%s::%d Collecting episode %s::%s .."),
 				*FString(__FUNCTION__), __LINE__, *Task, *Episode);
 
+			if (bCompileInBackground)
+			{
+				// Only the database query and the id resolving block, the frames are compiled on the thread pool
+				FSLMongoEpisodeFrames EpisodeFrames;
+				if (!MongoQueryManager->GetEpisodeFrames(Task, Episode, EpisodeFrames)
+					|| !VizManager->CacheEpisodeDataAsync(Task, Episode, Signature, MoveTemp(EpisodeFrames)))
+				{
+					UE_LOG(LogTemp, Error, TEXT("%s::%d Could not start compiling episode %s::%s, execution aborted .."),
+						*FString(__FUNCTION__), __LINE__, *Task, *Episode);
+				}
+				continue;
+			}
+
 			auto EpisodeData = MongoQueryManager->GetEpisodeData(Task, Episode);
 			if (!VizManager->CacheEpisodeData(Episode, EpisodeData))
 			{
 				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not cache episode %s::%s, execution aborted .."),
 					*FString(__FUNCTION__), __LINE__, *Task, *Episode);
+				continue;
 			}
+			VizManager->SaveEpisodeCacheFile(Task, Episode, Signature);
 		}
 	}
 }
+
+// Log the progress of the episodes compiled in the background
+void USLVizQCacheEpisodes::LogCompileProgress(ASLKnowrobManager* KRManager) const
+{
+	ASLVizManager* VizManager = KRManager->GetVizManager();
+	for (const auto Episode : Episodes)
+	{
+		float Progress = 0.f;
+		if (VizManager->GetEpisodeCompileProgress(Episode, Progress))
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s::%s is compiling (%.1f%%) .."),
+				*FString(__FUNCTION__), __LINE__, *Task, *Episode, Progress * 100.f);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Episode %s::%s is %s .."),
+				*FString(__FUNCTION__), __LINE__, *Task, *Episode, VizManager->IsEpisodeCached(Episode) ? TEXT("cached") : TEXT("not cached"));
+		}
+	}
+}
+
+// Cancel the background compilation of the episodes
+void USLVizQCacheEpisodes::CancelCompilation(ASLKnowrobManager* KRManager) const
+{
+	ASLVizManager* VizManager = KRManager->GetVizManager();
+	for (const auto Episode : Episodes)
+	{
+		VizManager->CancelEpisodeCompilation(Episode);
+	}
+}
@@ -116,7 +116,7 @@ void USLVizQMarker::ExecuteImpl(ASLKnowrobManager* KRManager)
 	ASLMongoQueryManager* MongoQueryManager = KRManager->GetMongoQueryManager();
 
 	/* Skeletal */
-	if (MeshType == ESLVizQMarkerMeshType::SkeletalMesh)
+	if (MeshType == ESLVizQMarkerMeshType::SkeletalMesh || MeshType == ESLVizQMarkerMeshType::SkeletalBones)
 	{
 		// Pose/trajectory data
 		TArray<TPair<FTransform, TMap<int32, FTransform>>> SkeletalPoses;
@@ -144,8 +144,23 @@ void USLVizQMarker::ExecuteImpl(ASLKnowrobManager* KRManager)
 			return;
 		}
 
+		// Draw the bones only as instanced primitives
+		if (MeshType == ESLVizQMarkerMeshType::SkeletalBones)
+		{
+			if (Type != ESLVizQMarkerType::Timeline)
+			{
+				VizManager->CreateSkeletalBonesMarker(MarkerId, SkeletalPoses, PrimitiveType, Size,
+					Color, MaterialType);
+			}
+			else
+			{
+				VizManager->CreateSkeletalBonesMarkerTimeline(MarkerId, SkeletalPoses, PrimitiveType, Size,
+					Color, MaterialType,
+					TimelineParams);
+			}
+		}
 		// Draw marker as static or timeline
-		if (Type != ESLVizQMarkerType::Timeline)
+		else if (Type != ESLVizQMarkerType::Timeline)
 		{
 			if (bUseOriginalColor)
 			{
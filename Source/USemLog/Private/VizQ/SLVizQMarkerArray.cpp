@@ -178,7 +178,7 @@ void USLVizQMarkerArray::ExecuteImpl(ASLKnowrobManager* KRManager)
 		ViewIdx++;
 
 		/* Skeletal */
-		if (MeshType == ESLVizQMarkerArrayMeshType::SkeletalMesh)
+		if (MeshType == ESLVizQMarkerArrayMeshType::SkeletalMesh || MeshType == ESLVizQMarkerArrayMeshType::SkeletalBones)
 		{
 			// Pose/trajectory data
 			TArray<TPair<FTransform, TMap<int32, FTransform>>> SkeletalPoses;
@@ -206,8 +206,23 @@ void USLVizQMarkerArray::ExecuteImpl(ASLKnowrobManager* KRManager)
 				return;
 			}
 
+			// Draw the bones only as instanced primitives
+			if (MeshType == ESLVizQMarkerArrayMeshType::SkeletalBones)
+			{
+				if (Type != ESLVizQMarkerArrayType::Timeline)
+				{
+					VizManager->CreateSkeletalBonesMarker(MarkerId, SkeletalPoses, PrimitiveType, Size,
+						Color, MaterialType);
+				}
+				else
+				{
+					VizManager->CreateSkeletalBonesMarkerTimeline(MarkerId, SkeletalPoses, PrimitiveType, Size,
+						Color, MaterialType,
+						TimelineParams);
+				}
+			}
 			// Draw marker as static or timeline
-			if (Type != ESLVizQMarkerArrayType::Timeline)
+			else if (Type != ESLVizQMarkerArrayType::Timeline)
 			{
 				if (bUseOriginalColor)
 				{
@@ -50,17 +50,32 @@ void USLVizQReplay::ExecuteImpl(ASLKnowrobManager* KRManager)
 	ASLVizManager* VizManager = KRManager->GetVizManager();
 	ASLMongoQueryManager* MongoQueryManager = KRManager->GetMongoQueryManager();
 
+	// The episode is still being compiled in the background
+	float CompileProgress = 0.f;
+	if (VizManager->GetEpisodeCompileProgress(Episode, CompileProgress))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s::%d Episode %s::%s is still compiling (%.1f%%), execution aborted .."),
+			*FString(__FUNCTION__), __LINE__, *Task, *Episode, CompileProgress * 100.f);
+		return;
+	}
+
 	// Retrieve and cache episode
 	if (!VizManager->IsEpisodeCached(Episode))
 	{
-		UE_LOG(LogTemp, Log, TEXT("%s::%d Collecting episode %s::%s .."),
-			*FString(__FUNCTION__), __LINE__, *Task, *Episode);
-		auto EpisodeData = MongoQueryManager->GetEpisodeData(Task, Episode);
-		if (!VizManager->CacheEpisodeData(Episode, EpisodeData))
+		// Load the compiled episode from disk if it was not re-written since
+		const FString Signature = MongoQueryManager->GetEpisodeSignature(Task, Episode);
+		if (!VizManager->LoadEpisodeCacheFile(Task, Episode, Signature))
 		{
-			UE_LOG(LogTemp, Error, TEXT("%s::%d Could not cache episode %s::%s, execution aborted .."),
+			UE_LOG(LogTemp, Log, TEXT("%s::%d Collecting episode %s::%s .."),
 				*FString(__FUNCTION__), __LINE__, *Task, *Episode);
-			return;
+			auto EpisodeData = MongoQueryManager->GetEpisodeData(Task, Episode);
+			if (!VizManager->CacheEpisodeData(Episode, EpisodeData))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s::%d Could not cache episode %s::%s, execution aborted .."),
+					*FString(__FUNCTION__), __LINE__, *Task, *Episode);
+				return;
+			}
+			VizManager->SaveEpisodeCacheFile(Task, Episode, Signature);
 		}
 	}
 